@@ -0,0 +1,298 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	BenchmarkBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the BenchmarkState and BenchmarkBS
+*					Classes
+*
+* References	:	- Google Benchmark, https://github.com/google/benchmark
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+#include "BenchmarkBS.h"
+
+// Iterations are never grown past this count
+static const long long maxIterations = 1000000000LL;
+
+// Process CPU seconds, summed over every thread on POSIX (wall time on Windows)
+static double cpuSeconds() {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// Minimal JSON string escaping for names and context values
+static string jsonString(const string& text) {
+    string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        if ((unsigned char)c < 0x20) quoted += ' ';
+        else quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Parametrized constructor
+BenchmarkState::BenchmarkState(const vector<long long>& args, long long iterations) :
+    m_args(args), m_iterations(iterations), m_remaining(iterations), m_running(false), m_cpuStart(0),
+    m_realSeconds(0), m_cpuSeconds(0), m_items(0), m_bytes(0) {
+}
+
+long long BenchmarkState::range(size_t index) const { return index < m_args.size() ? m_args[index] : 0; }
+long long BenchmarkState::getIterations() const { return m_iterations; }
+double BenchmarkState::getRealSeconds() const { return m_realSeconds; }
+double BenchmarkState::getCpuSeconds() const { return m_cpuSeconds; }
+long long BenchmarkState::getItemsProcessed() const { return m_items; }
+long long BenchmarkState::getBytesProcessed() const { return m_bytes; }
+void BenchmarkState::setItemsProcessed(long long items) { m_items = items; }
+void BenchmarkState::setBytesProcessed(long long bytes) { m_bytes = bytes; }
+const vector<pair<string, double>>& BenchmarkState::getCounters() const { return m_counters; }
+const string& BenchmarkState::getError() const { return m_error; }
+
+// Report an extra value with the results, replacing any counter of the same name
+void BenchmarkState::setCounter(const string& name, double value) {
+    for (pair<string, double>& counter : m_counters) {
+        if (counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    m_counters.push_back({ name, value });
+}
+
+// Abandon the run, the body should return right after
+void BenchmarkState::skipWithError(const string& error) {
+    m_error = error;
+    m_remaining = 0;
+    pauseTiming();
+}
+
+// Start the clock on the first call, stop it after the last iteration
+bool BenchmarkState::keepRunning() {
+    if (m_remaining == m_iterations && !m_running && m_error.empty()) resumeTiming();
+    if (m_remaining > 0) {
+        --m_remaining;
+        return true;
+    }
+    pauseTiming();
+    return false;
+}
+
+// Exclude setup work, such as deleting an output file, from the measurement
+void BenchmarkState::pauseTiming() {
+    if (!m_running) return;
+    m_realSeconds += chrono::duration<double>(chrono::steady_clock::now() - m_realStart).count();
+    m_cpuSeconds += cpuSeconds() - m_cpuStart;
+    m_running = false;
+}
+
+void BenchmarkState::resumeTiming() {
+    if (m_running) return;
+    m_running = true;
+    m_cpuStart = cpuSeconds();
+    m_realStart = chrono::steady_clock::now();
+}
+
+//Default constructor
+BenchmarkBS::BenchmarkBS() : m_minTime(0.5) {
+}
+
+void BenchmarkBS::setMinTime(double seconds) { m_minTime = seconds; }
+void BenchmarkBS::setFilter(const string& filter) { m_filter = filter; }
+void BenchmarkBS::addContext(const string& key, const string& value) { m_context.push_back({ key, value }); }
+const vector<BenchmarkResult>& BenchmarkBS::getResults() const { return m_results; }
+
+// Register a body once per argument list, named "name/arg0/arg1..."
+BenchmarkBS& BenchmarkBS::add(const string& name, Body body, const vector<vector<long long>>& argLists) {
+    if (argLists.empty()) {
+        m_entries.push_back({ name, body, {} });
+        return *this;
+    }
+    for (const vector<long long>& args : argLists) {
+        string full = name;
+        for (long long arg : args) full += "/" + to_string(arg);
+        m_entries.push_back({ full, body, args });
+    }
+    return *this;
+}
+
+vector<vector<long long>> BenchmarkBS::product(const vector<vector<long long>>& ranges) {
+    vector<vector<long long>> lists(1);
+    for (const vector<long long>& range : ranges) {
+        vector<vector<long long>> grown;
+        for (const vector<long long>& prefix : lists) {
+            for (long long value : range) {
+                grown.push_back(prefix);
+                grown.back().push_back(value);
+            }
+        }
+        lists.swap(grown);
+    }
+    return lists;
+}
+
+bool BenchmarkBS::matches(const string& name) const {
+    return m_filter.empty() || regex_search(name, regex(m_filter));
+}
+
+void BenchmarkBS::list(ostream& out) const {
+    for (const Entry& entry : m_entries) {
+        if (matches(entry.name)) out << entry.name << "\n";
+    }
+}
+
+// Grow the iteration count until a run lasts m_minTime, as Google Benchmark does
+bool BenchmarkBS::runOne(const Entry& entry, BenchmarkResult& result, string& error) {
+    long long iterations = 1;
+    while (true) {
+        BenchmarkState state(entry.args, iterations);
+        entry.body(state);
+        if (!state.getError().empty()) {
+            error = state.getError();
+            return false;
+        }
+        double seconds = state.getRealSeconds();
+        if (seconds >= m_minTime || iterations >= maxIterations) {
+            result.name = entry.name;
+            result.iterations = iterations;
+            result.realNs = seconds * 1e9 / iterations;
+            result.cpuNs = state.getCpuSeconds() * 1e9 / iterations;
+            result.items = state.getItemsProcessed();
+            result.bytes = state.getBytesProcessed();
+            result.counters = state.getCounters();
+            return true;
+        }
+        double multiplier = seconds > 0 ? m_minTime * 1.4 / seconds : 10.0;
+        if (seconds < 0.1 * m_minTime) multiplier = min(multiplier, 10.0);
+        long long next = (long long)(iterations * multiplier);
+        iterations = min(maxIterations, max(iterations + 1, next));
+    }
+}
+
+string BenchmarkBS::formatTime(double ns) {
+    const char* unit = " ns";
+    double value = ns;
+    if (ns >= 1e7) {
+        value = ns / 1e6;
+        unit = " ms";
+    } else if (ns >= 1e4) {
+        value = ns / 1e3;
+        unit = " us";
+    }
+    ostringstream text;
+    text << fixed << setprecision(value < 10 ? 2 : (value < 100 ? 1 : 0)) << value << unit;
+    return text.str();
+}
+
+string BenchmarkBS::formatRate(double perSecond) {
+    ostringstream text;
+    text << fixed << setprecision(2);
+    if (perSecond >= 1e9) text << perSecond / 1e9 << "G/s";
+    else if (perSecond >= 1e6) text << perSecond / 1e6 << "M/s";
+    else if (perSecond >= 1e3) text << perSecond / 1e3 << "k/s";
+    else text << perSecond << "/s";
+    return text.str();
+}
+
+// Run every benchmark that matches the filter, printing one table row per run
+bool BenchmarkBS::runAll(ostream& table) {
+    m_results.clear();
+    size_t nameWidth = 10;
+    for (const Entry& entry : m_entries) {
+        if (matches(entry.name)) nameWidth = max(nameWidth, entry.name.size());
+    }
+    table << left << setw(nameWidth + 2) << "Benchmark" << right << setw(12) << "Time" << setw(12) << "CPU"
+        << setw(12) << "Iterations" << setw(12) << "ns/item" << setw(14) << "items/sec" << "\n";
+    table << string(nameWidth + 64, '-') << "\n";
+
+    bool allPassed = true;
+    for (const Entry& entry : m_entries) {
+        if (!matches(entry.name)) continue;
+        BenchmarkResult result;
+        string error;
+        table << left << setw(nameWidth + 2) << entry.name << right << flush;
+        if (!runOne(entry, result, error)) {
+            table << "ERROR: " << error << "\n";
+            allPassed = false;
+            continue;
+        }
+        double itemsPerIteration = (double)result.items / result.iterations;
+        table << setw(12) << formatTime(result.realNs) << setw(12) << formatTime(result.cpuNs) << setw(12) << result.iterations;
+        if (result.items > 0) {
+            table << setw(12) << formatTime(result.realNs / itemsPerIteration)
+                << setw(14) << formatRate(itemsPerIteration * 1e9 / result.realNs);
+        }
+        for (const pair<string, double>& counter : result.counters) table << " " << counter.first << "=" << counter.second;
+        table << "\n";
+        m_results.push_back(result);
+    }
+    return allPassed;
+}
+
+// Results in the JSON layout of Google Benchmark, so its compare.py can diff two runs
+void BenchmarkBS::writeJson(ostream& out, const string& executable) const {
+    char date[64] = "";
+    time_t now = time(nullptr);
+    struct tm local;
+#if defined(_MSC_VER)
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &local);
+
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": " << jsonString(date) << ",\n";
+    out << "    \"executable\": " << jsonString(executable) << ",\n";
+    out << "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"";
+#else
+    out << "    \"library_build_type\": \"debug\"";
+#endif
+    for (const pair<string, string>& item : m_context) {
+        out << ",\n    " << jsonString(item.first) << ": " << jsonString(item.second);
+    }
+    out << "\n  },\n  \"benchmarks\": [";
+
+    out << setprecision(10);
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const BenchmarkResult& result = m_results[i];
+        double realSeconds = result.realNs * result.iterations / 1e9;
+        out << (i ? "," : "") << "\n    {\n";
+        out << "      \"name\": " << jsonString(result.name) << ",\n";
+        out << "      \"run_name\": " << jsonString(result.name) << ",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"real_time\": " << result.realNs << ",\n";
+        out << "      \"cpu_time\": " << result.cpuNs << ",\n";
+        out << "      \"time_unit\": \"ns\"";
+        if (result.items > 0 && realSeconds > 0) {
+            out << ",\n      \"items_per_second\": " << result.items / realSeconds;
+            out << ",\n      \"ns_per_item\": " << result.realNs * result.iterations / result.items;
+        }
+        if (result.bytes > 0 && realSeconds > 0) out << ",\n      \"bytes_per_second\": " << result.bytes / realSeconds;
+        for (const pair<string, double>& counter : result.counters) {
+            out << ",\n      " << jsonString(counter.first) << ": " << counter.second;
+        }
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
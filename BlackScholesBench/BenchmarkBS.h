@@ -0,0 +1,155 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	BenchmarkBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the BenchmarkState and BenchmarkBS Classes, a small
+*					microbenchmark harness in the style of Google Benchmark: benchmarks are
+*					registered with argument lists, iterations grow until a minimum time is
+*					reached and results are reported as a table and as JSON.
+*
+* References	:	- Google Benchmark, https://github.com/google/benchmark
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// Keep the compiler from discarding a computed value
+template <class T> inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const volatile void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#endif
+}
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Result of one benchmark run with one set of arguments
+struct BenchmarkResult {
+    string name;
+    long long iterations = 0;
+    double realNs = 0;          // Wall time per iteration
+    double cpuNs = 0;           // Process CPU time per iteration, all threads
+    long long items = 0;        // Items (contracts, values, rows) processed in total
+    long long bytes = 0;        // Bytes written in total
+    vector<pair<string, double>> counters;  // User counters, e.g. solver iterations per item
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+// Handed to a benchmark body, which times a loop of the form: while (state.keepRunning()) { ... }
+class BenchmarkState
+{
+    public:
+
+        //constructors
+        BenchmarkState(const vector<long long>& args, long long iterations);
+
+        //accessors
+        long long range(size_t index) const;
+        long long getIterations() const;
+        double getRealSeconds() const;
+        double getCpuSeconds() const;
+        long long getItemsProcessed() const;
+        long long getBytesProcessed() const;
+        void setItemsProcessed(long long items);
+        void setBytesProcessed(long long bytes);
+        void setCounter(const string& name, double value);
+        const vector<pair<string, double>>& getCounters() const;
+        void skipWithError(const string& error);
+        const string& getError() const;
+
+        // Public Member functions
+        bool keepRunning();
+        void pauseTiming();
+        void resumeTiming();
+
+    private:
+
+        // private  Member variables
+        vector<long long> m_args;           // Arguments of this run
+        long long m_iterations;             // Iterations to time
+        long long m_remaining;              // Iterations left
+        bool m_running;                     // Timer started and not paused
+        chrono::steady_clock::time_point m_realStart;
+        double m_cpuStart;
+        double m_realSeconds;               // Accumulated while running
+        double m_cpuSeconds;
+        long long m_items;
+        long long m_bytes;
+        vector<pair<string, double>> m_counters;
+        string m_error;
+};
+
+class BenchmarkBS
+{
+    public:
+
+        typedef function<void(BenchmarkState&)> Body;
+
+        //constructors
+        BenchmarkBS();
+
+        //accessors
+        void setMinTime(double seconds);
+        void setFilter(const string& filter);
+        void addContext(const string& key, const string& value);
+
+        // Public Member functions
+        BenchmarkBS& add(const string& name, Body body, const vector<vector<long long>>& argLists = {});
+        void list(ostream& out) const;
+        bool runAll(ostream& table);
+        void writeJson(ostream& out, const string& executable) const;
+        const vector<BenchmarkResult>& getResults() const;
+
+        // Cartesian product of argument ranges, e.g. sizes x thread counts
+        static vector<vector<long long>> product(const vector<vector<long long>>& ranges);
+
+    private:
+
+        struct Entry {
+            string name;
+            Body body;
+            vector<long long> args;
+        };
+
+        // private Member functions
+        bool matches(const string& name) const;
+        bool runOne(const Entry& entry, BenchmarkResult& result, string& error);
+        static string formatTime(double ns);
+        static string formatRate(double perSecond);
+
+        // private  Member variables
+        vector<Entry> m_entries;            // Registered benchmarks, one per argument list
+        vector<BenchmarkResult> m_results;  // Results of the last runAll
+        vector<pair<string, string>> m_context; // Extra JSON context, e.g. the SIMD level
+        double m_minTime;                   // Seconds a timed run must last
+        string m_filter;                    // Regular expression over the names, empty runs all
+};
+
+// Benchmarks of the BlackScholesDL hot paths, defined in BenchmarksBS.cpp
+void registerBenchmarks(BenchmarkBS& suite);
@@ -0,0 +1,874 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	BenchmarksBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Benchmarks of the pricing and dataset generation hot paths: the virtual
+*					scalar classes against the compile time kernels, the batch and SIMD
+*					pricers, every Greek with the AD and bumped second order Greeks, the
+*					normal CDF approximations, Monte Carlo variance reduction, finite
+*					difference solves, implied volatility, lookup grids, random and low
+*					discrepancy sampling, neural network inference, scenario grids and
+*					CSV against binary output,
+*					across batch sizes and thread counts.
+*
+* References	:
+* Other files	:	BenchmarkBS.cpp, the BlackScholesDL library sources
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "BenchmarkBS.h"
+#include "CounterRNG.h"
+#include "CsvFormatBS.h"
+#include "EurBatchBS.h"
+#include "EurCallBS.h"
+#include "EurDataSetBS.h"
+#include "EurGreeksBS.h"
+#include "EurKernelBS.h"
+#include "EurPutBS.h"
+#include "EurSimdBS.h"
+#include "FiniteDifferenceBS.h"
+#include "ImpliedVolBS.h"
+#include "MlpPricerBS.h"
+#include "MonteCarloBS.h"
+#include "NormalCDFBS.h"
+#include "PriceGridBS.h"
+#include "SamplerBS.h"
+#include "ScenarioEngineBS.h"
+
+// Batch sizes: fits in L1, fits in L2, streams from memory
+static const vector<long long> batchSizes = { 64, 4096, 262144 };
+
+// Paths of one Monte Carlo price
+static const long long monteCarloPaths = 1 << 18;
+
+// Contracts of one finite difference batch
+static const long long finiteDifferenceContracts = 64;
+
+// Rows of a generated dataset file
+static const long long dataSetRows = 1 << 18;
+
+// Spot and vol shocks of a scenario grid side
+static const size_t scenarioSide = 21;
+
+// Scratch file of the output benchmarks
+static const string scratchFile = "BlackScholesBench.tmp";
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// Random contracts with the input columns and every output column of a batch
+struct BenchContracts {
+    vector<double> T, K, S0, sigma, r;
+    vector<double> x;                       // Arguments of the CDF benchmarks
+    vector<double> price, delta, gamma, theta, putPrice, putDelta, putTheta;
+
+    BenchContracts(size_t n) : T(n), K(n), S0(n), sigma(n), r(n), x(n), price(n), delta(n), gamma(n),
+        theta(n), putPrice(n), putDelta(n), putTheta(n) {
+        CounterRNG rng(2020);
+        for (size_t i = 0; i < n; ++i) {
+            T[i] = rng.uniform(i, 0, 0.01, 2.0);
+            S0[i] = rng.uniform(i, 1, 10.0, 500.0);
+            K[i] = S0[i] * rng.uniform(i, 2, 0.5, 1.5);
+            sigma[i] = rng.uniform(i, 3, 0.05, 1.0);
+            r[i] = rng.uniform(i, 4, 0.0, 0.1);
+            x[i] = rng.uniform(i, 5, -8.0, 8.0);
+        }
+    }
+
+    EurBSBatchInput input(size_t first, size_t n) const {
+        return { n, &T[first], &K[first], &S0[first], &sigma[first], &r[first] };
+    }
+    EurBSBatchOutput call(size_t first) { return { &price[first], &delta[first], &gamma[first], &theta[first] }; }
+    EurBSBatchOutput put(size_t first) { return { &putPrice[first], &putDelta[first], nullptr, &putTheta[first] }; }
+};
+
+// Shared by every benchmark, built on first use
+static BenchContracts& contracts() {
+    static BenchContracts data((size_t)batchSizes.back());
+    return data;
+}
+
+// 1, 2, 4, ... up to every hardware thread
+static vector<long long> threadCounts() {
+    long long maxThreads = max(1u, thread::hardware_concurrency());
+    vector<long long> counts;
+    for (long long t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+static string levelName(SimdLevel level) {
+    switch (level) {
+    case SIMD_AVX512: return "avx512";
+    case SIMD_AVX2: return "avx2";
+    case SIMD_SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+// Quotes priced from the shared contracts, calls and puts alternating
+struct BenchQuotes {
+    vector<double> price;
+    vector<char> isCall;
+    vector<double> sigma;
+    vector<int> iterations;
+
+    BenchQuotes(BenchContracts& data) : price(data.T.size()), isCall(data.T.size()), sigma(data.T.size()),
+        iterations(data.T.size()) {
+        size_t n = data.T.size();
+        EurSimdBS::evaluateBatch(data.input(0, n), data.call(0), data.put(0));
+        for (size_t i = 0; i < n; ++i) {
+            isCall[i] = i % 2 == 0;
+            price[i] = isCall[i] ? data.price[i] : data.putPrice[i];
+        }
+    }
+
+    ImpliedVolBatchInput input(const BenchContracts& data, size_t n) const {
+        return { n, &price[0], &data.T[0], &data.K[0], &data.S0[0], &data.r[0], &isCall[0] };
+    }
+};
+
+static BenchQuotes& quotes() {
+    static BenchQuotes data(contracts());
+    return data;
+}
+
+// Volatility surface of one underlying, 64 strikes per expiry as a quoting engine sees it
+struct BenchSurface {
+    vector<double> T, K, S0, sigma, r;
+
+    BenchSurface(const BenchContracts& data) : T(data.T.size()), K(data.T.size()), S0(data.T.size(), 100.0),
+        sigma(data.T.size()), r(data.T.size()) {
+        for (size_t i = 0; i < T.size(); ++i) {
+            size_t expiry = i / 64 * 64;
+            T[i] = max(0.05, data.T[expiry]);
+            r[i] = data.r[expiry];
+            K[i] = 60.0 + 1.5 * (double)(i % 64);
+            sigma[i] = data.sigma[i] * 0.6;
+        }
+    }
+
+    EurBSBatchInput input(size_t n) const { return { n, &T[0], &K[0], &S0[0], &sigma[0], &r[0] }; }
+};
+
+static BenchSurface& surface() {
+    static BenchSurface data(contracts());
+    return data;
+}
+
+// Lookup grids with the default ranges and resolution, built on first use
+static const PriceGridBS& priceGrid(PriceGridMethod method) {
+    static PriceGridBS grids[2];
+    if (!grids[method].isBuilt()) {
+        PriceGridSpec spec;
+        spec.method = method;
+        grids[method].build(spec);
+    }
+    return grids[method];
+}
+
+static long long fileSize(const string& fileName) {
+    ifstream file(fileName, ios::binary | ios::ate);
+    return file.is_open() ? (long long)file.tellg() : 0;
+}
+
+/****************************************************************************************
+*									BENCHMARKS											*
+****************************************************************************************/
+
+typedef double (EurOptionBS::*FormulaBS)(double S0, double sigma, double r);
+
+// One formula of the virtual scalar classes over a batch, as the original generator priced
+static void scalarFormula(BenchmarkState& state, EurOptionBS& option, FormulaBS formula) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    while (state.keepRunning()) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            option.setT(data.T[i]);
+            option.setK(data.K[i]);
+            sum += (option.*formula)(data.S0[i], data.sigma[i], data.r[i]);
+        }
+        doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// Price and every Greek of both options through the virtual classes, one call each
+static void scalarAll(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    EurCallBS call;
+    EurPutBS put;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < n; ++i) {
+            double T = data.T[i], K = data.K[i], S0 = data.S0[i], sigma = data.sigma[i], r = data.r[i];
+            call.setT(T); call.setK(K);
+            put.setT(T); put.setK(K);
+            data.price[i] = call.priceByBSFormula(S0, sigma, r);
+            data.delta[i] = call.deltaByBSFormula(S0, sigma, r);
+            data.theta[i] = call.thetaByBSFormula(S0, sigma, r);
+            data.putPrice[i] = put.priceByBSFormula(S0, sigma, r);
+            data.putDelta[i] = put.deltaByBSFormula(S0, sigma, r);
+            data.putTheta[i] = put.thetaByBSFormula(S0, sigma, r);
+            data.gamma[i] = call.gammaByBSFormula(S0, sigma, r);
+        }
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// One formula through the compile time kernel, the counterpart of scalarFormula
+template <EurPayoff Payoff, unsigned Greek>
+static void kernelFormula(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    while (state.keepRunning()) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            EurKernelResult res = EurKernelBS<Payoff, Greek>::evaluate(data.T[i], data.K[i], data.S0[i], data.sigma[i], data.r[i]);
+            sum += res.price + res.delta + res.gamma + res.theta;
+        }
+        doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// The record of scalarAll through the kernels, one call and one put evaluation per contract
+static void kernelAll(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < n; ++i) {
+            double T = data.T[i], K = data.K[i], S0 = data.S0[i], sigma = data.sigma[i], r = data.r[i];
+            EurKernelResult call = EurKernelBS<PAYOFF_CALL, GREEK_BATCH>::evaluate(T, K, S0, sigma, r);
+            EurKernelResult put = EurKernelBS<PAYOFF_PUT, GREEK_PRICE | GREEK_DELTA | GREEK_THETA>::evaluate(T, K, S0, sigma, r);
+            data.price[i] = call.price;
+            data.delta[i] = call.delta;
+            data.theta[i] = call.theta;
+            data.putPrice[i] = put.price;
+            data.putDelta[i] = put.delta;
+            data.putTheta[i] = put.theta;
+            data.gamma[i] = call.gamma;
+        }
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+static void batchPriceCalls(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    EurBSBatchOutput out = { &data.price[0], nullptr, nullptr, nullptr };
+    while (state.keepRunning()) {
+        EurBatchBS::priceCalls(data.input(0, n), out);
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+static void batchEvaluate(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    while (state.keepRunning()) {
+        EurBatchBS::evaluateBatch(data.input(0, n), data.call(0), data.put(0));
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// Price and Greeks of both options with one instruction set, split over range(1) threads
+static void simdEvaluate(BenchmarkState& state, SimdLevel level) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    size_t threads = (size_t)state.range(1);
+    SimdLevel previous = EurSimdBS::getLevel();
+    EurSimdBS::setLevel(level);
+    while (state.keepRunning()) {
+        if (threads <= 1) {
+            EurSimdBS::evaluateBatch(data.input(0, n), data.call(0), data.put(0));
+        } else {
+            vector<future<void>> workers;
+            size_t step = (n + threads - 1) / threads;
+            for (size_t first = 0; first < n; first += step) {
+                size_t count = min(step, n - first);
+                workers.push_back(async(launch::async, [&data, first, count]() {
+                    EurSimdBS::evaluateBatch(data.input(first, count), data.call(first), data.put(first));
+                }));
+            }
+            for (future<void>& worker : workers) worker.get();
+        }
+        doNotOptimize(data.price[0]);
+    }
+    EurSimdBS::setLevel(previous);
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// Abramowitz-Stegun approximation of the scalar classes
+static void cdfScalar(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < n; ++i) data.price[i] = EurOptionBS::normalCDF(data.x[i]);
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// Exact reference through the standard library erfc
+static void cdfErfc(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    const double invSqrtTwo = 1.0 / sqrt(2.0);
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < n; ++i) data.price[i] = 0.5 * erfc(-data.x[i] * invSqrtTwo);
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// One NormalCDFBS backend over a batch, reporting its measured max error
+static void cdfBackend(BenchmarkState& state, CdfBackend backend) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    CdfBackend previous = NormalCDFBS::getBackend();
+    NormalCDFBS::setBackend(backend);
+    while (state.keepRunning()) {
+        NormalCDFBS::cdfBatch(n, &data.x[0], &data.price[0]);
+        doNotOptimize(data.price[0]);
+    }
+    NormalCDFBS::setBackend(previous);
+    state.setItemsProcessed(state.getIterations() * n);
+    state.setCounter("max_error", NormalCDFBS::measure(backend).maxError);
+}
+
+static void cdfSimd(BenchmarkState& state, SimdLevel level) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    SimdLevel previous = EurSimdBS::getLevel();
+    EurSimdBS::setLevel(level);
+    while (state.keepRunning()) {
+        EurSimdBS::normalCDF(n, &data.x[0], &data.price[0]);
+        doNotOptimize(data.price[0]);
+    }
+    EurSimdBS::setLevel(previous);
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+static void pdfScalar(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < n; ++i) data.price[i] = EurOptionBS::normalPDF(data.x[i]);
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+static void pdfSimd(BenchmarkState& state, SimdLevel level) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    SimdLevel previous = EurSimdBS::getLevel();
+    EurSimdBS::setLevel(level);
+    while (state.keepRunning()) {
+        EurSimdBS::normalPDF(n, &data.x[0], &data.price[0]);
+        doNotOptimize(data.price[0]);
+    }
+    EurSimdBS::setLevel(previous);
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// Every first and second order Greek of a call and a put, by AD or by bump and reprice
+static void greeksBatch(BenchmarkState& state, bool bump) {
+    static vector<vector<double>> columns(18, vector<double>((size_t)batchSizes.back()));
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    double* c[18];
+    for (int k = 0; k < 18; ++k) c[k] = &columns[k][0];
+    EurGreeksBatchOutput call = { c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8] };
+    EurGreeksBatchOutput put = { c[9], c[10], c[11], c[12], c[13], c[14], c[15], c[16], c[17] };
+    while (state.keepRunning()) {
+        if (bump) EurGreeksBS::bumpAndRepriceBatch(data.input(0, n), call, put);
+        else EurGreeksBS::evaluateBatch(data.input(0, n), call, put);
+        doNotOptimize(c[0][0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// One at the money call by Monte Carlo with range(1) threads, reporting the standard error and
+// the convergence per second 1 / (error^2 * seconds) that variance reduction trades against speed
+static void monteCarlo(BenchmarkState& state, MonteCarloSampler sampler, bool antithetic, bool control) {
+    MonteCarloParams params;
+    params.numPaths = state.range(0);
+    params.numThreads = (int)state.range(1);
+    params.sampler = sampler;
+    params.antithetic = antithetic;
+    params.controlVariate = control;
+    MonteCarloBS engine(params);
+    MonteCarloOption option;
+    MonteCarloResult result;
+    while (state.keepRunning()) {
+        engine.price(option, result);
+        doNotOptimize(result.price);
+    }
+    state.setItemsProcessed(state.getIterations() * result.paths);
+    state.setCounter("std_error", result.stdError);
+    double seconds = state.getRealSeconds() / state.getIterations();
+    state.setCounter("convergence_per_sec", 1.0 / (result.stdError * result.stdError * seconds));
+}
+
+// Finite difference prices of the shared contracts, calls and puts alternating, with range(1)
+// threads, reporting the constraint iterations per time step of American exercise
+static void finiteDifference(BenchmarkState& state, FdExercise exercise, FdConstraint constraint) {
+    BenchContracts& data = contracts();
+    BenchQuotes& chain = quotes();
+    size_t n = (size_t)state.range(0);
+    FiniteDifferenceSpec spec;
+    spec.exercise = exercise;
+    spec.constraint = constraint;
+    FiniteDifferenceBS solver(spec);
+    solver.setThreads((int)state.range(1));
+    FiniteDifferenceBatchInput in = { n, &data.T[0], &data.K[0], &data.S0[0], &data.sigma[0], &data.r[0], &chain.isCall[0] };
+    while (state.keepRunning()) {
+        solver.priceBatch(in, data.call(0));
+        doNotOptimize(data.price[0]);
+    }
+    FiniteDifferenceResult rec;
+    solver.price(data.T[0], data.K[0], data.S0[0], data.sigma[0], data.r[0], true, rec);
+    state.setItemsProcessed(state.getIterations() * n);
+    state.setCounter("iterations_per_step", rec.iterations);
+}
+
+// One contract at a time, the baseline of the interleaved lanes of priceBatch
+static void finiteDifferenceSingle(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    FiniteDifferenceBS solver;
+    FiniteDifferenceResult rec;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < n; ++i) solver.price(data.T[i], data.K[i], data.S0[i], data.sigma[i], data.r[i], i % 2 == 0, rec);
+        doNotOptimize(rec.price);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// Implied volatility of a whole chain with range(1) threads, reporting iterations per quote
+static void impliedBatch(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    BenchQuotes& chain = quotes();
+    size_t n = (size_t)state.range(0);
+    ImpliedVolBS solver;
+    solver.setThreads((int)state.range(1));
+    ImpliedVolBatchOutput out = { &chain.sigma[0], &chain.iterations[0], nullptr };
+    while (state.keepRunning()) {
+        solver.solveBatch(chain.input(data, n), out);
+        doNotOptimize(chain.sigma[0]);
+    }
+    long long iterations = 0;
+    for (size_t i = 0; i < n; ++i) iterations += chain.iterations[i];
+    state.setItemsProcessed(state.getIterations() * n);
+    state.setCounter("iterations_per_quote", (double)iterations / n);
+}
+
+// One quote at a time, the latency of a single solve
+static void impliedSingle(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    BenchQuotes& chain = quotes();
+    size_t n = (size_t)state.range(0);
+    ImpliedVolBS solver;
+    while (state.keepRunning()) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += solver.solve(chain.price[i], data.T[i], data.K[i], data.S0[i], data.r[i], chain.isCall[i] != 0).sigma;
+        }
+        doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// Network prices of range(0) contracts with range(1) threads, an untrained model of the
+// given widths, to compare with Simd/*/evaluateBatch at the same sizes
+static void mlpPriceBatch(BenchmarkState& state, const vector<size_t>& widths) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    MlpPricerBS network(MlpPricerBS::randomModel(widths, 1));
+    network.setThreads((int)state.range(1));
+    while (state.keepRunning()) {
+        network.priceBatch(data.input(0, n), &data.price[0]);
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+    state.setCounter("flops_per_row", 2.0 * (double)network.getNumParameters());
+}
+
+// Grid lookups of random contracts or of a surface, reporting the share answered by the grid
+static void gridLookup(BenchmarkState& state, PriceGridMethod method, bool onSurface) {
+    BenchContracts& data = contracts();
+    const PriceGridBS& grid = priceGrid(method);
+    size_t n = (size_t)state.range(0), inGrid = 0;
+    EurBSBatchInput in = onSurface ? surface().input(n) : data.input(0, n);
+    while (state.keepRunning()) {
+        inGrid = grid.lookupBatch(in, data.call(0), data.put(0));
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+    state.setCounter("in_grid", (double)inGrid / n);
+    state.setCounter("grid_kb", grid.getMemoryBytes() / 1024.0);
+}
+
+// The closed form on the same surface, the baseline of the grid lookups
+static void surfaceEvaluate(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    while (state.keepRunning()) {
+        EurBatchBS::evaluateBatch(surface().input(n), data.call(0), data.put(0));
+        doNotOptimize(data.price[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// One uniform draw per item from the counter based stream of the generator
+static void rngCounter(BenchmarkState& state) {
+    size_t n = (size_t)state.range(0);
+    CounterRNG rng(42);
+    uint64_t row = 0;
+    while (state.keepRunning()) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += rng.uniform(row + i / 4, i % 4, 0.0, 500.0);
+        row += n / 4;
+        doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// The sequential engine the generator used before CounterRNG
+static void rngMersenne(BenchmarkState& state) {
+    size_t n = (size_t)state.range(0);
+    mt19937 engine(42);
+    uniform_real_distribution<double> dist(0.0, 500.0);
+    while (state.keepRunning()) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += dist(engine);
+        doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+}
+
+// Points of the dataset sampler in generator sized blocks, reporting the L2-star discrepancy
+// of the first 4096 points (Warnock's formula), lower is more uniform
+static void samplerFill(BenchmarkState& state, DataSetSampling sampling) {
+    long long n = state.range(0), block = 16384;
+    const int dims = SamplerBS::dimensions;
+    SamplerBS sampler(sampling, 42, n);
+    vector<vector<double>> columns(dims, vector<double>((size_t)block));
+    double* unit[dims];
+    for (int d = 0; d < dims; ++d) unit[d] = columns[d].data();
+    while (state.keepRunning()) {
+        for (long long first = 0; first < n; first += block) sampler.fill(first, min(block, n - first), unit);
+        doNotOptimize(columns[dims - 1][0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+
+    long long m = min(n, 4096LL);
+    SamplerBS prefix(sampling, 42, m);
+    prefix.fill(0, m, unit);
+    double single = 0, pairs = 0;
+    for (long long i = 0; i < m; ++i) {
+        double product = 1;
+        for (int d = 0; d < dims; ++d) product *= 0.5 * (1 - columns[d][i] * columns[d][i]);
+        single += product;
+        for (long long j = 0; j < m; ++j) {
+            double pair = 1;
+            for (int d = 0; d < dims; ++d) pair *= 1 - max(columns[d][i], columns[d][j]);
+            pairs += pair;
+        }
+    }
+    state.setCounter("l2_star_discrepancy", sqrt(pow(3.0, -dims) - 2.0 * single / m + pairs / ((double)m * m)));
+}
+
+// Numbers as CSV text with 8 decimals, items are numbers; the stream version is the
+// formatting CsvFormatBS replaced in the CSV outputs
+static void csvWriteFixed(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    string text(n * (CsvFormatBS::maxFixedChars + 1), ' ');
+    long long bytes = 0;
+    while (state.keepRunning()) {
+        char* p = &text[0];
+        for (size_t i = 0; i < n; ++i) {
+            p = CsvFormatBS::writeFixed(p, data.S0[i], 8);
+            *p++ = ',';
+        }
+        bytes += (long long)(p - &text[0]);
+        doNotOptimize(text[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+    state.setBytesProcessed(bytes);
+}
+
+static void csvOstream(BenchmarkState& state) {
+    BenchContracts& data = contracts();
+    size_t n = (size_t)state.range(0);
+    long long bytes = 0;
+    while (state.keepRunning()) {
+        ostringstream text;
+        text << fixed << setprecision(8);
+        for (size_t i = 0; i < n; ++i) text << data.S0[i] << ",";
+        bytes += (long long)text.tellp();
+        doNotOptimize(bytes);
+    }
+    state.setItemsProcessed(state.getIterations() * n);
+    state.setBytesProcessed(bytes);
+}
+
+// Portfolio of the first range(0) shared contracts, calls and puts alternating, long and short
+static ScenarioPortfolio scenarioPortfolio(const BenchContracts& data, size_t n) {
+    ScenarioPortfolio portfolio;
+    portfolio.T.assign(data.T.begin(), data.T.begin() + n);
+    portfolio.K.assign(data.K.begin(), data.K.begin() + n);
+    portfolio.S0.assign(data.S0.begin(), data.S0.begin() + n);
+    portfolio.sigma.assign(data.sigma.begin(), data.sigma.begin() + n);
+    portfolio.r.assign(data.r.begin(), data.r.begin() + n);
+    for (size_t i = 0; i < n; ++i) {
+        portfolio.quantity.push_back(i % 3 == 0 ? -1.0 : 2.0);
+        portfolio.isCall.push_back(i % 2 == 0);
+    }
+    return portfolio;
+}
+
+// Surfaces of range(0) positions on a scenarioSide square grid with range(1) threads,
+// items are position-scenario pairs
+static void scenarioEngine(BenchmarkState& state) {
+    size_t n = (size_t)state.range(0);
+    ScenarioEngineBS engine;
+    engine.setPortfolio(scenarioPortfolio(contracts(), n));
+    engine.setThreads((int)state.range(1));
+    ScenarioGrid grid = ScenarioEngineBS::uniformGrid(-0.25, 0.25, scenarioSide, -0.1, 0.1, scenarioSide);
+    ScenarioSurface surface;
+    while (state.keepRunning()) {
+        engine.run(grid, surface);
+        doNotOptimize(surface.value[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n * scenarioSide * scenarioSide);
+}
+
+// The same surfaces from one full batch evaluation of shocked inputs per scenario, summed
+// afterwards, the repricing the engine replaces
+static void scenarioBatch(BenchmarkState& state) {
+    size_t n = (size_t)state.range(0);
+    ScenarioPortfolio portfolio = scenarioPortfolio(contracts(), n);
+    ScenarioGrid grid = ScenarioEngineBS::uniformGrid(-0.25, 0.25, scenarioSide, -0.1, 0.1, scenarioSide);
+    vector<double> S0(n), sigma(n), price(n), delta(n), gamma(n), theta(n), putPrice(n), putDelta(n), putTheta(n);
+    vector<double> value(scenarioSide * scenarioSide), totalDelta(value.size()), totalGamma(value.size());
+    while (state.keepRunning()) {
+        for (size_t v = 0; v < scenarioSide; ++v) {
+            for (size_t s = 0; s < scenarioSide; ++s) {
+                for (size_t i = 0; i < n; ++i) {
+                    S0[i] = portfolio.S0[i] * (1.0 + grid.spotShocks[s]);
+                    sigma[i] = max(portfolio.sigma[i] + grid.volShocks[v], ScenarioEngineBS::minVolatility);
+                }
+                EurBSBatchInput input = { n, &portfolio.T[0], &portfolio.K[0], &S0[0], &sigma[0], &portfolio.r[0] };
+                EurSimdBS::evaluateBatch(input, { &price[0], &delta[0], &gamma[0], &theta[0] },
+                    { &putPrice[0], &putDelta[0], nullptr, &putTheta[0] });
+                double sumValue = 0, sumDelta = 0, sumGamma = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    double w = portfolio.quantity[i];
+                    sumValue += w * (portfolio.isCall[i] ? price[i] : putPrice[i]);
+                    sumDelta += w * (portfolio.isCall[i] ? delta[i] : putDelta[i]);
+                    sumGamma += w * gamma[i];
+                }
+                value[v * scenarioSide + s] = sumValue;
+                totalDelta[v * scenarioSide + s] = sumDelta;
+                totalGamma[v * scenarioSide + s] = sumGamma;
+            }
+        }
+        doNotOptimize(value[0]);
+    }
+    state.setItemsProcessed(state.getIterations() * n * scenarioSide * scenarioSide);
+}
+
+// Whole generator run into a file with range(1) threads, without a file the CSV text is
+// formatted and discarded
+static void dataSetGenerate(BenchmarkState& state, DataSetFormat format, bool writeFile,
+    DataSetSampling sampling = SAMPLING_UNIFORM) {
+    DataSetParams params;
+    params.numSamples = state.range(0);
+    params.numThreads = (int)state.range(1);
+    params.seed = 42;
+    params.format = format;
+    params.sampling = sampling;
+    params.fileName = scratchFile;
+    EurDataSetBS generator(params);
+    long long bytes = 0;
+    while (state.keepRunning()) {
+        if (!writeFile) {
+            generator.generate(nullptr);
+            continue;
+        }
+        if (!generator.generate()) {
+            state.skipWithError("Unable to write " + scratchFile);
+            break;
+        }
+        state.pauseTiming();
+        bytes += fileSize(scratchFile);
+        remove(scratchFile.c_str());
+        state.resumeTiming();
+    }
+    state.setItemsProcessed(state.getIterations() * params.numSamples);
+    state.setBytesProcessed(bytes);
+}
+
+/****************************************************************************************
+*									REGISTRATION										*
+****************************************************************************************/
+
+void registerBenchmarks(BenchmarkBS& suite) {
+    vector<vector<long long>> sizes = BenchmarkBS::product({ batchSizes });
+    vector<vector<long long>> sizesThreads = BenchmarkBS::product({ batchSizes, threadCounts() });
+    vector<vector<long long>> rowsThreads = BenchmarkBS::product({ { dataSetRows }, threadCounts() });
+    vector<vector<long long>> pathsThreads = BenchmarkBS::product({ { monteCarloPaths }, threadCounts() });
+    vector<vector<long long>> solvesThreads = BenchmarkBS::product({ { finiteDifferenceContracts }, threadCounts() });
+
+    // Every formula of the virtual classes on its own
+    struct Formula { const char* name; FormulaBS formula; };
+    const Formula formulas[] = {
+        { "price", &EurOptionBS::priceByBSFormula }, { "delta", &EurOptionBS::deltaByBSFormula },
+        { "gamma", &EurOptionBS::gammaByBSFormula }, { "theta", &EurOptionBS::thetaByBSFormula } };
+    for (const Formula& f : formulas) {
+        FormulaBS formula = f.formula;
+        suite.add(string("Scalar/EurCallBS/") + f.name, [formula](BenchmarkState& state) {
+            EurCallBS option;
+            scalarFormula(state, option, formula);
+        }, sizes);
+        suite.add(string("Scalar/EurPutBS/") + f.name, [formula](BenchmarkState& state) {
+            EurPutBS option;
+            scalarFormula(state, option, formula);
+        }, sizes);
+    }
+
+    // The same formulas specialised at compile time
+    suite.add("Kernel/call/price", kernelFormula<PAYOFF_CALL, GREEK_PRICE>, sizes);
+    suite.add("Kernel/put/price", kernelFormula<PAYOFF_PUT, GREEK_PRICE>, sizes);
+    suite.add("Kernel/call/delta", kernelFormula<PAYOFF_CALL, GREEK_DELTA>, sizes);
+    suite.add("Kernel/put/delta", kernelFormula<PAYOFF_PUT, GREEK_DELTA>, sizes);
+    suite.add("Kernel/call/gamma", kernelFormula<PAYOFF_CALL, GREEK_GAMMA>, sizes);
+    suite.add("Kernel/call/theta", kernelFormula<PAYOFF_CALL, GREEK_THETA>, sizes);
+    suite.add("Kernel/put/theta", kernelFormula<PAYOFF_PUT, GREEK_THETA>, sizes);
+    suite.add("Kernel/call/batch", kernelFormula<PAYOFF_CALL, GREEK_BATCH>, sizes);
+
+    // Full record (both prices, deltas, thetas and gamma) per contract
+    suite.add("Scalar/all", scalarAll, sizes);
+    suite.add("Kernel/all", kernelAll, sizes);
+    suite.add("Batch/priceCalls", batchPriceCalls, sizes);
+    suite.add("Batch/evaluateBatch", batchEvaluate, sizes);
+    for (int level = SIMD_SCALAR; level <= EurSimdBS::detectLevel(); ++level) {
+        SimdLevel simd = (SimdLevel)level;
+        suite.add("Simd/" + levelName(simd) + "/evaluateBatch", [simd](BenchmarkState& state) {
+            simdEvaluate(state, simd);
+        }, sizesThreads);
+        suite.add("Simd/" + levelName(simd) + "/evaluateBatch/fastCDF", [simd](BenchmarkState& state) {
+            CdfBackend previous = NormalCDFBS::getBackend();
+            NormalCDFBS::setBackend(CDF_FAST);
+            simdEvaluate(state, simd);
+            NormalCDFBS::setBackend(previous);
+        }, sizesThreads);
+    }
+
+    // Normal distribution approximations
+    suite.add("CDF/abramowitzStegun", cdfScalar, sizes);
+    suite.add("CDF/erfc", cdfErfc, sizes);
+    for (int b = CDF_FAST; b < CDF_BACKENDS; ++b) {
+        CdfBackend backend = (CdfBackend)b;
+        suite.add("CDF/backend/" + NormalCDFBS::getBackendName(backend), [backend](BenchmarkState& state) {
+            cdfBackend(state, backend);
+        }, sizes);
+    }
+    for (int level = SIMD_SCALAR; level <= EurSimdBS::detectLevel(); ++level) {
+        SimdLevel simd = (SimdLevel)level;
+        suite.add("CDF/simd/" + levelName(simd), [simd](BenchmarkState& state) { cdfSimd(state, simd); }, sizes);
+    }
+    suite.add("PDF/scalar", pdfScalar, sizes);
+    for (int level = SIMD_SCALAR; level <= EurSimdBS::detectLevel(); ++level) {
+        SimdLevel simd = (SimdLevel)level;
+        suite.add("PDF/simd/" + levelName(simd), [simd](BenchmarkState& state) { pdfSimd(state, simd); }, sizes);
+    }
+
+    // Full Greeks, to compare with the price and Greeks of Batch/evaluateBatch
+    suite.add("Greeks/ad/evaluateBatch", [](BenchmarkState& state) { greeksBatch(state, false); }, sizes);
+    suite.add("Greeks/bump/evaluateBatch", [](BenchmarkState& state) { greeksBatch(state, true); }, sizes);
+
+    // Monte Carlo, items are paths
+    suite.add("MonteCarlo/pseudo", [](BenchmarkState& state) { monteCarlo(state, MC_PSEUDO, false, false); }, pathsThreads);
+    suite.add("MonteCarlo/antithetic", [](BenchmarkState& state) { monteCarlo(state, MC_PSEUDO, true, false); }, pathsThreads);
+    suite.add("MonteCarlo/control", [](BenchmarkState& state) { monteCarlo(state, MC_PSEUDO, false, true); }, pathsThreads);
+    suite.add("MonteCarlo/antithetic+control", [](BenchmarkState& state) { monteCarlo(state, MC_PSEUDO, true, true); }, pathsThreads);
+    suite.add("MonteCarlo/sobol", [](BenchmarkState& state) { monteCarlo(state, MC_SOBOL, false, false); }, pathsThreads);
+
+    // Crank-Nicolson solves on the default 400 x 200 grid, items are contracts
+    suite.add("FD/european/price", finiteDifferenceSingle, BenchmarkBS::product({ { finiteDifferenceContracts } }));
+    suite.add("FD/european/priceBatch", [](BenchmarkState& state) { finiteDifference(state, FD_EUROPEAN, FD_PENALTY); }, solvesThreads);
+    suite.add("FD/american/penalty", [](BenchmarkState& state) { finiteDifference(state, FD_AMERICAN, FD_PENALTY); }, solvesThreads);
+    suite.add("FD/american/psor", [](BenchmarkState& state) { finiteDifference(state, FD_AMERICAN, FD_PSOR); }, solvesThreads);
+
+    // Implied volatility
+    suite.add("ImpliedVol/solveBatch", impliedBatch, sizesThreads);
+    suite.add("ImpliedVol/solve", impliedSingle, BenchmarkBS::product({ { 4096 } }));
+
+    // Neural network inference, the notebook architecture and a wider one
+    suite.add("Mlp/4-32-16-1/priceBatch", [](BenchmarkState& state) { mlpPriceBatch(state, { 4, 32, 16, 1 }); }, sizesThreads);
+    suite.add("Mlp/5-64-64-1/priceBatch", [](BenchmarkState& state) { mlpPriceBatch(state, { 5, 64, 64, 1 }); }, sizesThreads);
+
+    // Scenario grids, items are position-scenario pairs
+    vector<vector<long long>> positionsThreads = BenchmarkBS::product({ { 64, 4096 }, threadCounts() });
+    suite.add("Scenario/engine", scenarioEngine, positionsThreads);
+    suite.add("Scenario/evaluateBatch", scenarioBatch, BenchmarkBS::product({ { 64, 4096 } }));
+
+    // Lookup grids against the closed form
+    suite.add("Grid/linear/lookupBatch", [](BenchmarkState& state) { gridLookup(state, GRID_LINEAR, false); }, sizes);
+    suite.add("Grid/cubic/lookupBatch", [](BenchmarkState& state) { gridLookup(state, GRID_CUBIC, false); }, sizes);
+    suite.add("Grid/surface/evaluateBatch", surfaceEvaluate, sizes);
+    suite.add("Grid/surface/linear", [](BenchmarkState& state) { gridLookup(state, GRID_LINEAR, true); }, sizes);
+    suite.add("Grid/surface/cubic", [](BenchmarkState& state) { gridLookup(state, GRID_CUBIC, true); }, sizes);
+
+    // Random sampling
+    suite.add("RNG/CounterRNG", rngCounter, sizes);
+    suite.add("RNG/mt19937", rngMersenne, sizes);
+
+    // CSV number formatting
+    suite.add("Csv/writeFixed", csvWriteFixed, sizes);
+    suite.add("Csv/ostream", csvOstream, sizes);
+
+    // Dataset generation, items are rows
+    suite.add("DataSet/csvDiscarded", [](BenchmarkState& state) { dataSetGenerate(state, FORMAT_CSV, false); }, rowsThreads);
+    suite.add("DataSet/csv", [](BenchmarkState& state) { dataSetGenerate(state, FORMAT_CSV, true); }, rowsThreads);
+    suite.add("DataSet/bin64", [](BenchmarkState& state) { dataSetGenerate(state, FORMAT_FLOAT64, true); }, rowsThreads);
+    suite.add("DataSet/bin32", [](BenchmarkState& state) { dataSetGenerate(state, FORMAT_FLOAT32, true); }, rowsThreads);
+
+    // Sampling strategies of the generator, alone and in a whole float64 run
+    for (int s = SAMPLING_UNIFORM; s <= SAMPLING_LATIN; ++s) {
+        DataSetSampling sampling = (DataSetSampling)s;
+        string name = SamplerBS::getSamplingName(sampling);
+        suite.add("Sampler/" + name, [sampling](BenchmarkState& state) { samplerFill(state, sampling); },
+            BenchmarkBS::product({ { dataSetRows } }));
+        suite.add("DataSet/bin64/" + name, [sampling](BenchmarkState& state) {
+            dataSetGenerate(state, FORMAT_FLOAT64, true, sampling);
+        }, rowsThreads);
+    }
+}
@@ -0,0 +1,111 @@
+/****************************************************************************************
+* Project		:	Machine Learning and modern numerical techniques for high-dimensional
+*					option pricing - Financial Computing MSc. Dissertation QMUL 2019/2020
+* License		:	MIT License, https://opensource.org/licenses/MIT
+* Copyright (c) :	2020 Camilo Blanco
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+* Lenguaje / Env:	C++ / Microsoft Visual Studio Community 2019
+* Git Control	:	https://github.com/camiloblanco/BlackScholesDL
+* Description	:	main CPP file for the program BlackScholesBench, microbenchmarks of the
+*					BlackScholesDL pricing and dataset generation hot paths.
+*
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <string>
+
+#include "BenchmarkBS.h"
+#include "EurSimdBS.h"
+
+using namespace std;
+
+/****************************************************************************************
+*										FUNCTIONS									*
+****************************************************************************************/
+
+void printUsage(ostream& out) {
+	out << "Usage: BlackScholesBench [--filter regex] [--min_time 0.5] [--json file] [--list]" << endl << endl;
+	out << "  --filter    Run only the benchmarks whose name matches the regular expression" << endl;
+	out << "  --min_time  Seconds each benchmark runs for, iterations grow until reached" << endl;
+	out << "  --json      Also write the results as Google Benchmark compatible JSON" << endl;
+	out << "  --list      Print the benchmark names and exit" << endl;
+}
+
+/****************************************************************************************
+*											MAIN									*
+****************************************************************************************/
+
+int main(int argc, char* argv[])
+{
+	string filter, jsonFile;
+	double minTime = 0.5;
+	bool listOnly = false;
+
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--list") {
+			listOnly = true;
+		}
+		else if (arg == "--filter" && hasValue) {
+			filter = argv[++i];
+		}
+		else if (arg == "--json" && hasValue) {
+			jsonFile = argv[++i];
+		}
+		else if (arg == "--min_time" && hasValue) {
+			char* end = nullptr;
+			minTime = strtod(argv[++i], &end);
+			if (*end != '\0' || minTime <= 0) {
+				cerr << "Invalid --min_time: " << argv[i] << endl;
+				return 2;
+			}
+		}
+		else {
+			printUsage(arg == "--help" || arg == "-h" ? cout : cerr);
+			return arg == "--help" || arg == "-h" ? 0 : 2;
+		}
+	}
+
+	try {
+		regex check(filter);
+	}
+	catch (const regex_error&) {
+		cerr << "Invalid --filter: " << filter << endl;
+		return 2;
+	}
+
+	BenchmarkBS suite;
+	suite.setFilter(filter);
+	suite.setMinTime(minTime);
+	suite.addContext("simd_level", EurSimdBS::getLevelName());
+#ifdef BSDL_BUILD_PROFILE
+	suite.addContext("build_profile", BSDL_BUILD_PROFILE);
+#endif
+	registerBenchmarks(suite);
+	if (listOnly) {
+		suite.list(cout);
+		return 0;
+	}
+
+	cout << "SIMD level: " << EurSimdBS::getLevelName() << ", minimum time per benchmark: " << minTime << " s" << endl << endl;
+	bool passed = suite.runAll(cout);
+
+	if (!jsonFile.empty()) {
+		ofstream json(jsonFile);
+		suite.writeJson(json, argv[0]);
+		if (!json) {
+			cerr << "Unable to write " << jsonFile << endl;
+			return 1;
+		}
+		cout << endl << "Results written to " << jsonFile << endl;
+	}
+	return passed ? 0 : 1;
+}
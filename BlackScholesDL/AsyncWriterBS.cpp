@@ -0,0 +1,321 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	AsyncWriterBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the AsyncWriterBS Class
+*
+* References	:	- D. Vyukov, Bounded MPMC queue, 1024cores.net, 2011
+*					- P. Deutsch, GZIP file format specification, RFC 1952, 1996
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include "AsyncWriterBS.h"
+#include "ProfilerBS.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BSDL_POSIX_IO
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef BSDL_ZLIB
+#include <zlib.h>
+#endif
+
+// Deflate level of the gzip members, the fastest one keeps up with the formatting
+static const int gzipLevel = 1;
+
+// Polls of a slot state that only yield before the waiter starts sleeping, and the
+// longest sleep; blocks take milliseconds, so a late wake up costs little while frequent
+// ones would take the core from the workers
+static const int spinPolls = 64;
+static const long long maxSleepMicroseconds = 1000;
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+#ifdef BSDL_POSIX_IO
+// The whole buffer or false, retrying partial and interrupted writes
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t done = ::write(fd, data, size);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return false;
+        data += done;
+        size -= (size_t)done;
+    }
+    return true;
+}
+#endif
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+AsyncWriterBS::AsyncWriterBS() : m_options(), m_numBlocks(0), m_numRows(0), m_failed(false), m_abort(false),
+    m_bytesWritten(0), m_error("") {}
+
+//accessors
+uint64_t AsyncWriterBS::getBytesWritten() const { return m_bytesWritten; }
+string AsyncWriterBS::getError() const { return m_error; }
+
+// True when every file was opened with O_DIRECT
+bool AsyncWriterBS::isDirect() const {
+    if (m_shards.empty()) return false;
+    for (const Shard& shard : m_shards) if (!shard.direct) return false;
+    return true;
+}
+
+// Whether compress() was built in (BSDL_ZLIB)
+bool AsyncWriterBS::isCompressionAvailable() {
+#ifdef BSDL_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+// The text as one complete gzip member; members can be concatenated and gunzip, zlib and
+// pandas read them as a single stream. False when zlib is not built in.
+bool AsyncWriterBS::compress(const string& text, string& out) {
+#ifdef BSDL_ZLIB
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, gzipLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+    out.resize(deflateBound(&stream, (uLong)text.size()));
+    stream.next_in = (Bytef*)text.data();
+    stream.avail_in = (uInt)text.size();
+    stream.next_out = (Bytef*)&out[0];
+    stream.avail_out = (uInt)out.size();
+    int status = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return status == Z_STREAM_END;
+#else
+    out.clear();
+    (void)text;
+    return false;
+#endif
+}
+
+// Create the files, write their headers and start the writer thread, which stops after
+// numBlocks blocks; headers are written as given, compressed already if the file is
+bool AsyncWriterBS::open(const vector<string>& fileNames, const vector<string>& headers, uint64_t numBlocks,
+    long long numRows, const AsyncWriterOptions& options) {
+    if (m_thread.joinable() || !m_shards.empty()) {
+        m_error = "the writer is already open";
+        return false;
+    }
+    if (fileNames.empty() || headers.size() != fileNames.size()) {
+        m_error = "one header is needed per output file";
+        return false;
+    }
+    m_options = options;
+    m_options.queueDepth = max<size_t>(2, options.queueDepth);
+    m_options.writeBytes = max<size_t>(1, (options.writeBytes + directAlignment - 1) / directAlignment) * directAlignment;
+    m_numBlocks = numBlocks;
+    m_numRows = numRows;
+    m_failed = false;
+    m_abort = false;
+    m_bytesWritten = 0;
+
+    m_shards.resize(fileNames.size());
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+        Shard& shard = m_shards[i];
+#ifdef BSDL_POSIX_IO
+        int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+        // File systems without direct I/O (tmpfs among them) refuse it, the file is then
+        // written through the page cache
+        if (m_options.directIO) {
+            shard.fd = ::open(fileNames[i].c_str(), flags | O_DIRECT, 0644);
+            shard.direct = shard.fd >= 0;
+        }
+#endif
+        if (shard.fd < 0) shard.fd = ::open(fileNames[i].c_str(), flags, 0644);
+        bool opened = shard.fd >= 0;
+#else
+        shard.file = fopen(fileNames[i].c_str(), "wb");
+        bool opened = shard.file != nullptr;
+#endif
+        if (!opened) {
+            m_error = "cannot create " + fileNames[i];
+            for (Shard& created : m_shards) closeShard(created);
+            m_shards.clear();
+            return false;
+        }
+        shard.storage.assign(m_options.writeBytes + directAlignment, 0);
+        uintptr_t address = (uintptr_t)shard.storage.data();
+        shard.staging = shard.storage.data() + (directAlignment - address % directAlignment) % directAlignment;
+        if (!append(shard, headers[i].data(), headers[i].size())) {
+            m_error = "cannot write " + fileNames[i];
+            for (Shard& created : m_shards) closeShard(created);
+            m_shards.clear();
+            return false;
+        }
+    }
+
+    m_slots.reset(new Slot[m_options.queueDepth]);
+    for (size_t k = 0; k < m_options.queueDepth; ++k) {
+        m_slots[k].state.store(k, memory_order_relaxed);
+        m_slots[k].shard = 0;
+        m_slots[k].rows = 0;
+    }
+    m_thread = thread(&AsyncWriterBS::writerLoop, this);
+    return true;
+}
+
+// The empty buffer of block sequence, waiting while the writer still holds the slot;
+// every sequence below the number of blocks is acquired and published exactly once
+string& AsyncWriterBS::acquire(uint64_t sequence, int worker) {
+    Slot& slot = m_slots[sequence % m_options.queueDepth];
+    {
+        BSDL_PROFILE_SCOPE(STAGE_WAIT, worker);
+        waitFor(slot.state, sequence);
+    }
+    slot.data.clear();
+    return slot.data;
+}
+
+// Hand the filled buffer of block sequence to the writer, for the file of index shard
+void AsyncWriterBS::publish(uint64_t sequence, int shard, long long rows) {
+    Slot& slot = m_slots[sequence % m_options.queueDepth];
+    slot.shard = min(max(shard, 0), (int)m_shards.size() - 1);
+    slot.rows = rows;
+    slot.state.store(sequence + 1, memory_order_release);
+}
+
+// Wait for the writer to take every block, then flush and close the files
+bool AsyncWriterBS::close() {
+    if (m_thread.joinable()) m_thread.join();
+    bool closed = true;
+    for (Shard& shard : m_shards) {
+        if (!m_failed && !flush(shard, true)) {
+            m_error = "cannot write the end of an output file";
+            m_failed = true;
+        }
+        closed = closeShard(shard) && closed;
+    }
+    m_shards.clear();
+    m_slots.reset();
+    if (!closed && m_error.empty()) m_error = "cannot close an output file";
+    return closed && !m_failed;
+}
+
+// Writer thread: blocks in sequence, each to its file, the slot then goes back to the
+// producers for the sequence queueDepth further on
+void AsyncWriterBS::writerLoop() {
+    long long rowsDone = 0;
+    for (uint64_t sequence = 0; sequence < m_numBlocks; ++sequence) {
+        Slot& slot = m_slots[sequence % m_options.queueDepth];
+        {
+            BSDL_PROFILE_SCOPE(STAGE_WAIT, ProfilerBS::ioWorker);
+            if (!waitFor(slot.state, sequence + 1)) return;
+        }
+        if (!m_failed) {
+            BSDL_PROFILE_SCOPE(STAGE_WRITE, ProfilerBS::ioWorker);
+            if (!append(m_shards[slot.shard], slot.data.data(), slot.data.size())) {
+                m_error = "cannot write an output file";
+                m_failed = true;
+            }
+            rowsDone += slot.rows;
+            BSDL_PROFILE_COUNT(STAGE_WRITE, ProfilerBS::ioWorker, slot.rows, (long long)slot.data.size());
+            BSDL_PROFILE_PROGRESS(rowsDone, m_numRows, (long long)m_bytesWritten);
+        }
+        slot.state.store(sequence + m_options.queueDepth, memory_order_release);
+    }
+}
+
+// Until the state reaches value: a few yields, then sleeps doubling from 10 microseconds
+// so an idle waiter leaves the core to the workers; false when the writer is being destroyed
+bool AsyncWriterBS::waitFor(const atomic<uint64_t>& state, uint64_t value) {
+    long long sleep = 10;
+    for (int poll = 0; state.load(memory_order_acquire) != value; ++poll) {
+        if (m_abort.load(memory_order_relaxed)) return false;
+        if (poll < spinPolls) this_thread::yield();
+        else {
+            this_thread::sleep_for(chrono::microseconds(sleep));
+            sleep = min(2 * sleep, maxSleepMicroseconds);
+        }
+    }
+    return true;
+}
+
+// Copy into the staging buffer, writing it each time it fills; without O_DIRECT data of
+// a whole write or more skips the copy
+bool AsyncWriterBS::append(Shard& shard, const char* data, size_t size) {
+    shard.bytes += size;
+    m_bytesWritten += size;
+    while (size > 0) {
+        size_t piece = m_options.writeBytes;
+        if (!shard.direct && shard.used == 0 && size >= piece) {
+#ifdef BSDL_POSIX_IO
+            if (!writeAll(shard.fd, data, piece)) return false;
+#else
+            if (fwrite(data, 1, piece, shard.file) != piece) return false;
+#endif
+        }
+        else {
+            piece = min(size, m_options.writeBytes - shard.used);
+            memcpy(shard.staging + shard.used, data, piece);
+            shard.used += piece;
+            if (shard.used == m_options.writeBytes && !flush(shard, false)) return false;
+        }
+        data += piece;
+        size -= piece;
+    }
+    return true;
+}
+
+// Write the staging buffer; the last O_DIRECT write is padded to the alignment and the
+// file cut back to its size
+bool AsyncWriterBS::flush(Shard& shard, bool last) {
+    if (shard.used == 0) return true;
+    size_t size = shard.used;
+    if (shard.direct && last) {
+        size = (size + directAlignment - 1) / directAlignment * directAlignment;
+        memset(shard.staging + shard.used, 0, size - shard.used);
+    }
+    shard.used = 0;
+#ifdef BSDL_POSIX_IO
+    if (!writeAll(shard.fd, shard.staging, size)) return false;
+    if (shard.direct && last && ftruncate(shard.fd, (off_t)shard.bytes) != 0) return false;
+    return true;
+#else
+    return fwrite(shard.staging, 1, size, shard.file) == size;
+#endif
+}
+
+bool AsyncWriterBS::closeShard(Shard& shard) {
+    bool closed = true;
+#ifdef BSDL_POSIX_IO
+    if (shard.fd >= 0) closed = ::close(shard.fd) == 0;
+    shard.fd = -1;
+#else
+    if (shard.file) closed = fclose(shard.file) == 0;
+    shard.file = nullptr;
+#endif
+    return closed;
+}
+
+//destructors
+AsyncWriterBS::~AsyncWriterBS() {
+    m_abort = true;
+    if (m_thread.joinable()) m_thread.join();
+    for (Shard& shard : m_shards) closeShard(shard);
+}
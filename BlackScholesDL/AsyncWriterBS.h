@@ -0,0 +1,131 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	AsyncWriterBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the AsyncWriterBS Class, a dedicated writer thread fed
+*					by the pricing threads, so pricing and file I/O overlap instead of
+*					taking turns.
+*
+*					Queue     : a bounded ring of queueDepth preallocated buffers. Block s
+*					            uses slot s % queueDepth, producers fill their blocks in any
+*					            order and the writer takes them in sequence; a slot state
+*					            counter (acquire/release atomics, no locks) hands each slot
+*					            from producer to writer and back, its buffer keeping its
+*					            capacity from one block to the next. At least 2 slots are
+*					            used, so a producer can fill one while the other is written.
+*					Writes    : blocks are gathered per shard into an aligned staging
+*					            buffer written in writeBytes pieces, optionally with
+*					            O_DIRECT (Linux) to bypass the page cache.
+*					Shards    : each block names its output file, every file starts with
+*					            its own header.
+*					Gzip      : with BSDL_ZLIB the producers compress their blocks, each one
+*					            an independent gzip member, so compression runs on every
+*					            thread and the concatenated file is still one gzip stream.
+*
+* References	:	- D. Vyukov, Bounded MPMC queue, 1024cores.net, 2011
+*					- P. Deutsch, GZIP file format specification, RFC 1952, 1996
+* Other files	:	EurDataSetBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Pipeline settings
+struct AsyncWriterOptions {
+    size_t queueDepth = 16;         // Buffers in flight, at least 2, producers wait when all are taken
+    size_t writeBytes = 1 << 22;    // Bytes per write call, a multiple of directAlignment
+    bool directIO = false;          // O_DIRECT where the platform and file system allow it
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class AsyncWriterBS
+{
+    public:
+
+        //constructors
+        AsyncWriterBS();
+
+        //accessors
+        uint64_t getBytesWritten() const;
+        bool isDirect() const;
+        string getError() const;
+
+        // Public Member functions
+        bool open(const vector<string>& fileNames, const vector<string>& headers, uint64_t numBlocks,
+            long long numRows, const AsyncWriterOptions& options);
+        string& acquire(uint64_t sequence, int worker);
+        void publish(uint64_t sequence, int shard, long long rows);
+        bool close();
+        static bool compress(const string& text, string& out);
+        static bool isCompressionAvailable();
+
+        // Alignment of O_DIRECT buffers, sizes and offsets
+        static const size_t directAlignment = 4096;
+
+        //destructors
+        ~AsyncWriterBS();
+
+    private:
+
+        // One buffer of the ring, state is the sequence it waits for: s when free for
+        // block s, s + 1 once block s is published
+        struct Slot {
+            atomic<uint64_t> state;
+            int shard;
+            long long rows;
+            string data;
+        };
+
+        // An output file and its staging buffer
+        struct Shard {
+            int fd = -1;
+            FILE* file = nullptr;
+            vector<char> storage;
+            char* staging = nullptr;
+            size_t used = 0;
+            uint64_t bytes = 0;
+            bool direct = false;
+        };
+
+        // private Member functions
+        void writerLoop();
+        bool append(Shard& shard, const char* data, size_t size);
+        bool flush(Shard& shard, bool last);
+        bool closeShard(Shard& shard);
+        bool waitFor(const atomic<uint64_t>& state, uint64_t value);
+
+        // private  Member variables
+        AsyncWriterOptions m_options;   // Settings of the open pipeline
+        unique_ptr<Slot[]> m_slots;     // Ring of m_options.queueDepth buffers
+        vector<Shard> m_shards;         // Output files
+        uint64_t m_numBlocks;           // Blocks the writer waits for before stopping
+        long long m_numRows;            // Rows of every block, for the progress lines
+        thread m_thread;                // Writer thread
+        atomic<bool> m_failed;          // A write failed, later blocks are discarded
+        atomic<bool> m_abort;           // Destroyed while open, the writer stops waiting
+        uint64_t m_bytesWritten;        // Bytes in the files, headers included
+        string m_error;                 // Reason of the last failure
+};
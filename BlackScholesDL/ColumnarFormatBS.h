@@ -0,0 +1,63 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ColumnarFormatBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	On disk layout of the binary columnar dataset files (.bsdl).
+*
+*					offset 0    : ColumnarHeader, little endian
+*					offset 72   : numColumns ColumnarEntry records
+*					offset 4096 : column data, each column holds numRows contiguous
+*					              float64 or float32 values and starts on a 64 byte
+*					              boundary, so the file can be memory mapped as is.
+* References	:
+* Other files	:	ColumnarWriterBS.h, ColumnarReaderBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstdint>
+
+// File signature and version of the layout
+static const char columnarMagic[8] = { 'B', 'S', 'D', 'L', 'C', 'O', 'L', '1' };
+static const uint32_t columnarVersion = 1;
+
+// Size of the header region and alignment of every column
+static const uint64_t columnarDataOffset = 4096;
+static const uint64_t columnarAlignment = 64;
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Fixed header with the simulation parameters of the dataset
+struct ColumnarHeader {
+    char magic[8];              // columnarMagic
+    uint32_t version;           // columnarVersion
+    uint32_t elementBytes;      // 8 for float64 columns, 4 for float32 columns
+    uint64_t numRows;           // Values per column
+    uint32_t numColumns;        // Entries in the column table
+    uint32_t reserved;          // Zero
+    uint64_t seed;              // Seed of the random stream, 0 when not generated
+    double tMax;                // Simulation parameters, 0 when not generated
+    double pMax;
+    double sigmaMax;
+    double rMax;
+};
+
+// Column table entry, the name is zero padded
+struct ColumnarEntry {
+    char name[24];
+    uint64_t offset;            // Byte offset of the first value from the start of the file
+};
+
+// Maximum number of columns that fit in the header region
+static const uint32_t columnarMaxColumns = (uint32_t)((columnarDataOffset - sizeof(ColumnarHeader)) / sizeof(ColumnarEntry));
+
+static_assert(sizeof(ColumnarHeader) == 72, "ColumnarHeader must be packed to 72 bytes");
+static_assert(sizeof(ColumnarEntry) == 32, "ColumnarEntry must be packed to 32 bytes");
@@ -0,0 +1,144 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ColumnarReaderBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the ColumnarReaderBS Class
+*
+* References	:
+* Other files	:	ColumnarFormatBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <cstring>
+#include "ColumnarReaderBS.h"
+
+#if defined _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+ColumnarReaderBS::ColumnarReaderBS() : m_data(nullptr), m_size(0), m_header(nullptr), m_entries(nullptr),
+    m_fileHandle(nullptr), m_mapHandle(nullptr) {}
+
+//accessors
+const ColumnarHeader& ColumnarReaderBS::getHeader() { return *m_header; }
+uint64_t ColumnarReaderBS::getNumRows() { return m_header ? m_header->numRows : 0; }
+uint32_t ColumnarReaderBS::getNumColumns() { return m_header ? m_header->numColumns : 0; }
+
+string ColumnarReaderBS::getColumnName(uint32_t column) {
+    if (column >= getNumColumns()) return "";
+    const char* name = m_entries[column].name;
+    return string(name, strnlen(name, sizeof(m_entries[column].name)));
+}
+
+// Map the whole file read only and validate its header and column table
+bool ColumnarReaderBS::open(const string& fileName) {
+    close();
+#if defined _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { CloseHandle(file); return false; }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { CloseHandle(file); return false; }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+    m_fileHandle = file;
+    m_mapHandle = mapping;
+    m_size = (size_t)size.QuadPart;
+#else
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) { ::close(fd); return false; }
+    void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    madvise(view, (size_t)info.st_size, MADV_SEQUENTIAL);
+    m_size = (size_t)info.st_size;
+#endif
+    m_data = (const unsigned char*)view;
+
+    // Validate before exposing any pointer into the mapping
+    m_header = (const ColumnarHeader*)m_data;
+    m_entries = (const ColumnarEntry*)(m_data + sizeof(ColumnarHeader));
+    bool valid = m_size >= columnarDataOffset && memcmp(m_header->magic, columnarMagic, sizeof(columnarMagic)) == 0
+        && m_header->version == columnarVersion && (m_header->elementBytes == 8 || m_header->elementBytes == 4)
+        && m_header->numColumns <= columnarMaxColumns;
+    // Columns start after the header and column table and fit in the file; the row count
+    // is checked by division so a crafted header cannot overflow the column size
+    for (uint32_t c = 0; valid && c < m_header->numColumns; ++c) {
+        uint64_t offset = m_entries[c].offset;
+        valid = offset % columnarAlignment == 0 && offset >= columnarDataOffset && offset <= m_size
+            && m_header->numRows <= (m_size - offset) / m_header->elementBytes;
+    }
+    if (!valid) close();
+    return valid;
+}
+
+// Release the mapping, pointers returned before become invalid
+void ColumnarReaderBS::close() {
+    if (m_data) {
+#if defined _WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle((HANDLE)m_mapHandle);
+        CloseHandle((HANDLE)m_fileHandle);
+#else
+        munmap((void*)m_data, m_size);
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_entries = nullptr;
+    m_fileHandle = nullptr;
+    m_mapHandle = nullptr;
+}
+
+// Index of a column by name, -1 when absent
+int ColumnarReaderBS::findColumn(const string& name) {
+    for (uint32_t c = 0; c < getNumColumns(); ++c) {
+        if (getColumnName(c) == name) return (int)c;
+    }
+    return -1;
+}
+
+// Zero-copy view of a float64 column, null for float32 files or a bad index
+const double* ColumnarReaderBS::columnFloat64(uint32_t column) {
+    if (column >= getNumColumns() || m_header->elementBytes != 8) return nullptr;
+    return (const double*)(m_data + m_entries[column].offset);
+}
+
+// Zero-copy view of a float32 column, null for float64 files or a bad index
+const float* ColumnarReaderBS::columnFloat32(uint32_t column) {
+    if (column >= getNumColumns() || m_header->elementBytes != 4) return nullptr;
+    return (const float*)(m_data + m_entries[column].offset);
+}
+
+// One value of either element type
+double ColumnarReaderBS::value(uint32_t column, uint64_t row) {
+    if (m_header->elementBytes == 8) return columnFloat64(column)[row];
+    return columnFloat32(column)[row];
+}
+
+//Default destructor
+ColumnarReaderBS::~ColumnarReaderBS() { close(); }
@@ -0,0 +1,65 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ColumnarReaderBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the ColumnarReaderBS Class, memory maps a binary
+*					columnar dataset file and exposes its columns without copying.
+*
+* References	:
+* Other files	:	ColumnarFormatBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <string>
+#include "ColumnarFormatBS.h"
+
+using namespace std;
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class ColumnarReaderBS
+{
+    public:
+
+        //constructors
+        ColumnarReaderBS();
+        ColumnarReaderBS(const ColumnarReaderBS&) = delete;
+        ColumnarReaderBS& operator=(const ColumnarReaderBS&) = delete;
+
+        //accessors
+        const ColumnarHeader& getHeader();
+        uint64_t getNumRows();
+        uint32_t getNumColumns();
+        string getColumnName(uint32_t column);
+
+        // Public Member functions
+        bool open(const string& fileName);
+        void close();
+        int findColumn(const string& name);
+        const double* columnFloat64(uint32_t column);
+        const float* columnFloat32(uint32_t column);
+        double value(uint32_t column, uint64_t row);
+
+        //destructors
+        ~ColumnarReaderBS();
+
+    private:
+
+        // private  Member variables
+        const unsigned char* m_data;    // Start of the mapped file
+        size_t m_size;                  // Mapped bytes
+        const ColumnarHeader* m_header; // Header inside the mapping
+        const ColumnarEntry* m_entries; // Column table inside the mapping
+        void* m_fileHandle;             // Platform handles of the mapping
+        void* m_mapHandle;
+};
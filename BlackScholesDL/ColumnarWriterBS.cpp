@@ -0,0 +1,97 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ColumnarWriterBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the ColumnarWriterBS Class
+*
+* References	:
+* Other files	:	ColumnarFormatBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include "ColumnarWriterBS.h"
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+ColumnarWriterBS::ColumnarWriterBS() : m_header() {}
+
+// Create the file, write the header and the column table and reserve the data region.
+// params supplies seed, tMax, pMax, sigmaMax and rMax, the other fields are filled here.
+bool ColumnarWriterBS::open(const string& fileName, const vector<string>& columns, uint64_t numRows,
+    uint32_t elementBytes, const ColumnarHeader& params) {
+    if (columns.empty() || columns.size() > columnarMaxColumns) return false;
+    if (elementBytes != 8 && elementBytes != 4) return false;
+
+    m_header = params;
+    memcpy(m_header.magic, columnarMagic, sizeof(columnarMagic));
+    m_header.version = columnarVersion;
+    m_header.elementBytes = elementBytes;
+    m_header.numRows = numRows;
+    m_header.numColumns = (uint32_t)columns.size();
+    m_header.reserved = 0;
+
+    // Lay the columns out one after the other, each on an aligned boundary
+    vector<ColumnarEntry> entries(columns.size());
+    m_offsets.assign(columns.size(), 0);
+    uint64_t offset = columnarDataOffset;
+    uint64_t columnBytes = numRows * elementBytes;
+    for (size_t c = 0; c < columns.size(); ++c) {
+        memset(&entries[c], 0, sizeof(ColumnarEntry));
+        memcpy(entries[c].name, columns[c].data(), min(columns[c].size(), sizeof(entries[c].name) - 1));
+        entries[c].offset = offset;
+        m_offsets[c] = offset;
+        offset += (columnBytes + columnarAlignment - 1) / columnarAlignment * columnarAlignment;
+    }
+
+    m_file.open(fileName, ios::binary | ios::trunc);
+    if (!m_file.is_open()) return false;
+    m_file.write((const char*)&m_header, sizeof(m_header));
+    m_file.write((const char*)entries.data(), entries.size() * sizeof(ColumnarEntry));
+
+    // Extend the file to its final size so blocks can land in any order
+    m_file.seekp((streamoff)(offset - 1));
+    m_file.put('\0');
+    return m_file.good();
+}
+
+// Copy rows [firstRow, firstRow + count) of every column to its place in the file
+bool ColumnarWriterBS::writeColumns(uint64_t firstRow, uint64_t count, const void* const* columns, uint32_t elementBytes) {
+    if (!m_file.is_open() || elementBytes != m_header.elementBytes) return false;
+    if (firstRow + count > m_header.numRows) return false;
+    for (size_t c = 0; c < m_offsets.size(); ++c) {
+        m_file.seekp((streamoff)(m_offsets[c] + firstRow * elementBytes));
+        m_file.write((const char*)columns[c], (streamsize)(count * elementBytes));
+    }
+    return m_file.good();
+}
+
+bool ColumnarWriterBS::writeRows(uint64_t firstRow, uint64_t count, const double* const* columns) {
+    return writeColumns(firstRow, count, (const void* const*)columns, 8);
+}
+
+bool ColumnarWriterBS::writeRows(uint64_t firstRow, uint64_t count, const float* const* columns) {
+    return writeColumns(firstRow, count, (const void* const*)columns, 4);
+}
+
+// Flush and close, returns false if any write failed
+bool ColumnarWriterBS::close() {
+    if (!m_file.is_open()) return false;
+    m_file.close();
+    return !m_file.fail();
+}
+
+//Default destructor
+ColumnarWriterBS::~ColumnarWriterBS() {
+    if (m_file.is_open()) m_file.close();
+}
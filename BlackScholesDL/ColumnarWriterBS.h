@@ -0,0 +1,56 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ColumnarWriterBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the ColumnarWriterBS Class, writes binary columnar
+*					dataset files block by block.
+*
+* References	:
+* Other files	:	ColumnarFormatBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ColumnarFormatBS.h"
+
+using namespace std;
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class ColumnarWriterBS
+{
+    public:
+
+        //constructors
+        ColumnarWriterBS();
+
+        // Public Member functions
+        bool open(const string& fileName, const vector<string>& columns, uint64_t numRows,
+            uint32_t elementBytes, const ColumnarHeader& params);
+        bool writeRows(uint64_t firstRow, uint64_t count, const double* const* columns);
+        bool writeRows(uint64_t firstRow, uint64_t count, const float* const* columns);
+        bool close();
+
+        //destructors
+        ~ColumnarWriterBS();
+
+    private:
+
+        bool writeColumns(uint64_t firstRow, uint64_t count, const void* const* columns, uint32_t elementBytes);
+
+        // private  Member variables
+        ofstream m_file;                // Output file
+        ColumnarHeader m_header;        // Header written by open
+        vector<uint64_t> m_offsets;     // Byte offset of every column
+};
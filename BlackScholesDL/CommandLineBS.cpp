@@ -0,0 +1,708 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	CommandLineBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the CommandLineBS Class
+*
+* References	:
+* Other files	:	EurBatchBS.cpp, EurDataSetBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "CommandLineBS.h"
+#include "EurBatchBS.h"
+#include "EurDataSetBS.h"
+#include "EurGreeksBS.h"
+#include "EurCallBS.h"
+#include "EurSimdBS.h"
+#include "FiniteDifferenceBS.h"
+#include "ImpliedVolBS.h"
+#include "MlpPricerBS.h"
+#include "MonteCarloBS.h"
+#include "NormalCDFBS.h"
+#include "PortfolioPricerBS.h"
+#include "PriceGridBS.h"
+#include "ProfilerBS.h"
+#include "ScenarioEngineBS.h"
+#include "SobolBS.h"
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Parametrized constructor
+CommandLineBS::CommandLineBS(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) m_args.push_back(argv[i]);
+}
+
+void CommandLineBS::printUsage(ostream& out) {
+    out << "Usage: BlackScholesDL [command] [--option value ...]" << endl << endl;
+    out << "Without a command the interactive menu is shown." << endl << endl;
+    out << "Commands:" << endl;
+    out << "  price      --T --K --S0 --sigma --r [--grid file]" << endl;
+    out << "             Price a european call and put, prints type,price,delta,gamma,theta" << endl;
+    out << "             --grid interpolates in a grid written by the grid command" << endl;
+    out << "  generate   --n [--tmax 2] [--pmax 500] [--sigmamax 1] [--rmax 0.1] [--seed 1]" << endl;
+    out << "             [--threads 0] [--out BSdataSet.csv] [--format csv|bin64|bin32]" << endl;
+    out << "             [--sampling uniform|sobol|halton|latin] [--space inputs|moneyness] [--mmax 1]" << endl;
+    out << "             [--focus 0] [--focusm 0.1] [--focusvar 0.04] [--shards 1] [--direct 0] [--profile 0]" << endl;
+    out << "             Generate a dataset, --threads 0 uses every hardware thread" << endl;
+    out << "             CSV files: --shards splits the rows in numbered files, --direct 1 writes with" << endl;
+    out << "             O_DIRECT where supported and an --out name ending in .gz is gzipped" << endl;
+    out << "             --space moneyness draws ln(S0/K) in [-mmax, mmax] and sigma^2 T, a --focus" << endl;
+    out << "             share of each inside |ln(S0/K)| <= focusm and sigma^2 T <= focusvar" << endl;
+    out << "             --profile 1 prints stage timings and progress lines, 2 also per worker" << endl;
+    out << "  benchmark  --n [same options as generate]" << endl;
+    out << "             Print generator rows/sec from 1 to --threads threads as CSV" << endl;
+    out << "  reprice    --in --out [--chunk 1048576] [--threads 0] [--profile 0]" << endl;
+    out << "             Stream a portfolio file (CSV T,K,S0,sigma,r,type or .bsdl) through" << endl;
+    out << "             the batch pricer into a CSV or .bsdl file of price,delta,gamma,theta" << endl;
+    out << "  implied    --price --T --K --S0 --r [--type call|put]" << endl;
+    out << "             Implied volatility of a quoted price, prints type,sigma,vega,iterations,status" << endl;
+    out << "  grid       --out [--method linear|cubic] [--fmin 0.5] [--fmax 2] [--varmin 0.0025]" << endl;
+    out << "             [--varmax 2.25] [--nf 257] [--nvar 129] [--tolerance 0] [--maxnodes 4194304]" << endl;
+    out << "             Build a price and Greeks lookup grid, grown until the price / K error is" << endl;
+    out << "             below --tolerance when given, prints nodes,bytes and the measured errors" << endl;
+    out << "  greeks     --T --K --S0 --sigma --r [--method ad|bump]" << endl;
+    out << "             First and second order Greeks of a european call and put, prints" << endl;
+    out << "             type,price,delta,gamma,vega,rho,theta,vanna,volga,charm" << endl;
+    out << "  cdf        Measure every normal CDF backend, prints backend,max_error,ns_per_call" << endl;
+    out << "  montecarlo --T --K --S0 --sigma --r [--type call|put] [--paths 1048576] [--steps 1]" << endl;
+    out << "             [--sampler pseudo|sobol] [--antithetic 0|1] [--control 0|1] [--replicates 16]" << endl;
+    out << "             [--seed 1] [--threads 0] [--scaling 0|1]" << endl;
+    out << "             Monte Carlo price against the closed form, prints type,price,std_error," << endl;
+    out << "             bs_price,error,paths,seconds,paths_per_sec,convergence_per_sec" << endl;
+    out << "             --scaling 1 prints paths/sec from 1 to --threads threads instead" << endl;
+    out << "  pde        --T --K --S0 --sigma --r [--type put|call] [--exercise european|american]" << endl;
+    out << "             [--method penalty|psor] [--nspace 400] [--ntime 200] [--smax 4] [--surface file]" << endl;
+    out << "             Crank-Nicolson price against the closed form, prints type,exercise,price," << endl;
+    out << "             delta,gamma,theta,bs_price,iterations, --surface writes S,price,delta,gamma" << endl;
+    out << "  mlp        --model --n [--tmax 2] [--pmax 500] [--sigmamax 1] [--rmax 0.1] [--seed 1]" << endl;
+    out << "             [--threads 0] [--sampling uniform|sobol|halton|latin] [--save file]" << endl;
+    out << "             Price --n sampled inputs with a trained network (JSON or binary) and with the" << endl;
+    out << "             closed form call, prints rows,mae,rmse,max_error,mlp_rows_per_sec,bs_rows_per_sec" << endl;
+    out << "             --save writes the model in the binary layout" << endl;
+    out << "  scenario   --in [--out file] [--spotmin -0.25] [--spotmax 0.25] [--nspot 51] [--volmin -0.1]" << endl;
+    out << "             [--volmax 0.1] [--nvol 51] [--threads 0]" << endl;
+    out << "             Reprice a portfolio (CSV T,K,S0,sigma,r,type[,quantity]) under every relative spot" << endl;
+    out << "             shock and absolute vol shock of a grid, prints spot_shock,vol_shock,value,pnl," << endl;
+    out << "             delta,gamma,vega,theta of the whole portfolio per scenario to --out or stdout" << endl;
+    out << "  help       Show this message" << endl << endl;
+    out << "price, generate, benchmark, reprice, greeks, montecarlo, pde and mlp accept" << endl;
+    out << "--cdf fast|as|erfc|west, the normal CDF backend (default as, Abramowitz-Stegun)" << endl << endl;
+    out << "Exit codes: 0 success, 1 runtime failure, 2 invalid command line" << endl;
+}
+
+// Dispatch to the subcommand; an exception escaping it (threads or memory that cannot be
+// obtained) is reported as a runtime failure instead of aborting
+int CommandLineBS::run() {
+    try {
+        return dispatch();
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return EXIT_CODE_FAILURE;
+    }
+}
+
+int CommandLineBS::dispatch() {
+    if (m_args.empty() || m_args[0] == "help" || m_args[0] == "--help" || m_args[0] == "-h") {
+        printUsage(cout);
+        return EXIT_CODE_OK;
+    }
+    const string& command = m_args[0];
+    if (command == "price") return runPrice();
+    if (command == "generate") return runGenerate();
+    if (command == "benchmark") return runBenchmark();
+    if (command == "reprice") return runReprice();
+    if (command == "implied") return runImplied();
+    if (command == "grid") return runGrid();
+    if (command == "greeks") return runGreeks();
+    if (command == "cdf") return runCdf();
+    if (command == "montecarlo") return runMonteCarlo();
+    if (command == "pde") return runPde();
+    if (command == "mlp") return runMlp();
+    if (command == "scenario") return runScenario();
+    cerr << "Unknown command: " << command << endl << endl;
+    printUsage(cerr);
+    return EXIT_CODE_USAGE;
+}
+
+// Collect "--name value" pairs, rejecting names outside allowed and missing values
+bool CommandLineBS::parseOptions(const set<string>& allowed) {
+    m_options.clear();
+    for (size_t i = 1; i < m_args.size(); i += 2) {
+        const string& arg = m_args[i];
+        if (arg.size() < 3 || arg.compare(0, 2, "--") != 0) {
+            m_error = "Expected an option, got: " + arg;
+            return false;
+        }
+        string name = arg.substr(2);
+        if (!allowed.count(name)) {
+            m_error = "Unknown option: " + arg;
+            return false;
+        }
+        if (i + 1 >= m_args.size()) {
+            m_error = "Missing value for: " + arg;
+            return false;
+        }
+        m_options[name] = m_args[i + 1];
+    }
+    return true;
+}
+
+// Read an option as a number, false when present but malformed, out of range or not finite
+// (strtod accepts nan and inf); absent leaves value as is
+bool CommandLineBS::getDouble(const string& name, double& value) {
+    auto it = m_options.find(name);
+    if (it == m_options.end()) return true;
+    char* end = nullptr;
+    errno = 0;
+    double parsed = strtod(it->second.c_str(), &end);
+    if (it->second.empty() || *end != '\0' || errno == ERANGE || !isfinite(parsed)) {
+        m_error = "Invalid number for --" + name + ": " + it->second;
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool CommandLineBS::getInteger(const string& name, long long& value) {
+    auto it = m_options.find(name);
+    if (it == m_options.end()) return true;
+    char* end = nullptr;
+    errno = 0;
+    long long parsed = strtoll(it->second.c_str(), &end, 10);
+    if (it->second.empty() || *end != '\0' || errno == ERANGE) {
+        m_error = "Invalid integer for --" + name + ": " + it->second;
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool CommandLineBS::getUnsigned(const string& name, uint64_t& value) {
+    auto it = m_options.find(name);
+    if (it == m_options.end()) return true;
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = strtoull(it->second.c_str(), &end, 10);
+    if (it->second.empty() || it->second[0] == '-' || *end != '\0' || errno == ERANGE) {
+        m_error = "Invalid unsigned integer for --" + name + ": " + it->second;
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool CommandLineBS::getString(const string& name, string& value) {
+    auto it = m_options.find(name);
+    if (it != m_options.end()) value = it->second;
+    return true;
+}
+
+// Dataset options shared by generate and benchmark
+bool CommandLineBS::getDataSetParams(DataSetParams& params) {
+    long long threads = 0, shards = 1, direct = 0;
+    params.seed = 1;
+    string format = "csv", sampling = "uniform", space = "inputs";
+    bool ok = getInteger("n", params.numSamples) && getDouble("tmax", params.tMax) && getDouble("pmax", params.pMax)
+        && getDouble("sigmamax", params.sigmaMax) && getDouble("rmax", params.rMax) && getUnsigned("seed", params.seed)
+        && getInteger("threads", threads) && getString("out", params.fileName) && getString("format", format)
+        && getString("sampling", sampling) && getString("space", space) && getDouble("mmax", params.moneynessMax)
+        && getDouble("focus", params.focusWeight) && getDouble("focusm", params.focusMoneyness) && getDouble("focusvar", params.focusVariance)
+        && getInteger("shards", shards) && getInteger("direct", direct);
+    if (!ok) return false;
+    if (m_options.find("n") == m_options.end() || !(params.numSamples > 0)) {
+        m_error = "--n must be a positive number of samples";
+        return false;
+    }
+    if (!(params.tMax > EurDataSetBS::nMin && params.pMax > EurDataSetBS::nMin && params.sigmaMax > EurDataSetBS::nMin
+        && params.rMax > EurDataSetBS::nMin && threads >= 0 && threads <= maxThreads)) {
+        m_error = "Maximums must be above 0.00000001 and --threads between 0 and " + to_string(maxThreads);
+        return false;
+    }
+    if (format == "csv") params.format = FORMAT_CSV;
+    else if (format == "bin64") params.format = FORMAT_FLOAT64;
+    else if (format == "bin32") params.format = FORMAT_FLOAT32;
+    else {
+        m_error = "Unknown format: " + format;
+        return false;
+    }
+    if (params.format != FORMAT_CSV && m_options.find("out") == m_options.end()) params.fileName = "BSdataSet.bsdl";
+    if (!SamplerBS::parseSampling(sampling, params.sampling)) {
+        m_error = "Unknown sampling: " + sampling + ", expected uniform, sobol, halton or latin";
+        return false;
+    }
+    if (params.sampling == SAMPLING_SOBOL && !(params.numSamples <= (long long)SobolBS::maxPoints)) {
+        m_error = "--sampling sobol takes at most " + to_string(SobolBS::maxPoints) + " samples";
+        return false;
+    }
+    if (space == "inputs") params.space = SPACE_INPUTS;
+    else if (space == "moneyness") params.space = SPACE_MONEYNESS;
+    else {
+        m_error = "Unknown space: " + space + ", expected inputs or moneyness";
+        return false;
+    }
+    if (!(params.moneynessMax > 0 && params.focusWeight >= 0 && params.focusWeight <= 1
+        && params.focusMoneyness > 0 && params.focusVariance > 0)) {
+        m_error = "--mmax, --focusm and --focusvar must be positive and --focus in [0, 1]";
+        return false;
+    }
+    if (!(shards >= 1 && shards <= EurDataSetBS::maxShards && (direct == 0 || direct == 1))) {
+        m_error = "--shards must be between 1 and " + to_string(EurDataSetBS::maxShards) + " and --direct 0 or 1";
+        return false;
+    }
+    params.numThreads = (int)threads;
+    params.numShards = (int)shards;
+    params.directIO = direct == 1;
+    return true;
+}
+
+// price: one call and one put from the fused evaluator, or from a lookup grid
+int CommandLineBS::runPrice() {
+    double T = -1, K = -1, S0 = -1, sigma = -1, r = -1;
+    string gridFile;
+    bool ok = parseOptions({ "T", "K", "S0", "sigma", "r", "grid", "cdf" }) && getCdfBackend() && getDouble("T", T) && getDouble("K", K)
+        && getDouble("S0", S0) && getDouble("sigma", sigma) && getDouble("r", r) && getString("grid", gridFile);
+    if (ok && !(T > 0 && K > 0 && S0 > 0 && sigma > 0 && r >= 0)) {
+        m_error = "--T, --K, --S0 and --sigma must be given and positive, --r must not be negative";
+        ok = false;
+    }
+    if (!ok) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    EurBSRecord rec;
+    if (gridFile.empty()) rec = EurBatchBS::evaluate(T, K, S0, sigma, r);
+    else {
+        PriceGridBS grid;
+        if (!grid.load(gridFile)) {
+            cerr << "Unable to read the grid file " << gridFile << endl;
+            return EXIT_CODE_FAILURE;
+        }
+        if (!grid.lookup(T, K, S0, sigma, r, rec)) cerr << "Outside the grid, priced by the closed form" << endl;
+    }
+    cout << fixed << setprecision(8);
+    cout << "type,price,delta,gamma,theta" << endl;
+    cout << "call," << rec.callPrice << "," << rec.callDelta << "," << rec.gamma << "," << rec.callTheta << endl;
+    cout << "put," << rec.putPrice << "," << rec.putDelta << "," << rec.gamma << "," << rec.putTheta << endl;
+    return EXIT_CODE_OK;
+}
+
+// Select the normal CDF backend given by --cdf, the default one when absent
+bool CommandLineBS::getCdfBackend() {
+    auto it = m_options.find("cdf");
+    if (it == m_options.end()) return true;
+    CdfBackend backend;
+    if (!NormalCDFBS::parseBackend(it->second, backend)) {
+        m_error = "Unknown CDF backend: " + it->second + ", expected fast, as, erfc or west";
+        return false;
+    }
+    NormalCDFBS::setBackend(backend);
+    return true;
+}
+
+// Stage counters of generate and reprice: --profile 1 prints the summary and progress
+// lines on stderr, 2 adds the counters of every worker
+bool CommandLineBS::beginProfile() {
+    m_profile = 0;
+    if (!getInteger("profile", m_profile)) return false;
+    if (m_profile < 0 || m_profile > 2) {
+        m_error = "--profile must be 0, 1 or 2";
+        return false;
+    }
+    if (m_profile > 0 && !ProfilerBS::isEnabled()) {
+        cerr << "--profile ignored, the stage counters need a build with BSDL_PROFILE defined" << endl;
+        m_profile = 0;
+    }
+    ProfilerBS::reset();
+    ProfilerBS::setProgress(m_profile > 0 ? &cerr : nullptr, 1.0);
+    return true;
+}
+
+void CommandLineBS::endProfile(double seconds) {
+    if (m_profile > 0) ProfilerBS::report(cerr, seconds, m_profile > 1);
+    ProfilerBS::setProgress(nullptr, 1.0);
+}
+
+// generate: write a dataset file and report the throughput on stderr
+int CommandLineBS::runGenerate() {
+    DataSetParams params;
+    if (!parseOptions({ "n", "tmax", "pmax", "sigmamax", "rmax", "seed", "threads", "out", "format",
+        "sampling", "space", "mmax", "focus", "focusm", "focusvar", "shards", "direct", "cdf", "profile" })
+        || !getCdfBackend() || !getDataSetParams(params) || !beginProfile()) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    EurDataSetBS generator(params);
+    if (!generator.generate()) {
+        cerr << "Unable to write the file " << params.fileName << ": " << generator.getError() << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    cerr << "Generated " << params.numSamples << " samples into " << params.fileName << " with seed " << params.seed;
+    cerr << ", sampling: " << SamplerBS::getSamplingName(params.sampling) << (params.space == SPACE_MONEYNESS ? " in moneyness" : "");
+    cerr << ", threads: " << generator.getThreadsUsed() << ", simd: " << EurSimdBS::getLevelName()
+        << ", cdf: " << NormalCDFBS::getBackendName(NormalCDFBS::getBackend());
+    cerr << ", seconds: " << generator.getSeconds() << ", rows/sec: " << (long long)generator.getRowsPerSecond() << endl;
+    endProfile(generator.getSeconds());
+    return EXIT_CODE_OK;
+}
+
+// benchmark: generator scaling from one thread to --threads, nothing is written to disk
+int CommandLineBS::runBenchmark() {
+    DataSetParams params;
+    if (!parseOptions({ "n", "tmax", "pmax", "sigmamax", "rmax", "seed", "threads", "format",
+        "sampling", "space", "mmax", "focus", "focusm", "focusvar", "cdf" })
+        || !getCdfBackend() || !getDataSetParams(params)) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    EurDataSetBS::scalingReport(params, cout);
+    return EXIT_CODE_OK;
+}
+
+// reprice: stream a portfolio file through the batch pricer
+int CommandLineBS::runReprice() {
+    string input, output;
+    long long chunk = 1 << 20, threads = 0;
+    bool ok = parseOptions({ "in", "out", "chunk", "threads", "cdf", "profile" }) && getCdfBackend() && getString("in", input)
+        && getString("out", output) && getInteger("chunk", chunk) && getInteger("threads", threads) && beginProfile();
+    if (ok && !(!input.empty() && !output.empty() && chunk > 0 && threads >= 0 && threads <= maxThreads)) {
+        m_error = "--in and --out are required, --chunk must be positive and --threads between 0 and " + to_string(maxThreads);
+        ok = false;
+    }
+    if (!ok) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    PortfolioPricerBS pricer;
+    pricer.setChunkRows((size_t)chunk);
+    pricer.setThreads((int)threads);
+    if (!pricer.reprice(input, output)) {
+        cerr << pricer.getError() << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    cerr << "Repriced " << pricer.getPositions() << " positions into " << output << ", simd: " << EurSimdBS::getLevelName();
+    cerr << ", seconds: " << pricer.getSeconds() << ", positions/sec: " << (long long)pricer.getPositionsPerSecond() << endl;
+    endProfile(pricer.getSeconds());
+    return EXIT_CODE_OK;
+}
+
+// implied: implied volatility of one quoted price, fails when the quote has none
+int CommandLineBS::runImplied() {
+    double price = -1, T = -1, K = -1, S0 = -1, r = 0;
+    string type = "call";
+    bool ok = parseOptions({ "price", "T", "K", "S0", "r", "type" }) && getDouble("price", price) && getDouble("T", T)
+        && getDouble("K", K) && getDouble("S0", S0) && getDouble("r", r) && getString("type", type);
+    if (ok && !(price >= 0 && T > 0 && K > 0 && S0 > 0 && (type == "call" || type == "put"))) {
+        m_error = "--price, --T, --K and --S0 must be given and positive, --type must be call or put";
+        ok = false;
+    }
+    if (!ok) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    ImpliedVolBS solver;
+    ImpliedVolResult result = solver.solve(price, T, K, S0, r, type == "call");
+    const char* statusNames[] = { "ok", "not_converged", "below_intrinsic", "above_maximum", "invalid_input" };
+    double vega = isnan(result.sigma) ? result.sigma : EurCallBS(T, K).vegaByBSFormula(S0, result.sigma, r);
+    cout << fixed << setprecision(8);
+    cout << "type,sigma,vega,iterations,status" << endl;
+    cout << type << "," << result.sigma << "," << vega << ","
+        << result.iterations << "," << statusNames[result.status] << endl;
+    return result.status == IMPLIED_OK ? EXIT_CODE_OK : EXIT_CODE_FAILURE;
+}
+
+// grid: build a lookup grid, optionally to a tolerance, and save it
+int CommandLineBS::runGrid() {
+    PriceGridSpec spec;
+    string output, method = "linear";
+    double tolerance = 0;
+    long long numMoneyness = (long long)spec.numMoneyness, numVariance = (long long)spec.numVolatility, maxNodes = 1 << 22;
+    bool ok = parseOptions({ "out", "method", "fmin", "fmax", "varmin", "varmax", "nf", "nvar", "tolerance", "maxnodes" })
+        && getString("out", output) && getString("method", method) && getDouble("fmin", spec.moneynessMin)
+        && getDouble("fmax", spec.moneynessMax) && getDouble("varmin", spec.varianceMin) && getDouble("varmax", spec.varianceMax)
+        && getInteger("nf", numMoneyness) && getInteger("nvar", numVariance) && getDouble("tolerance", tolerance)
+        && getInteger("maxnodes", maxNodes);
+    if (ok && !(!output.empty() && (method == "linear" || method == "cubic") && numMoneyness >= 2 && numVariance >= 2
+        && tolerance >= 0 && maxNodes > 0)) {
+        m_error = "--out is required, --method must be linear or cubic, sizes and --maxnodes positive";
+        ok = false;
+    }
+    spec.method = method == "cubic" ? GRID_CUBIC : GRID_LINEAR;
+    spec.numMoneyness = (size_t)numMoneyness;
+    spec.numVolatility = (size_t)numVariance;
+    PriceGridBS grid;
+    bool reached = true;
+    if (ok && tolerance > 0) {
+        reached = grid.buildToTolerance(spec, tolerance, (size_t)maxNodes);
+        ok = grid.isBuilt();
+    }
+    else if (ok) ok = grid.build(spec);
+    if (!ok) {
+        cerr << (m_error.empty() ? "Invalid grid ranges or sizes" : m_error) << endl;
+        return EXIT_CODE_USAGE;
+    }
+    if (!grid.save(output)) {
+        cerr << "Unable to write the file " << output << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    const PriceGridError& error = grid.getError();
+    cout << scientific << setprecision(3);
+    cout << "nf,nvar,bytes,price_error,delta_error,density_error,exercise_error" << endl;
+    cout << grid.getSpec().numMoneyness << "," << grid.getSpec().numVolatility << "," << grid.getMemoryBytes() << ","
+        << error.price << "," << error.delta << "," << error.density << "," << error.exercise << endl;
+    if (!reached) {
+        cerr << "Tolerance " << tolerance << " not reached within " << maxNodes << " nodes, the finest grid was saved" << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    return EXIT_CODE_OK;
+}
+
+// greeks: every sensitivity of one call and one put, by automatic differentiation or bumping
+int CommandLineBS::runGreeks() {
+    double T = -1, K = -1, S0 = -1, sigma = -1, r = -1;
+    string method = "ad";
+    bool ok = parseOptions({ "T", "K", "S0", "sigma", "r", "method", "cdf" }) && getCdfBackend() && getDouble("T", T) && getDouble("K", K)
+        && getDouble("S0", S0) && getDouble("sigma", sigma) && getDouble("r", r) && getString("method", method);
+    if (ok && !(T > 0 && K > 0 && S0 > 0 && sigma > 0 && r >= 0 && (method == "ad" || method == "bump"))) {
+        m_error = "--T, --K, --S0 and --sigma must be given and positive, --r must not be negative, --method ad or bump";
+        ok = false;
+    }
+    if (!ok) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    EurGreeksRecord recs[2];
+    if (method == "ad") EurGreeksBS::evaluate(T, K, S0, sigma, r, recs[0], recs[1]);
+    else EurGreeksBS::bumpAndReprice(T, K, S0, sigma, r, recs[0], recs[1]);
+    cout << fixed << setprecision(8);
+    cout << "type,price,delta,gamma,vega,rho,theta,vanna,volga,charm" << endl;
+    for (int p = 0; p < 2; ++p) {
+        const EurGreeksRecord& rec = recs[p];
+        cout << (p == 0 ? "call," : "put,") << rec.price << "," << rec.delta << "," << rec.gamma << "," << rec.vega << ","
+            << rec.rho << "," << rec.theta << "," << rec.vanna << "," << rec.volga << "," << rec.charm << endl;
+    }
+    return EXIT_CODE_OK;
+}
+
+// cdf: accuracy and speed of every normal CDF backend on this machine
+int CommandLineBS::runCdf() {
+    if (!parseOptions({})) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    cout << "backend,max_error,ns_per_call" << endl;
+    for (int b = CDF_FAST; b < CDF_BACKENDS; ++b) {
+        NormalCDFReport report = NormalCDFBS::measure((CdfBackend)b);
+        cout << NormalCDFBS::getBackendName(report.backend) << "," << scientific << setprecision(3) << report.maxError << ","
+            << fixed << setprecision(2) << report.nsPerCall << endl;
+    }
+    return EXIT_CODE_OK;
+}
+
+// montecarlo: one option priced by simulation next to its closed form price
+int CommandLineBS::runMonteCarlo() {
+    MonteCarloOption option;
+    MonteCarloParams params;
+    option.T = option.K = option.S0 = option.sigma = option.r = -1;
+    string type = "call", sampler = "pseudo";
+    long long steps = params.numSteps, antithetic = 0, control = 0, replicates = params.numReplicates, threads = 0, scaling = 0;
+    bool ok = parseOptions({ "T", "K", "S0", "sigma", "r", "type", "paths", "steps", "sampler", "antithetic", "control",
+        "replicates", "seed", "threads", "scaling", "cdf" }) && getCdfBackend() && getDouble("T", option.T)
+        && getDouble("K", option.K) && getDouble("S0", option.S0) && getDouble("sigma", option.sigma) && getDouble("r", option.r)
+        && getString("type", type) && getInteger("paths", params.numPaths) && getInteger("steps", steps)
+        && getString("sampler", sampler) && getInteger("antithetic", antithetic) && getInteger("control", control)
+        && getInteger("replicates", replicates) && getUnsigned("seed", params.seed) && getInteger("threads", threads)
+        && getInteger("scaling", scaling);
+    if (ok && !(option.T > 0 && option.K > 0 && option.S0 > 0 && option.sigma > 0 && option.r >= 0
+        && (type == "call" || type == "put") && (sampler == "pseudo" || sampler == "sobol") && params.numPaths > 0
+        && steps >= 1 && steps <= MonteCarloBS::maxSteps && replicates >= 1 && replicates <= numeric_limits<int>::max()
+        && threads >= 0 && threads <= maxThreads)) {
+        m_error = "--T, --K, --S0 and --sigma must be given and positive, --r must not be negative, --type call or put,"
+            " --sampler pseudo or sobol, --paths and --replicates positive, --steps in [1, " + to_string(MonteCarloBS::maxSteps) + "]";
+        ok = false;
+    }
+    if (!ok) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    option.isCall = type == "call";
+    params.numSteps = (int)steps;
+    params.sampler = sampler == "sobol" ? MC_SOBOL : MC_PSEUDO;
+    params.antithetic = antithetic != 0;
+    params.controlVariate = control != 0;
+    params.numReplicates = (int)replicates;
+    params.numThreads = (int)threads;
+    MonteCarloBS engine(params);
+    MonteCarloResult result;
+    if (scaling != 0 ? !engine.scalingReport(option, cout) : !engine.price(option, result)) {
+        cerr << engine.getError() << endl;
+        return EXIT_CODE_USAGE;
+    }
+    if (scaling != 0) return EXIT_CODE_OK;
+    EurBSRecord rec = EurBatchBS::evaluate(option.T, option.K, option.S0, option.sigma, option.r);
+    double closedForm = option.isCall ? rec.callPrice : rec.putPrice;
+    cout << "type,price,std_error,bs_price,error,paths,seconds,paths_per_sec,convergence_per_sec" << endl;
+    cout << type << "," << fixed << setprecision(8) << result.price << "," << scientific << setprecision(3) << result.stdError << ","
+        << fixed << setprecision(8) << closedForm << "," << scientific << setprecision(3) << result.price - closedForm << ","
+        << result.paths << "," << fixed << setprecision(6) << engine.getSeconds() << "," << setprecision(0)
+        << engine.getPathsPerSecond() << "," << scientific << setprecision(3) << engine.getConvergencePerSecond() << endl;
+    return EXIT_CODE_OK;
+}
+
+// pde: one option on a Crank-Nicolson grid, optionally writing the whole surface over S
+int CommandLineBS::runPde() {
+    FiniteDifferenceSpec spec;
+    double T = -1, K = -1, S0 = -1, sigma = -1, r = -1;
+    string type = "put", exercise = "european", method = "penalty", surfaceFile;
+    long long numSpace = (long long)spec.numSpace, numTime = (long long)spec.numTime;
+    bool ok = parseOptions({ "T", "K", "S0", "sigma", "r", "type", "exercise", "method", "nspace", "ntime", "smax", "surface", "cdf" })
+        && getCdfBackend() && getDouble("T", T) && getDouble("K", K) && getDouble("S0", S0) && getDouble("sigma", sigma)
+        && getDouble("r", r) && getString("type", type) && getString("exercise", exercise) && getString("method", method)
+        && getInteger("nspace", numSpace) && getInteger("ntime", numTime) && getDouble("smax", spec.sMaxMultiple)
+        && getString("surface", surfaceFile);
+    if (ok && !(T > 0 && K > 0 && S0 > 0 && sigma > 0 && r >= 0 && (type == "call" || type == "put")
+        && (exercise == "european" || exercise == "american") && (method == "penalty" || method == "psor")
+        && numSpace >= 4 && numTime >= 1 && spec.sMaxMultiple > 1 && S0 < 0.99 * spec.sMaxMultiple * K)) {
+        m_error = "--T, --K, --S0 and --sigma must be given and positive, --r not negative, --nspace at least 4,"
+            " --ntime positive and S0 below --smax * K";
+        ok = false;
+    }
+    if (!ok) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    bool isCall = type == "call";
+    spec.numSpace = (size_t)numSpace;
+    spec.numTime = (size_t)numTime;
+    spec.exercise = exercise == "american" ? FD_AMERICAN : FD_EUROPEAN;
+    spec.constraint = method == "psor" ? FD_PSOR : FD_PENALTY;
+    FiniteDifferenceBS solver(spec);
+    FiniteDifferenceResult result;
+    if (!solver.price(T, K, S0, sigma, r, isCall, result)) {
+        cerr << "S0 must be at least one node below --smax * K" << endl;
+        return EXIT_CODE_USAGE;
+    }
+    if (!surfaceFile.empty()) {
+        FiniteDifferenceSurface surface;
+        solver.solve(T, K, sigma, r, isCall, surface);
+        ofstream out(surfaceFile);
+        out << fixed << setprecision(8) << "S,price,delta,gamma" << "\n";
+        for (size_t i = 0; i < surface.S.size(); ++i) {
+            out << surface.S[i] << "," << surface.price[i] << "," << surface.delta[i] << "," << surface.gamma[i] << "\n";
+        }
+        if (!out.good()) {
+            cerr << "Unable to write the file " << surfaceFile << endl;
+            return EXIT_CODE_FAILURE;
+        }
+    }
+    EurBSRecord rec = EurBatchBS::evaluate(T, K, S0, sigma, r);
+    cout << fixed << setprecision(8);
+    cout << "type,exercise,price,delta,gamma,theta,bs_price,iterations" << endl;
+    cout << type << "," << exercise << "," << result.price << "," << result.delta << "," << result.gamma << "," << result.theta << ","
+        << (isCall ? rec.callPrice : rec.putPrice) << "," << setprecision(2) << result.iterations << endl;
+    return EXIT_CODE_OK;
+}
+
+// mlp: accuracy and throughput of a trained network against the closed form
+int CommandLineBS::runMlp() {
+    DataSetParams params;
+    string modelFile, saveFile;
+    if (!parseOptions({ "model", "n", "tmax", "pmax", "sigmamax", "rmax", "seed", "threads", "sampling", "save", "cdf" })
+        || !getCdfBackend() || !getDataSetParams(params) || !getString("model", modelFile) || !getString("save", saveFile)) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    if (modelFile.empty()) {
+        cerr << "--model must name a JSON or binary model file" << endl;
+        return EXIT_CODE_USAGE;
+    }
+    MlpPricerBS network;
+    if (!network.load(modelFile)) {
+        cerr << network.getError() << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    if (!saveFile.empty() && !network.save(saveFile)) {
+        cerr << "Unable to write the file " << saveFile << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    MlpAccuracy accuracy;
+    if (!network.measureAccuracy(params, accuracy)) {
+        cerr << network.getError() << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    cout << "rows,mae,rmse,max_error,mlp_rows_per_sec,bs_rows_per_sec" << endl;
+    cout << accuracy.rows << "," << scientific << setprecision(3) << accuracy.meanAbsError << "," << accuracy.rmsError << ","
+        << accuracy.maxAbsError << "," << fixed << setprecision(0) << (accuracy.mlpSeconds > 0 ? accuracy.rows / accuracy.mlpSeconds : 0) << ","
+        << (accuracy.bsSeconds > 0 ? accuracy.rows / accuracy.bsSeconds : 0) << endl;
+    cerr << "Parameters: " << network.getNumParameters() << ", tile rows: " << network.getTileRows()
+        << ", simd: " << EurSimdBS::getLevelName() << endl;
+    return EXIT_CODE_OK;
+}
+
+// scenario: portfolio value, P&L and Greeks under every shock of a stress grid
+int CommandLineBS::runScenario() {
+    string input, output;
+    double spotMin = -0.25, spotMax = 0.25, volMin = -0.1, volMax = 0.1;
+    long long numSpot = 51, numVol = 51, threads = 0;
+    bool ok = parseOptions({ "in", "out", "spotmin", "spotmax", "nspot", "volmin", "volmax", "nvol", "threads" })
+        && getString("in", input) && getString("out", output) && getDouble("spotmin", spotMin) && getDouble("spotmax", spotMax)
+        && getInteger("nspot", numSpot) && getDouble("volmin", volMin) && getDouble("volmax", volMax)
+        && getInteger("nvol", numVol) && getInteger("threads", threads);
+    if (ok && !(!input.empty() && spotMin > -1 && spotMax >= spotMin && volMax >= volMin && numSpot > 0 && numVol > 0
+        && numSpot <= (1 << 24) && numVol <= (1 << 24) / numSpot && threads >= 0 && threads <= maxThreads)) {
+        m_error = "--in is required, shocks need --spotmin above -1 and max at least min, --nspot and --nvol"
+            " positive with at most 16777216 scenarios and --threads between 0 and " + to_string(maxThreads);
+        ok = false;
+    }
+    if (!ok) {
+        cerr << m_error << endl;
+        return EXIT_CODE_USAGE;
+    }
+    ScenarioEngineBS engine;
+    engine.setThreads((int)threads);
+    ScenarioGrid grid = ScenarioEngineBS::uniformGrid(spotMin, spotMax, (size_t)numSpot, volMin, volMax, (size_t)numVol);
+    ScenarioSurface surface;
+    if (!engine.loadPortfolio(input) || !engine.run(grid, surface)) {
+        cerr << engine.getError() << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    ofstream file;
+    if (!output.empty()) file.open(output);
+    ostream& out = output.empty() ? cout : file;
+    out << fixed << setprecision(8) << "spot_shock,vol_shock,value,pnl,delta,gamma,vega,theta" << "\n";
+    for (size_t v = 0; v < surface.numVol; ++v) {
+        for (size_t s = 0; s < surface.numSpot; ++s) {
+            size_t k = v * surface.numSpot + s;
+            out << grid.spotShocks[s] << "," << grid.volShocks[v] << "," << surface.value[k] << "," << surface.pnl[k] << ","
+                << surface.delta[k] << "," << surface.gamma[k] << "," << surface.vega[k] << "," << surface.theta[k] << "\n";
+        }
+    }
+    out.flush();
+    if (!out.good()) {
+        cerr << "Unable to write the file " << output << endl;
+        return EXIT_CODE_FAILURE;
+    }
+    double pairs = (double)engine.getNumPositions() * (surface.numSpot * surface.numVol);
+    cerr << "Positions: " << engine.getNumPositions() << ", scenarios: " << surface.numSpot * surface.numVol
+        << ", simd: " << EurSimdBS::getLevelName() << ", seconds: " << engine.getSeconds() << ", position-scenarios/sec: "
+        << (long long)(engine.getSeconds() > 0 ? pairs / engine.getSeconds() : 0) << endl;
+    return EXIT_CODE_OK;
+}
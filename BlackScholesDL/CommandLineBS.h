@@ -0,0 +1,85 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	CommandLineBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the CommandLineBS Class, non interactive entry point
+*					with price, generate, benchmark and reprice subcommands.
+*
+* References	:
+* Other files	:	EurBatchBS.h, EurDataSetBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct DataSetParams;
+
+// Process exit codes
+enum ExitCode { EXIT_CODE_OK = 0, EXIT_CODE_FAILURE = 1, EXIT_CODE_USAGE = 2 };
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class CommandLineBS
+{
+    public:
+
+        //constructors
+        CommandLineBS(int argc, char* argv[]);
+
+        // Public Member functions
+        int run();
+        static void printUsage(ostream& out);
+
+    private:
+
+        // Subcommands, each returns an ExitCode
+        int dispatch();
+        int runPrice();
+        int runGenerate();
+        int runBenchmark();
+        int runReprice();
+        int runImplied();
+        int runGrid();
+        int runGreeks();
+        int runCdf();
+        int runMonteCarlo();
+        int runPde();
+        int runMlp();
+        int runScenario();
+
+        // Option parsing, "--name value" pairs after the subcommand
+        bool parseOptions(const set<string>& allowed);
+        bool getDouble(const string& name, double& value);
+        bool getInteger(const string& name, long long& value);
+        bool getUnsigned(const string& name, uint64_t& value);
+        bool getString(const string& name, string& value);
+        bool getDataSetParams(DataSetParams& params);
+        bool getCdfBackend();
+        bool beginProfile();
+        void endProfile(double seconds);
+
+        // Largest --threads accepted, far above any core count
+        static const long long maxThreads = 1024;
+
+        // private  Member variables
+        vector<string> m_args;          // Arguments after the program name
+        map<string, string> m_options;  // Parsed options without the leading dashes
+        string m_error;                 // Last parsing error
+        long long m_profile = 0;        // --profile level of generate and reprice
+};
@@ -0,0 +1,56 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	CounterRNG.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the CounterRNG Class
+*
+* References	:	- G. Steele, D. Lea and C. Flood, Fast splittable pseudorandom number
+*					  generators, OOPSLA 2014 (SplitMix64)
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "CounterRNG.h"
+
+static const uint64_t golden = 0x9E3779B97F4A7C15ULL;
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+CounterRNG::CounterRNG() : m_seed(0), m_key(mix(0)) {}
+
+//Parametrized constructor
+CounterRNG::CounterRNG(uint64_t seed) : m_seed(seed), m_key(mix(seed)) {}
+
+//accessors
+uint64_t CounterRNG::getSeed() { return m_seed; }
+
+// SplitMix64 output function, a bijective 64 bit finalizer
+uint64_t CounterRNG::mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// SplitMix64 evaluated directly at counter row*drawsPerRow + draw, i.e. an O(1) jump ahead
+uint64_t CounterRNG::bits(uint64_t row, uint64_t draw) const {
+    return mix(m_key + (row * drawsPerRow + draw + 1) * golden);
+}
+
+// Uniform double in [0, 1) from the top 53 bits
+double CounterRNG::uniform(uint64_t row, uint64_t draw) const {
+    return (bits(row, draw) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Uniform double in [a, b)
+double CounterRNG::uniform(uint64_t row, uint64_t draw, double a, double b) const {
+    return a + (b - a) * uniform(row, draw);
+}
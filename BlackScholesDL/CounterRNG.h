@@ -0,0 +1,55 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	CounterRNG.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the CounterRNG Class, a counter based random number
+*					generator: every (row, draw) pair maps to its own random value, so any
+*					thread can produce any part of the stream without shared state.
+*
+* References	:	- G. Steele, D. Lea and C. Flood, Fast splittable pseudorandom number
+*					  generators, OOPSLA 2014 (SplitMix64)
+*					- J. Salmon et al., Parallel random numbers: as easy as 1, 2, 3, SC11
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstdint>
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class CounterRNG
+{
+    public:
+
+        //constructors
+        CounterRNG();
+        CounterRNG(uint64_t seed);
+
+        //accessors
+        uint64_t getSeed();
+
+        // Public Member functions
+        uint64_t bits(uint64_t row, uint64_t draw) const;
+        double uniform(uint64_t row, uint64_t draw) const;
+        double uniform(uint64_t row, uint64_t draw, double a, double b) const;
+
+        // Maximum number of draws per row
+        static const uint64_t drawsPerRow = 16;
+
+    private:
+
+        static uint64_t mix(uint64_t z);
+
+        // private  Member variables
+        uint64_t m_seed;  // User supplied seed
+        uint64_t m_key;   // Stream offset derived from the seed
+};
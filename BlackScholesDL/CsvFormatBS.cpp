@@ -0,0 +1,147 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	CsvFormatBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the CsvFormatBS Class
+*
+* References	:	- U. Adams, Ryu: fast float-to-string conversion, PLDI 2018
+*					- ISO/IEC 9899:2011, 7.21.6.1, the f conversion specifier
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+#include "CsvFormatBS.h"
+
+// With a magnitude below 1e10 and at most 9 decimals the scaled value stays below 2^64
+const double CsvFormatBS::fastLimit = 1e10;
+
+// Out of class definition, min() binds maxPrecision by reference
+const int CsvFormatBS::maxPrecision;
+
+static const uint64_t powersOfTen[] = { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+    10000000ull, 100000000ull, 1000000000ull, 10000000000ull };
+
+// "00" to "99", two digits per division
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// hi:lo = a * b with a below 2^53 and b below 2^32, in 64 bit halves on every compiler
+static void multiply(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+    uint64_t high = (a >> 32) * b, low = (a & 0xffffffffull) * b;
+    lo = low + (high << 32);
+    hi = (high >> 32) + (lo < low ? 1 : 0);
+}
+
+// The count digits of value ending at end, zero padded, written backwards; below 2^32
+// the divisions by 100 are done in 32 bits
+static void writeDigits(char* end, uint64_t value, int count) {
+    while (value > 0xffffffffull && count >= 2) {
+        const char* pair = digitPairs + 2 * (value % 100);
+        value /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+        count -= 2;
+    }
+    uint32_t small = (uint32_t)value;
+    while (count >= 2) {
+        const char* pair = digitPairs + 2 * (small % 100);
+        small /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+        count -= 2;
+    }
+    if (count > 0) *--end = (char)('0' + small % 10);
+}
+
+// Digits of an integer part, at most 11 as rounding can carry a value below fastLimit to it
+static int countDigits(uint64_t value) {
+    int count = 1;
+    while (count < 11 && value >= powersOfTen[count]) ++count;
+    return count;
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+// value with precision decimals at out, which needs maxFixedChars of room; returns the end
+char* CsvFormatBS::writeFixed(char* out, double value, int precision) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int exponent = (int)((bits >> 52) & 0x7ff);
+    if (exponent == 0x7ff || precision < 0 || precision > maxPrecision || !(value < fastLimit && value > -fastLimit)) {
+        char text[maxFixedChars];
+        int size = snprintf(text, sizeof(text), "%.*f", min(max(precision, 0), maxPrecision), value);
+        size = min(max(size, 0), (int)sizeof(text) - 1);
+        return writeText(out, text, (size_t)size);
+    }
+    if (bits >> 63) *out++ = '-';
+
+    // |value| = mantissa * 2^-shift, and the digits are mantissa * 10^precision * 2^-shift
+    // rounded to an integer; below 1e10 the shift is at least 19
+    uint64_t mantissa = bits & ((1ull << 52) - 1);
+    if (exponent == 0) exponent = 1;
+    else mantissa |= 1ull << 52;
+    int shift = 1075 - exponent;
+    uint64_t hi, lo, scaled = 0;
+    multiply(mantissa, powersOfTen[precision], hi, lo);
+    if (shift < 128) {
+        // Quotient, remainder and half of 2^shift, the remainder and half as hi:lo pairs
+        uint64_t restHi, restLo, halfHi, halfLo;
+        if (shift < 64) {
+            scaled = (lo >> shift) | (hi << (64 - shift));
+            restHi = 0;
+            restLo = lo & ((1ull << shift) - 1);
+            halfHi = 0;
+            halfLo = 1ull << (shift - 1);
+        }
+        else {
+            int high = shift - 64;
+            scaled = hi >> high;
+            restHi = high > 0 ? hi & ((1ull << high) - 1) : 0;
+            restLo = lo;
+            halfHi = high > 0 ? 1ull << (high - 1) : 0;
+            halfLo = high > 0 ? 0 : 1ull << 63;
+        }
+        bool above = restHi > halfHi || (restHi == halfHi && restLo > halfLo);
+        bool tie = restHi == halfHi && restLo == halfLo;
+        if (above || (tie && (scaled & 1))) ++scaled;
+    }
+
+    uint64_t integer = scaled / powersOfTen[precision], fraction = scaled % powersOfTen[precision];
+    int digits = countDigits(integer);
+    writeDigits(out + digits, integer, digits);
+    out += digits;
+    if (precision > 0) {
+        *out++ = '.';
+        writeDigits(out + precision, fraction, precision);
+        out += precision;
+    }
+    return out;
+}
+
+// Room for bytes more characters after end, a position inside text; the string grows by
+// doubling and the returned pointer is end in the possibly moved buffer. Shrink the text
+// to the written size once done.
+char* CsvFormatBS::reserve(string& text, char* end, size_t bytes) {
+    size_t used = text.empty() ? 0 : (size_t)(end - &text[0]);
+    if (text.size() - used >= bytes) return end;
+    text.resize(max(2 * text.size(), used + bytes));
+    return &text[0] + used;
+}
@@ -0,0 +1,63 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	CsvFormatBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the CsvFormatBS Class, number to text conversion of
+*					the CSV outputs straight into a char buffer, without streams, locales
+*					or formatting state.
+*
+*					Fixed     : the same characters as printf("%.*f") and iostream fixed
+*					            with setprecision, so files keep every byte. The double is
+*					            split in its integer mantissa and binary exponent, and
+*					            mantissa * 10^precision shifted by the exponent in 128 bit
+*					            integer arithmetic gives the digits exactly, rounded half
+*					            to even on the exact value like the C library.
+*					Range     : magnitudes below fastLimit and precisions up to maxPrecision;
+*					            larger values, infinities and NaN go through snprintf.
+*
+* References	:	- U. Adams, Ryu: fast float-to-string conversion, PLDI 2018
+*					- ISO/IEC 9899:2011, 7.21.6.1, the f conversion specifier
+* Other files	:	EurDataSetBS.cpp, PortfolioPricerBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class CsvFormatBS
+{
+    public:
+
+        // Public Member functions
+        static char* writeFixed(char* out, double value, int precision);
+        static char* reserve(string& text, char* end, size_t bytes);
+
+        // Text of a field, out must have room for it
+        static inline char* writeText(char* out, const char* text, size_t size) {
+            memcpy(out, text, size);
+            return out + size;
+        }
+
+        // Largest precision of writeFixed
+        static const int maxPrecision = 9;
+
+        // Room writeFixed needs after out, enough for -DBL_MAX at maxPrecision
+        static const size_t maxFixedChars = 330;
+
+        // Magnitudes formatted without snprintf
+        static const double fastLimit;
+};
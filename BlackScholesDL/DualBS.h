@@ -0,0 +1,175 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	DualBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Second order forward mode automatic differentiation. A DualBS<N>
+*					carries a value with its gradient and Hessian with respect to N
+*					input variables, and every operation applies the chain rule to all
+*					of them, so one evaluation of a formula on DualBS inputs returns the
+*					formula and all its first and second derivatives.
+*
+*					Hessian   : upper triangle only, row by row, see hessianIndex.
+*					Cost      : 1 + N + N(N+1)/2 doubles per value, fixed size loops
+*					            that the compiler unrolls and vectorises.
+*
+* References	:	- A. Griewank and A. Walther, Evaluating Derivatives, Second Ed., SIAM 2008
+* Other files	:	EurKernelBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cmath>
+#include "EurKernelBS.h"
+
+using namespace std;
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+template <int N>
+struct DualBS
+{
+    static const int H = N * (N + 1) / 2;
+
+    double v;           // Value
+    double g[N];        // Gradient
+    double h[H];        // Hessian, upper triangle
+
+    // Position of d2/dxi dxj in h, for i <= j
+    static inline int hessianIndex(int i, int j) { return i * N - i * (i - 1) / 2 + (j - i); }
+
+    // A constant, every derivative is zero
+    static inline DualBS constant(double value) {
+        DualBS x;
+        x.v = value;
+        for (int i = 0; i < N; ++i) x.g[i] = 0.0;
+        for (int k = 0; k < H; ++k) x.h[k] = 0.0;
+        return x;
+    }
+
+    // The input variable number index
+    static inline DualBS variable(double value, int index) {
+        DualBS x = constant(value);
+        x.g[index] = 1.0;
+        return x;
+    }
+
+    double hessian(int i, int j) const { return i <= j ? h[hessianIndex(i, j)] : h[hessianIndex(j, i)]; }
+
+    // f(x) from the value f0 and the derivatives f1 = f'(x) and f2 = f''(x)
+    inline DualBS chain(double f0, double f1, double f2) const {
+        DualBS y;
+        y.v = f0;
+        for (int i = 0; i < N; ++i) y.g[i] = f1 * g[i];
+        for (int i = 0, k = 0; i < N; ++i) {
+            for (int j = i; j < N; ++j, ++k) y.h[k] = f1 * h[k] + f2 * g[i] * g[j];
+        }
+        return y;
+    }
+};
+
+/****************************************************************************************
+*									OPERATORS											*
+****************************************************************************************/
+
+template <int N>
+inline DualBS<N> operator+(const DualBS<N>& a, const DualBS<N>& b) {
+    DualBS<N> y;
+    y.v = a.v + b.v;
+    for (int i = 0; i < N; ++i) y.g[i] = a.g[i] + b.g[i];
+    for (int k = 0; k < DualBS<N>::H; ++k) y.h[k] = a.h[k] + b.h[k];
+    return y;
+}
+
+template <int N>
+inline DualBS<N> operator-(const DualBS<N>& a, const DualBS<N>& b) {
+    DualBS<N> y;
+    y.v = a.v - b.v;
+    for (int i = 0; i < N; ++i) y.g[i] = a.g[i] - b.g[i];
+    for (int k = 0; k < DualBS<N>::H; ++k) y.h[k] = a.h[k] - b.h[k];
+    return y;
+}
+
+template <int N>
+inline DualBS<N> operator-(const DualBS<N>& a) {
+    return a.chain(-a.v, -1.0, 0.0);
+}
+
+template <int N>
+inline DualBS<N> operator*(const DualBS<N>& a, const DualBS<N>& b) {
+    DualBS<N> y;
+    y.v = a.v * b.v;
+    for (int i = 0; i < N; ++i) y.g[i] = a.v * b.g[i] + b.v * a.g[i];
+    for (int i = 0, k = 0; i < N; ++i) {
+        for (int j = i; j < N; ++j, ++k) y.h[k] = a.v * b.h[k] + b.v * a.h[k] + a.g[i] * b.g[j] + a.g[j] * b.g[i];
+    }
+    return y;
+}
+
+template <int N>
+inline DualBS<N> operator/(const DualBS<N>& a, const DualBS<N>& b) {
+    double inverse = 1.0 / b.v;
+    return a * b.chain(inverse, -inverse * inverse, 2.0 * inverse * inverse * inverse);
+}
+
+// Mixed with constants
+template <int N>
+inline DualBS<N> operator+(const DualBS<N>& a, double b) {
+    DualBS<N> y = a;
+    y.v = a.v + b;
+    return y;
+}
+
+template <int N>
+inline DualBS<N> operator-(double a, const DualBS<N>& b) {
+    return b.chain(a - b.v, -1.0, 0.0);
+}
+
+template <int N>
+inline DualBS<N> operator*(double a, const DualBS<N>& b) {
+    return b.chain(a * b.v, a, 0.0);
+}
+
+template <int N>
+inline DualBS<N> operator/(const DualBS<N>& a, double b) {
+    return a.chain(a.v / b, 1.0 / b, 0.0);
+}
+
+/****************************************************************************************
+*									FUNCTIONS											*
+****************************************************************************************/
+
+template <int N>
+inline DualBS<N> exp(const DualBS<N>& x) {
+    double e = exp(x.v);
+    return x.chain(e, e, e);
+}
+
+template <int N>
+inline DualBS<N> log(const DualBS<N>& x) {
+    double inverse = 1.0 / x.v;
+    return x.chain(log(x.v), inverse, -inverse * inverse);
+}
+
+template <int N>
+inline DualBS<N> sqrt(const DualBS<N>& x) {
+    double root = sqrt(x.v);
+    return x.chain(root, 0.5 / root, -0.25 / (root * x.v));
+}
+
+// N(x) and N(-x) with the values of the selected NormalCDFBS backend and the exact derivatives phi(x)
+// and -x*phi(x), so the derivatives are those of the closed form Greeks
+template <int N>
+inline void normalCDFPair(const DualBS<N>& x, DualBS<N>& cdfPos, DualBS<N>& cdfNeg) {
+    double density = EurNormalBS::pdf(x.v), valuePos, valueNeg;
+    NormalCDFBS::cdfPair(x.v, valuePos, valueNeg);
+    cdfPos = x.chain(valuePos, density, -x.v * density);
+    cdfNeg = x.chain(valueNeg, -density, x.v * density);
+}
@@ -0,0 +1,90 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurBatchBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the EurBatchBS Class
+*
+* References	:	- Instruction and some code by Dr. Michael Philips @qmul.ac.uk
+*					- M.Capinski and T.Zastawniak, Numerical Methods in Finance with C++,
+*					  Cambridge, 2012, code: http://www.cambridge.org/9780521177160
+*                   - Greeks from P. Wilmott Introduces Quantitative Finance, Second Ed.
+* Other files	:	EurOptionBS.cpp, EurKernelBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "EurBatchBS.h"
+#include "EurKernelBS.h"
+
+static const double sqrtTwoPi = sqrt(2.0 * 4.0 * atan(1.0));
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+// Price a book of calls through the EurKernelBS instantiation of the requested outputs
+// and of the selected CDF backend
+void EurBatchBS::priceCalls(const EurBSBatchInput& in, const EurBSBatchOutput& out) {
+    evaluateSelectedBatch<PAYOFF_CALL>(in, out);
+}
+
+// Price a book of puts, likewise
+void EurBatchBS::pricePuts(const EurBSBatchInput& in, const EurBSBatchOutput& out) {
+    evaluateSelectedBatch<PAYOFF_PUT>(in, out);
+}
+
+// Fused evaluation of a call and a put on the same inputs. Put-call parity is applied
+// through N(-d) = 1 - N(d) and the shared gamma, so each transcendental runs once.
+// N(d) comes from the selected NormalCDFBS backend.
+EurBSRecord EurBatchBS::evaluate(double T, double K, double S0, double sigma, double r) {
+    EurBSRecord rec;
+    double sqrtT = sqrt(T);
+    double dPlus = (log(S0 / K) + (r + 0.5 * pow(sigma, 2.0)) * T) / (sigma * sqrtT);
+    double dMinus = dPlus - sigma * sqrtT;
+    double discount = exp(-r * T);
+
+    double nPlus, nNegPlus, nMinus, nNegMinus, pdfPlus;
+    if (NormalCDFBS::getBackend() == CDF_ABRAMOWITZ_STEGUN) {
+        // The Abramowitz-Stegun tails share exp(-d*d/2) with the density
+        double expPlus = exp(-(dPlus * dPlus) / 2.0);
+        double expMinus = exp(-(dMinus * dMinus) / 2.0);
+        CdfAbramowitzStegunBS::cdfPair(dPlus, expPlus, nPlus, nNegPlus);
+        CdfAbramowitzStegunBS::cdfPair(dMinus, expMinus, nMinus, nNegMinus);
+        pdfPlus = expPlus / sqrtTwoPi;
+    }
+    else {
+        NormalCDFBS::cdfPair(dPlus, nPlus, nNegPlus);
+        NormalCDFBS::cdfPair(dMinus, nMinus, nNegMinus);
+        pdfPlus = exp(-(dPlus * dPlus) / 2.0) / sqrtTwoPi;
+    }
+    double thetaDecay = -((sigma * S0) / (2 * sqrtT)) * pdfPlus;
+
+    rec.callPrice = S0 * nPlus - K * discount * nMinus;
+    rec.callDelta = nPlus;
+    rec.callTheta = thetaDecay - r * K * discount * nMinus;
+    rec.putPrice = -S0 * nNegPlus + K * discount * nNegMinus;
+    rec.putDelta = -nNegPlus;
+    rec.putTheta = thetaDecay + r * K * discount * nNegMinus;
+    rec.gamma = pdfPlus / (sigma * S0 * sqrtT);
+    return rec;
+}
+
+// Fused evaluation of a book, either output set may have null pointers
+void EurBatchBS::evaluateBatch(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put) {
+    for (size_t i = 0; i < in.n; ++i) {
+        EurBSRecord rec = evaluate(in.T[i], in.K[i], in.S0[i], in.sigma[i], in.r[i]);
+        if (call.price) call.price[i] = rec.callPrice;
+        if (call.delta) call.delta[i] = rec.callDelta;
+        if (call.gamma) call.gamma[i] = rec.gamma;
+        if (call.theta) call.theta[i] = rec.callTheta;
+        if (put.price) put.price[i] = rec.putPrice;
+        if (put.delta) put.delta[i] = rec.putDelta;
+        if (put.gamma) put.gamma[i] = rec.gamma;
+        if (put.theta) put.theta[i] = rec.putTheta;
+    }
+}
@@ -0,0 +1,74 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurBatchBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the EurBatchBS Class, batch pricing of European
+*					options stored as structure of arrays (SoA).
+*
+* References	:	- Instruction and some code by Dr. Michael Philips @qmul.ac.uk
+*					- M.Capinski and T.Zastawniak, Numerical Methods in Finance with C++,
+*					  Cambridge, 2012, code: http://www.cambridge.org/9780521177160
+*                   - Greeks from P. Wilmott Introduces Quantitative Finance, Second Ed.
+* Other files	:	EurOptionBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include "EurOptionBS.h"
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Input book of n contracts, each pointer addresses n contiguous values
+struct EurBSBatchInput {
+    size_t n;               // Number of contracts
+    const double* T;        // Time to maturity in years
+    const double* K;        // Strike (Exercise) Price
+    const double* S0;       // Initial Stock Price
+    const double* sigma;    // Annualized volatility
+    const double* r;        // Annual risk-free interest rate
+};
+
+// Output arrays of n values, a null pointer skips that result
+struct EurBSBatchOutput {
+    double* price;
+    double* delta;
+    double* gamma;
+    double* theta;
+};
+
+// Call and put results of one contract, produced by a single evaluation
+struct EurBSRecord {
+    double callPrice;
+    double callDelta;
+    double callTheta;
+    double putPrice;
+    double putDelta;
+    double putTheta;
+    double gamma;           // Identical for the call and the put
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class EurBatchBS
+{
+    public:
+
+        // Price a whole book of calls or puts, results match EurCallBS and EurPutBS
+        static void priceCalls(const EurBSBatchInput& in, const EurBSBatchOutput& out);
+        static void pricePuts(const EurBSBatchInput& in, const EurBSBatchOutput& out);
+
+        // Fused call and put price and Greeks sharing d1, d2, N(d), phi(d1) and exp(-rT)
+        static EurBSRecord evaluate(double T, double K, double S0, double sigma, double r);
+        static void evaluateBatch(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put);
+};
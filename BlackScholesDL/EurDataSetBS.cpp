@@ -0,0 +1,426 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurDataSetBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the EurDataSetBS Class
+*
+* References	:	- Instruction and some code by Dr. Michael Philips @qmul.ac.uk
+*					- M.Capinski and T.Zastawniak, Numerical Methods in Finance with C++,
+*					  Cambridge, 2012, code: http://www.cambridge.org/9780521177160
+* Other files	:	SamplerBS.cpp, EurSimdBS.cpp, AsyncWriterBS.cpp, CsvFormatBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "AsyncWriterBS.h"
+#include "CsvFormatBS.h"
+#include "EurDataSetBS.h"
+#include "EurSimdBS.h"
+#include "ProfilerBS.h"
+
+// Rows per work unit, each block is drawn, priced and formatted by one thread
+static const long long blockRows = 16384;
+
+// Powers of ten of roundUp, exact in double precision
+static const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+// Buffers of the CSV pipeline per worker thread, the writer can lag a block behind each
+// worker while they compute the next one
+static const size_t buffersPerThread = 2;
+
+// Decimals of the CSV numbers, and the room reserved per row: rows take about 162 bytes,
+// the text grows if wider ones use it up
+static const int csvPrecision = 8;
+static const size_t csvRowBytes = 192;
+
+const double EurDataSetBS::nMin = 0.00000001;
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// Inverse distribution function of the mixture weight * U(a, b) + (1 - weight) * U(lo, hi)
+// with [a, b] inside [lo, hi]: monotone and piecewise linear, so strata and low discrepancy
+// points of u keep their structure, and weight 0 is the plain lo + (hi - lo) * u
+static double focusWarp(double u, double lo, double hi, double a, double b, double weight) {
+    if (weight <= 0 || b <= a) return lo + (hi - lo) * u;
+    double outside = (1 - weight) / (hi - lo);
+    double atA = outside * (a - lo);
+    double atB = atA + weight + outside * (b - a);
+    if (u < atA) return lo + u / outside;
+    if (u <= atB) return a + (u - atA) / (weight / (b - a) + outside);
+    return b + (u - atB) / outside;
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+EurDataSetBS::EurDataSetBS() : m_params(), m_sampler(), m_threadsUsed(0), m_seconds(0), m_error("") {}
+
+//Parametrized constructor
+EurDataSetBS::EurDataSetBS(const DataSetParams& params) : m_params(params),
+    m_sampler(params.sampling, params.seed, params.numSamples),
+    m_threadsUsed(0), m_seconds(0), m_error("") {}
+
+//accessors
+void EurDataSetBS::setParams(const DataSetParams& params) {
+    m_params = params;
+    m_sampler = SamplerBS(params.sampling, params.seed, params.numSamples);
+}
+DataSetParams EurDataSetBS::getParams() { return m_params; }
+int EurDataSetBS::getThreadsUsed() { return m_threadsUsed; }
+double EurDataSetBS::getSeconds() { return m_seconds; }
+double EurDataSetBS::getRowsPerSecond() { return m_seconds > 0 ? m_params.numSamples / m_seconds : 0; }
+string EurDataSetBS::getError() { return m_error; }
+
+// Funtion to round up double values, the factor comes from a table instead of pow
+double EurDataSetBS::roundUp(double num, int places) {
+    if (places < 1) return num;
+    double factor = places < 10 ? powersOfTen[places] : pow(10.0, places);
+    return ceil(num * factor) / factor;
+}
+
+// Write the column names and the simulation parameters, numSamples being the rows of the file
+void EurDataSetBS::writeHeader(ostream& out, long long numSamples) {
+    out << "time" << "," << "strike_price" << "," << "stock_price" << "," << "volatility" << "," << "interest_rate" << ",";
+    out << "type_o1" << "," << "price_o1" << "," << "delta_o1" << "," << "gamma_o1" << "," << "theta_o1" << ",";
+    out << "type_o2" << "," << "price_o2" << "," << "delta_o2" << "," << "gamma_o2" << "," << "theta_o12" << "\n";
+    out << "numSamples" << "," << "tMax" << "," << "pMax" << "," << "sigmaMax" << "," << "rMax" << "\n";
+    out << numSamples << "," << m_params.tMax << "," << m_params.pMax << "," << m_params.sigmaMax << "," << m_params.rMax << "\n";
+}
+
+// Binary column names, the call is option 1 and the put option 2 as in the CSV file;
+// gamma is the same for both so it is stored once
+vector<string> EurDataSetBS::columnNames() {
+    return { "time", "strike_price", "stock_price", "volatility", "interest_rate",
+        "price_o1", "delta_o1", "theta_o1", "price_o2", "delta_o2", "theta_o2", "gamma" };
+}
+
+// Map the unit points of SPACE_MONEYNESS, columns 0 to 4 hold the total variance, the
+// moneyness, S0, the maturity and r coordinates and are replaced by T, K, S0, sigma and r
+void EurDataSetBS::mapMoneyness(long long count, vector<vector<double>>& c) const {
+    const DataSetParams& p = m_params;
+    double varianceMax = p.sigmaMax * p.sigmaMax * p.tMax;
+    double focusVariance = min(p.focusVariance, varianceMax), focusMoneyness = min(p.focusMoneyness, p.moneynessMax);
+    for (long long i = 0; i < count; ++i) {
+        double variance = focusWarp(c[0][i], nMin, varianceMax, nMin, focusVariance, p.focusWeight);
+        double moneyness = focusWarp(c[1][i], -p.moneynessMax, p.moneynessMax, -focusMoneyness, focusMoneyness, p.focusWeight);
+        double S0 = nMin + (p.pMax - nMin) * c[2][i];
+        double tLow = variance / (p.sigmaMax * p.sigmaMax);
+        double T = tLow + (p.tMax - tLow) * c[3][i];
+        c[0][i] = roundUp(T, 6);
+        c[1][i] = roundUp(S0 * exp(-moneyness), 2);
+        c[2][i] = roundUp(S0, 2);
+        c[3][i] = roundUp(sqrt(variance / T), 4);
+        c[4][i] = roundUp(nMin + (p.rMax - nMin) * c[4][i], 4);
+    }
+}
+
+// Draw and price rows [first, first + count) on the thread of index worker. The inputs of
+// a row depend only on the seed and the row index, so the block is the same whichever
+// thread runs it.
+DataSetBlock EurDataSetBS::priceBlock(long long first, long long count, int worker) {
+    DataSetBlock block;
+    block.first = first;
+    block.count = count;
+    block.columns.assign(12, vector<double>(count));
+    vector<vector<double>>& c = block.columns;
+
+    {
+        BSDL_PROFILE_SCOPE(STAGE_SAMPLE, worker);
+        double* unit[SamplerBS::dimensions] = { c[0].data(), c[1].data(), c[2].data(), c[3].data(), c[4].data() };
+        m_sampler.fill(first, count, unit);
+        BSDL_PROFILE_COUNT(STAGE_SAMPLE, worker, count, 0);
+    }
+    {
+        BSDL_PROFILE_SCOPE(STAGE_MAP, worker);
+        if (m_params.space == SPACE_MONEYNESS) mapMoneyness(count, c);
+        else {
+            for (long long i = 0; i < count; ++i) {
+                c[0][i] = roundUp(nMin + (m_params.tMax - nMin) * c[0][i], 6);
+                c[1][i] = roundUp(nMin + (m_params.pMax - nMin) * c[1][i], 2);
+                c[2][i] = roundUp(nMin + (m_params.pMax - nMin) * c[2][i], 2);
+                c[3][i] = roundUp(nMin + (m_params.sigmaMax - nMin) * c[3][i], 4);
+                c[4][i] = roundUp(nMin + (m_params.rMax - nMin) * c[4][i], 4);
+            }
+        }
+        BSDL_PROFILE_COUNT(STAGE_MAP, worker, count, 0);
+    }
+    {
+        BSDL_PROFILE_SCOPE(STAGE_PRICE, worker);
+        EurBSBatchInput in = { (size_t)count, c[0].data(), c[1].data(), c[2].data(), c[3].data(), c[4].data() };
+        EurBSBatchOutput call = { c[5].data(), c[6].data(), c[11].data(), c[7].data() };
+        EurBSBatchOutput put = { c[8].data(), c[9].data(), nullptr, c[10].data() };
+        EurSimdBS::evaluateBatch(in, call, put);
+        BSDL_PROFILE_COUNT(STAGE_PRICE, worker, count, 0);
+    }
+    return block;
+}
+
+// Append the rows of the columns to text, each number with csvPrecision decimals as
+// fixed << setprecision(8) wrote them, through CsvFormatBS instead of a stream
+void EurDataSetBS::formatCsv(const vector<vector<double>>& c, long long count, string& text, int worker) const {
+    BSDL_PROFILE_SCOPE(STAGE_FORMAT, worker);
+    const size_t rowRoom = 13 * CsvFormatBS::maxFixedChars + 16;
+    const int callColumns[4] = { 5, 6, 11, 7 }, putColumns[4] = { 8, 9, 11, 10 };
+    size_t start = text.size();
+    text.resize(start + (size_t)count * csvRowBytes + rowRoom);
+    char* p = &text[start];
+    for (long long i = 0; i < count; ++i) {
+        p = CsvFormatBS::reserve(text, p, rowRoom);
+        for (int col = 0; col < 5; ++col) {
+            p = CsvFormatBS::writeFixed(p, c[col][i], csvPrecision);
+            *p++ = ',';
+        }
+        p = CsvFormatBS::writeText(p, "call,", 5);
+        for (int col : callColumns) {
+            p = CsvFormatBS::writeFixed(p, c[col][i], csvPrecision);
+            *p++ = ',';
+        }
+        p = CsvFormatBS::writeText(p, "put,", 4);
+        for (int col : putColumns) {
+            p = CsvFormatBS::writeFixed(p, c[col][i], csvPrecision);
+            *p++ = ',';
+        }
+        *p++ = '\n';
+    }
+    text.resize((size_t)(p - &text[0]));
+    BSDL_PROFILE_COUNT(STAGE_FORMAT, worker, count, (long long)(text.size() - start));
+}
+
+// Draw, price and format rows [first, first + count) on the thread of index worker
+DataSetBlock EurDataSetBS::generateBlock(long long first, long long count, int worker) {
+    DataSetBlock block = priceBlock(first, count, worker);
+    vector<vector<double>>& c = block.columns;
+    if (m_params.format == FORMAT_CSV) {
+        formatCsv(c, count, block.text, worker);
+        block.columns.clear();
+    }
+    else if (m_params.format == FORMAT_FLOAT32) {
+        BSDL_PROFILE_SCOPE(STAGE_FORMAT, worker);
+        block.columns32.resize(c.size());
+        for (size_t col = 0; col < c.size(); ++col) {
+            block.columns32[col].assign(c[col].begin(), c[col].end());
+        }
+        block.columns.clear();
+        BSDL_PROFILE_COUNT(STAGE_FORMAT, worker, count, count * (long long)(c.size() * sizeof(float)));
+    }
+    return block;
+}
+
+// Generate the dataset into a CSV stream or a columnar writer, with neither the output
+// is discarded. Blocks are handed out round robin and written back in row order, while
+// a round is written the workers already compute the next one. The first failed write stops
+// the generation and returns false.
+bool EurDataSetBS::run(ostream* out, ColumnarWriterBS* writer) {
+    int threads = m_params.numThreads > 0 ? m_params.numThreads : (int)thread::hardware_concurrency();
+    m_threadsUsed = threads > 0 ? threads : 1;
+    long long numBlocks = (m_params.numSamples + blockRows - 1) / blockRows;
+
+    auto start = chrono::steady_clock::now();
+    if (out) writeHeader(*out, m_params.numSamples);
+
+    vector<future<DataSetBlock>> writing;
+    long long rowsDone = 0, bytesDone = 0;
+    bool written = true;
+    for (long long round = 0; written && (round < numBlocks || !writing.empty()); round += m_threadsUsed) {
+        vector<future<DataSetBlock>> computing;
+        for (long long b = round; b < numBlocks && b < round + m_threadsUsed; ++b) {
+            long long first = b * blockRows;
+            long long count = min(blockRows, m_params.numSamples - first);
+            int worker = (int)(b - round);
+            computing.push_back(async(launch::async, &EurDataSetBS::generateBlock, this, first, count, worker));
+        }
+        for (auto& pending : writing) {
+            DataSetBlock block;
+            {
+                BSDL_PROFILE_SCOPE(STAGE_WAIT, ProfilerBS::ioWorker);
+                block = pending.get();
+            }
+            BSDL_PROFILE_SCOPE(STAGE_WRITE, ProfilerBS::ioWorker);
+            long long bytes = (long long)block.text.size();
+            if (out) written = out->write(block.text.data(), block.text.size()).good();
+            if (writer && !block.columns.empty()) {
+                vector<const double*> columns;
+                for (auto& column : block.columns) columns.push_back(column.data());
+                written = writer->writeRows(block.first, block.count, columns.data());
+                bytes = block.count * (long long)(block.columns.size() * sizeof(double));
+            }
+            if (writer && !block.columns32.empty()) {
+                vector<const float*> columns;
+                for (auto& column : block.columns32) columns.push_back(column.data());
+                written = writer->writeRows(block.first, block.count, columns.data());
+                bytes = block.count * (long long)(block.columns32.size() * sizeof(float));
+            }
+            if (!written) break;
+            rowsDone += block.count;
+            bytesDone += bytes;
+            BSDL_PROFILE_COUNT(STAGE_WRITE, ProfilerBS::ioWorker, block.count, bytes);
+            BSDL_PROFILE_PROGRESS(rowsDone, m_params.numSamples, bytesDone);
+        }
+        writing = move(computing);
+    }
+    if (out && written) written = out->flush().good();
+    m_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return written;
+}
+
+// Generate the CSV file through an AsyncWriterBS: persistent workers take the next block,
+// format it (or gzip its text for a .gz name) into a recycled buffer and publish it, while the
+// writer thread writes the blocks in row order. Shard s holds the blocks from
+// numBlocks * s / numShards on, with its own header.
+bool EurDataSetBS::runPipeline() {
+    int threads = m_params.numThreads > 0 ? m_params.numThreads : (int)thread::hardware_concurrency();
+    m_threadsUsed = threads > 0 ? threads : 1;
+    long long numBlocks = (m_params.numSamples + blockRows - 1) / blockRows;
+    int numShards = max(1, m_params.numShards);
+    const string& fileName = m_params.fileName;
+    bool gzip = fileName.size() > 3 && fileName.compare(fileName.size() - 3, 3, ".gz") == 0;
+    if (gzip && !AsyncWriterBS::isCompressionAvailable()) {
+        m_error = "gzip output needs a build with BSDL_ZLIB defined";
+        return false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<long long> shardFirst;
+    vector<string> fileNames, headers;
+    for (int s = 0; s < numShards; ++s) {
+        long long firstBlock = numBlocks * s / numShards, endBlock = numBlocks * (s + 1) / numShards;
+        long long rows = min(endBlock * blockRows, m_params.numSamples) - min(firstBlock * blockRows, m_params.numSamples);
+        ostringstream header;
+        writeHeader(header, rows);
+        string text = header.str();
+        if (gzip && !AsyncWriterBS::compress(header.str(), text)) {
+            m_error = "cannot compress the header";
+            return false;
+        }
+        shardFirst.push_back(firstBlock);
+        fileNames.push_back(shardFileName(fileName, s, numShards));
+        headers.push_back(text);
+    }
+
+    AsyncWriterOptions options;
+    options.queueDepth = buffersPerThread * m_threadsUsed + 2;
+    options.directIO = m_params.directIO;
+    AsyncWriterBS writer;
+    if (!writer.open(fileNames, headers, (uint64_t)numBlocks, m_params.numSamples, options)) {
+        m_error = writer.getError();
+        return false;
+    }
+
+    // Every block is published, even after a failure, so the writer always reaches the end
+    atomic<long long> nextBlock(0);
+    atomic<bool> failed(false);
+    auto work = [&](int worker) {
+        string text;
+        for (long long b = nextBlock.fetch_add(1); b < numBlocks; b = nextBlock.fetch_add(1)) {
+            long long first = b * blockRows;
+            long long count = min(blockRows, m_params.numSamples - first);
+            DataSetBlock block = priceBlock(first, count, worker);
+            string& buffer = writer.acquire((uint64_t)b, worker);
+            if (gzip) {
+                text.clear();
+                formatCsv(block.columns, count, text, worker);
+                BSDL_PROFILE_SCOPE(STAGE_COMPRESS, worker);
+                if (!AsyncWriterBS::compress(text, buffer)) failed = true;
+                BSDL_PROFILE_COUNT(STAGE_COMPRESS, worker, count, (long long)buffer.size());
+            }
+            else formatCsv(block.columns, count, buffer, worker);
+            int shard = (int)(upper_bound(shardFirst.begin(), shardFirst.end(), b) - shardFirst.begin()) - 1;
+            writer.publish((uint64_t)b, shard, count);
+        }
+    };
+    vector<future<void>> workers;
+    for (int t = 1; t < m_threadsUsed; ++t) workers.push_back(async(launch::async, work, t));
+    work(0);
+    for (auto& pending : workers) pending.get();
+    bool closed = writer.close();
+    m_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (failed) m_error = "cannot compress a block";
+    else if (!closed) m_error = writer.getError();
+    return closed && !failed;
+}
+
+// Name of file shard of numShards: the name itself for a single file, otherwise the shard
+// index goes before the extension, BSdataSet.csv.gz giving BSdataSet-00003.csv.gz
+string EurDataSetBS::shardFileName(const string& fileName, int shard, int numShards) {
+    if (numShards <= 1) return fileName;
+    size_t base = fileName.find_last_of("/\\");
+    base = (base == string::npos) ? 0 : base + 1;
+    size_t dot = fileName.find('.', base + 1);
+    if (dot == string::npos) dot = fileName.size();
+    ostringstream index;
+    index << "-" << setw(5) << setfill('0') << shard;
+    return fileName.substr(0, dot) + index.str() + fileName.substr(dot);
+}
+
+// Generate the dataset as CSV text into a stream, a null stream only measures the generation
+void EurDataSetBS::generate(ostream* out) {
+    DataSetFormat format = m_params.format;
+    m_params.format = FORMAT_CSV;
+    run(out, nullptr);
+    m_params.format = format;
+}
+
+// Generate the dataset into m_params.fileName in m_params.format
+bool EurDataSetBS::generate() {
+    m_error = "";
+    if (m_params.format == FORMAT_CSV) return runPipeline();
+    ColumnarHeader params = ColumnarHeader();
+    params.seed = m_params.seed;
+    params.tMax = m_params.tMax;
+    params.pMax = m_params.pMax;
+    params.sigmaMax = m_params.sigmaMax;
+    params.rMax = m_params.rMax;
+    ColumnarWriterBS writer;
+    uint32_t elementBytes = m_params.format == FORMAT_FLOAT32 ? 4 : 8;
+    if (!writer.open(m_params.fileName, columnNames(), (uint64_t)m_params.numSamples, elementBytes, params)) {
+        m_error = "cannot create " + m_params.fileName;
+        return false;
+    }
+    bool written = run(nullptr, &writer);
+    if (!writer.close() || !written) m_error = "cannot write " + m_params.fileName;
+    return m_error.empty();
+}
+
+// Rows per second from one thread up to every hardware thread, output discarded;
+// the format still decides whether the workers format CSV text
+void EurDataSetBS::scalingReport(const DataSetParams& params, ostream& report) {
+    int maxThreads = params.numThreads > 0 ? params.numThreads : (int)thread::hardware_concurrency();
+    if (maxThreads < 1) maxThreads = 1;
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    report << "threads,rows_per_sec,speedup,efficiency" << "\n";
+    double base = 0;
+    for (int t : counts) {
+        DataSetParams run = params;
+        run.numThreads = t;
+        EurDataSetBS generator(run);
+        generator.run(nullptr, nullptr);
+        double rate = generator.getRowsPerSecond();
+        if (t == 1) base = rate;
+        double speedup = base > 0 ? rate / base : 0;
+        report << t << "," << fixed << setprecision(0) << rate << "," << setprecision(2) << speedup << "," << speedup / t << "\n";
+        report.unsetf(ios::floatfield);
+    }
+    report << setprecision(6);
+}
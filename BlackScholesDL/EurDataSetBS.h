@@ -0,0 +1,135 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurDataSetBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the EurDataSetBS Class, multi-threaded generator of
+*					European options datasets priced with the Black-Scholes model.
+*
+*					Inputs    : T, K, S0, sigma and r uniform in [nMin, max), each from
+*					            one coordinate of a SamplerBS point (uniform, Sobol,
+*					            Halton or Latin hypercube).
+*					Moneyness : ln(S0 / K) uniform in [-moneynessMax, moneynessMax] and
+*					            the total variance sigma^2 T uniform up to sigmaMax^2 tMax,
+*					            T uniform among the maturities that keep sigma <= sigmaMax.
+*					            A focusWeight share of each of the two is drawn inside its
+*					            focus band, near the money and at low total variance.
+*					CSV files : written by an AsyncWriterBS pipeline, persistent workers
+*					            format blocks into recycled buffers while a writer thread
+*					            writes them in row order, split in numShards files and
+*					            gzipped when the file name ends in .gz.
+*
+* References	:	- Instruction and some code by Dr. Michael Philips @qmul.ac.uk
+*					- M.Capinski and T.Zastawniak, Numerical Methods in Finance with C++,
+*					  Cambridge, 2012, code: http://www.cambridge.org/9780521177160
+* Other files	:	SamplerBS.h, EurSimdBS.h, AsyncWriterBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ColumnarWriterBS.h"
+#include "SamplerBS.h"
+
+using namespace std;
+
+// Output file formats, binary files are columnar (see ColumnarFormatBS.h)
+enum DataSetFormat { FORMAT_CSV = 0, FORMAT_FLOAT64 = 1, FORMAT_FLOAT32 = 2 };
+
+// Space the sampled points are mapped from
+enum DataSetSpace { SPACE_INPUTS = 0, SPACE_MONEYNESS = 1 };
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Simulation parameters of a dataset, by default every input is drawn uniformly in [nMin, max)
+struct DataSetParams {
+    long long numSamples = 0;   // Number of rows
+    double tMax = 2.0;          // Maximum time to maturity in years
+    double pMax = 500.0;        // Maximum strike and stock price
+    double sigmaMax = 1.0;      // Maximum annualized volatility
+    double rMax = 0.1;          // Maximum annual risk-free interest rate
+    uint64_t seed = 0;          // Seed of the counter based random stream
+    int numThreads = 0;         // Worker threads, 0 uses every hardware thread
+    string fileName = "BSdataSet.csv";
+    DataSetFormat format = FORMAT_CSV;
+    DataSetSampling sampling = SAMPLING_UNIFORM;
+    DataSetSpace space = SPACE_INPUTS;
+    double moneynessMax = 1.0;  // Largest |ln(S0 / K)| of SPACE_MONEYNESS, K may exceed pMax
+    double focusWeight = 0.0;   // Extra share of SPACE_MONEYNESS rows drawn in each focus band
+    double focusMoneyness = 0.1;    // Moneyness focus band |ln(S0 / K)| <= focusMoneyness
+    double focusVariance = 0.04;    // Total variance focus band sigma^2 T <= focusVariance
+    int numShards = 1;          // CSV files, each with the header and a contiguous range of rows
+    bool directIO = false;      // CSV files written with O_DIRECT where supported
+};
+
+// Rows [first, first + count) of a dataset, as columns or as formatted CSV text
+struct DataSetBlock {
+    long long first = 0;
+    long long count = 0;
+    vector<vector<double>> columns;     // In the order of EurDataSetBS::columnNames()
+    vector<vector<float>> columns32;    // Only for FORMAT_FLOAT32
+    string text;                        // Only for FORMAT_CSV
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class EurDataSetBS
+{
+    public:
+
+        //constructors
+        EurDataSetBS();
+        EurDataSetBS(const DataSetParams& params);
+
+        //accessors
+        void setParams(const DataSetParams& params);
+        DataSetParams getParams();
+        int getThreadsUsed();
+        double getSeconds();
+        double getRowsPerSecond();
+        string getError();
+
+        // Public Member functions
+        bool generate();
+        void generate(ostream* out);
+        static double roundUp(double num, int places);
+        static vector<string> columnNames();
+        static void scalingReport(const DataSetParams& params, ostream& report);
+        static string shardFileName(const string& fileName, int shard, int numShards);
+
+        // Minimum of every sampled input
+        static const double nMin;
+
+        // Most CSV files of a sharded dataset
+        static const int maxShards = 1024;
+
+    private:
+
+        // private Member functions
+        void writeHeader(ostream& out, long long numSamples);
+        void mapMoneyness(long long count, vector<vector<double>>& c) const;
+        DataSetBlock priceBlock(long long first, long long count, int worker);
+        DataSetBlock generateBlock(long long first, long long count, int worker);
+        void formatCsv(const vector<vector<double>>& c, long long count, string& text, int worker) const;
+        bool run(ostream* out, ColumnarWriterBS* writer);
+        bool runPipeline();
+
+        // private  Member variables
+        DataSetParams m_params;     // Simulation parameters
+        SamplerBS m_sampler;        // Points of the unit cube, row i always gets the same inputs
+        int m_threadsUsed;          // Threads used by the last run
+        double m_seconds;           // Wall time of the last run
+        string m_error;             // Reason of the last failure
+};
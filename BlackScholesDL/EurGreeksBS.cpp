@@ -0,0 +1,140 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurGreeksBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the EurGreeksBS Class
+*
+* References	:	- Greeks from P. Wilmott Introduces Quantitative Finance, Second Ed.
+*					- A. Griewank and A. Walther, Evaluating Derivatives, Second Ed., SIAM 2008
+* Other files	:	DualBS.h, EurBatchBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "EurGreeksBS.h"
+#include "DualBS.h"
+
+// Differentiated inputs, in the order of the DualBS gradient
+enum GreeksInput { INPUT_S0 = 0, INPUT_SIGMA, INPUT_R, INPUT_T, GREEKS_INPUTS };
+
+typedef DualBS<GREEKS_INPUTS> GreeksDual;
+
+// Relative bump of S0, sigma and T, and absolute bump of r. Close to the 1e-4 that
+// balances truncation and rounding errors of the second differences.
+static const double bumpStep = 1e-4;
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// The Black-Scholes formula of EurKernelBS on differentiable inputs, call and put together
+static void blackScholes(const GreeksDual& T, double K, const GreeksDual& S0, const GreeksDual& sigma, const GreeksDual& r,
+    GreeksDual& call, GreeksDual& put) {
+    GreeksDual sqrtT = sqrt(T);
+    GreeksDual dPlus = (log(S0 / K) + (r + 0.5 * (sigma * sigma)) * T) / (sigma * sqrtT);
+    GreeksDual dMinus = dPlus - sigma * sqrtT;
+    GreeksDual strikePV = K * exp(-r * T);
+    GreeksDual cdfPlus, cdfNegPlus, cdfMinus, cdfNegMinus;
+    normalCDFPair(dPlus, cdfPlus, cdfNegPlus);
+    normalCDFPair(dMinus, cdfMinus, cdfNegMinus);
+    call = S0 * cdfPlus - strikePV * cdfMinus;
+    put = strikePV * cdfNegMinus - S0 * cdfNegPlus;
+}
+
+// The Greeks are read from the gradient and Hessian of the price
+static EurGreeksRecord toRecord(const GreeksDual& price) {
+    EurGreeksRecord rec;
+    rec.price = price.v;
+    rec.delta = price.g[INPUT_S0];
+    rec.gamma = price.hessian(INPUT_S0, INPUT_S0);
+    rec.vega = price.g[INPUT_SIGMA];
+    rec.rho = price.g[INPUT_R];
+    rec.theta = -price.g[INPUT_T];
+    rec.vanna = price.hessian(INPUT_S0, INPUT_SIGMA);
+    rec.volga = price.hessian(INPUT_SIGMA, INPUT_SIGMA);
+    rec.charm = -price.hessian(INPUT_S0, INPUT_T);
+    return rec;
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+// One pass over DualBS inputs gives the price with every first and second derivative
+void EurGreeksBS::evaluate(double T, double K, double S0, double sigma, double r, EurGreeksRecord& call, EurGreeksRecord& put) {
+    GreeksDual callPrice, putPrice;
+    blackScholes(GreeksDual::variable(T, INPUT_T), K, GreeksDual::variable(S0, INPUT_S0),
+        GreeksDual::variable(sigma, INPUT_SIGMA), GreeksDual::variable(r, INPUT_R), callPrice, putPrice);
+    call = toRecord(callPrice);
+    put = toRecord(putPrice);
+}
+
+void EurGreeksBS::evaluateBatch(const EurBSBatchInput& in, const EurGreeksBatchOutput& call, const EurGreeksBatchOutput& put) {
+    EurGreeksRecord callRec, putRec;
+    for (size_t i = 0; i < in.n; ++i) {
+        evaluate(in.T[i], in.K[i], in.S0[i], in.sigma[i], in.r[i], callRec, putRec);
+        store(callRec, call, i);
+        store(putRec, put, i);
+    }
+}
+
+// Central differences, the mixed Greeks from the four corners of each bumped pair
+void EurGreeksBS::bumpAndReprice(double T, double K, double S0, double sigma, double r, EurGreeksRecord& call, EurGreeksRecord& put) {
+    double hS = bumpStep * S0, hSigma = bumpStep * sigma, hR = bumpStep, hT = bumpStep * T;
+    EurBSRecord base = EurBatchBS::evaluate(T, K, S0, sigma, r);
+    EurBSRecord upS = EurBatchBS::evaluate(T, K, S0 + hS, sigma, r);
+    EurBSRecord downS = EurBatchBS::evaluate(T, K, S0 - hS, sigma, r);
+    EurBSRecord upSigma = EurBatchBS::evaluate(T, K, S0, sigma + hSigma, r);
+    EurBSRecord downSigma = EurBatchBS::evaluate(T, K, S0, sigma - hSigma, r);
+    EurBSRecord upR = EurBatchBS::evaluate(T, K, S0, sigma, r + hR);
+    EurBSRecord downR = EurBatchBS::evaluate(T, K, S0, sigma, r - hR);
+    EurBSRecord upT = EurBatchBS::evaluate(T + hT, K, S0, sigma, r);
+    EurBSRecord downT = EurBatchBS::evaluate(T - hT, K, S0, sigma, r);
+    EurBSRecord sigmaCorners[4] = {
+        EurBatchBS::evaluate(T, K, S0 + hS, sigma + hSigma, r), EurBatchBS::evaluate(T, K, S0 + hS, sigma - hSigma, r),
+        EurBatchBS::evaluate(T, K, S0 - hS, sigma + hSigma, r), EurBatchBS::evaluate(T, K, S0 - hS, sigma - hSigma, r) };
+    EurBSRecord timeCorners[4] = {
+        EurBatchBS::evaluate(T + hT, K, S0 + hS, sigma, r), EurBatchBS::evaluate(T - hT, K, S0 + hS, sigma, r),
+        EurBatchBS::evaluate(T + hT, K, S0 - hS, sigma, r), EurBatchBS::evaluate(T - hT, K, S0 - hS, sigma, r) };
+
+    EurGreeksRecord* recs[2] = { &call, &put };
+    for (int p = 0; p < 2; ++p) {
+        double EurBSRecord::* price = p == 0 ? &EurBSRecord::callPrice : &EurBSRecord::putPrice;
+        EurGreeksRecord& rec = *recs[p];
+        rec.price = base.*price;
+        rec.delta = (upS.*price - downS.*price) / (2 * hS);
+        rec.gamma = (upS.*price - 2 * (base.*price) + downS.*price) / (hS * hS);
+        rec.vega = (upSigma.*price - downSigma.*price) / (2 * hSigma);
+        rec.rho = (upR.*price - downR.*price) / (2 * hR);
+        rec.theta = -(upT.*price - downT.*price) / (2 * hT);
+        rec.vanna = (sigmaCorners[0].*price - sigmaCorners[1].*price - sigmaCorners[2].*price + sigmaCorners[3].*price) / (4 * hS * hSigma);
+        rec.volga = (upSigma.*price - 2 * (base.*price) + downSigma.*price) / (hSigma * hSigma);
+        rec.charm = -(timeCorners[0].*price - timeCorners[1].*price - timeCorners[2].*price + timeCorners[3].*price) / (4 * hS * hT);
+    }
+}
+
+void EurGreeksBS::bumpAndRepriceBatch(const EurBSBatchInput& in, const EurGreeksBatchOutput& call, const EurGreeksBatchOutput& put) {
+    EurGreeksRecord callRec, putRec;
+    for (size_t i = 0; i < in.n; ++i) {
+        bumpAndReprice(in.T[i], in.K[i], in.S0[i], in.sigma[i], in.r[i], callRec, putRec);
+        store(callRec, call, i);
+        store(putRec, put, i);
+    }
+}
+
+void EurGreeksBS::store(const EurGreeksRecord& rec, const EurGreeksBatchOutput& out, size_t i) {
+    if (out.price) out.price[i] = rec.price;
+    if (out.delta) out.delta[i] = rec.delta;
+    if (out.gamma) out.gamma[i] = rec.gamma;
+    if (out.vega) out.vega[i] = rec.vega;
+    if (out.rho) out.rho[i] = rec.rho;
+    if (out.theta) out.theta[i] = rec.theta;
+    if (out.vanna) out.vanna[i] = rec.vanna;
+    if (out.volga) out.volga[i] = rec.volga;
+    if (out.charm) out.charm[i] = rec.charm;
+}
@@ -0,0 +1,87 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurGreeksBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the EurGreeksBS Class, the full first and second order
+*					Greeks of European calls and puts in one pass of the Black-Scholes
+*					formula by second order automatic differentiation (DualBS), with
+*					bump and reprice kept to cross-check it.
+*
+*					Inputs    : differentiated with respect to S0, sigma, r and T.
+*					Theta     : -dV/dT and charm -d2V/dS0dT, per year of calendar time
+*					            as the theta of EurCallBS and EurPutBS.
+*					N(x)      : valued by the Abramowitz-Stegun approximation and
+*					            differentiated exactly, so delta, gamma, theta and vega
+*					            equal the closed form Greeks. Bumping differentiates the
+*					            approximation itself and agrees to about 1e-3, less for
+*					            second order Greeks with d1 or d2 within a bump of zero,
+*					            where the approximation has a kink in N''(x).
+*
+* References	:	- Greeks from P. Wilmott Introduces Quantitative Finance, Second Ed.
+*					- E. G. Haug, The Complete Guide to Option Pricing Formulas, Second Ed.
+* Other files	:	DualBS.h, EurBatchBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include "EurBatchBS.h"
+
+using namespace std;
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Price and sensitivities of one option
+struct EurGreeksRecord {
+    double price;
+    double delta;           // dV/dS0
+    double gamma;           // d2V/dS0^2
+    double vega;            // dV/dsigma
+    double rho;             // dV/dr
+    double theta;           // -dV/dT
+    double vanna;           // d2V/dS0dsigma
+    double volga;           // d2V/dsigma^2
+    double charm;           // -d2V/dS0dT
+};
+
+// Output arrays of n values, a null pointer skips that result
+struct EurGreeksBatchOutput {
+    double* price;
+    double* delta;
+    double* gamma;
+    double* vega;
+    double* rho;
+    double* theta;
+    double* vanna;
+    double* volga;
+    double* charm;
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class EurGreeksBS
+{
+    public:
+
+        // Call and put Greeks of one contract from a single differentiated evaluation
+        static void evaluate(double T, double K, double S0, double sigma, double r, EurGreeksRecord& call, EurGreeksRecord& put);
+        static void evaluateBatch(const EurBSBatchInput& in, const EurGreeksBatchOutput& call, const EurGreeksBatchOutput& put);
+
+        // The same Greeks by central differences of EurBatchBS::evaluate, 17 evaluations
+        static void bumpAndReprice(double T, double K, double S0, double sigma, double r, EurGreeksRecord& call, EurGreeksRecord& put);
+        static void bumpAndRepriceBatch(const EurBSBatchInput& in, const EurGreeksBatchOutput& call, const EurGreeksBatchOutput& put);
+
+    private:
+
+        static void store(const EurGreeksRecord& rec, const EurGreeksBatchOutput& out, size_t i);
+};
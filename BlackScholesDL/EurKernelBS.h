@@ -0,0 +1,169 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurKernelBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Compile time specialised Black-Scholes kernels. EurKernelBS is a
+*					template on the payoff (call or put) and on the set of requested
+*					Greeks, with no virtual calls and no object state, so a pricing loop
+*					inlines the whole formula and the Greeks it does not ask for are
+*					never computed. EurCallBS and EurPutBS are thin adapters over it.
+*
+*					Payoff    : the sign of the option, the put formulas are the call
+*					            formulas on N(-d) with the sign flipped, as in EurPutBS.
+*					Greeks    : bitwise or of EurGreek flags, each selects one output.
+*					Cdf       : a backend of NormalCDFBS.h, evaluateSelected and
+*					            EurKernelDispatch use the one selected at run time.
+*					Results   : with CdfAbramowitzStegunBS, bit for bit those of EurCallBS
+*					            and EurPutBS before the adapters, the terms are evaluated
+*					            in the same order.
+*
+* References	:	- M. Abramowitz and I. Stegun, Handbook of Mathematical Functions, 26.2.17
+*                   - Greeks from P. Wilmott Introduces Quantitative Finance, Second Ed.
+* Other files	:	EurOptionBS.h, EurBatchBS.h, NormalCDFBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include "EurBatchBS.h"
+#include "NormalCDFBS.h"
+
+using namespace std;
+
+// Option payoff, the value is the sign applied to the call terms
+enum EurPayoff {
+    PAYOFF_CALL = 1,
+    PAYOFF_PUT = -1
+};
+
+// Results a kernel computes, combined with |
+enum EurGreek {
+    GREEK_PRICE = 1,
+    GREEK_DELTA = 2,
+    GREEK_GAMMA = 4,
+    GREEK_THETA = 8,
+    GREEK_VEGA = 16,
+    GREEK_BATCH = 15,       // The outputs of EurBSBatchOutput
+    GREEK_ALL = 31
+};
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Results of one contract, the fields not requested from the kernel are left at zero
+struct EurKernelResult {
+    double price;
+    double delta;
+    double gamma;
+    double theta;
+    double vega;
+};
+
+// Standard normal density, the CDF backends are in NormalCDFBS.h
+struct EurNormalBS
+{
+    // sqrt(2*pi), the value of sqrt(2.0 * 4.0 * atan(1.0))
+    static double sqrtTwoPi() { return 2.5066282746310002; }
+
+    static inline double pdf(double x) {
+        return exp(-(x * x) / 2.0) / sqrtTwoPi();
+    }
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+template <EurPayoff Payoff, unsigned Greeks = GREEK_ALL, class Cdf = CdfAbramowitzStegunBS>
+struct EurKernelBS
+{
+    // Price and Greeks of one contract, only the requested fields are computed
+    static inline EurKernelResult evaluate(double T, double K, double S0, double sigma, double r) {
+        const double sign = (double)Payoff;
+        const bool needPlus = (Greeks & (GREEK_PRICE | GREEK_DELTA)) != 0;
+        const bool needMinus = (Greeks & (GREEK_PRICE | GREEK_THETA)) != 0;
+        const bool needDensity = (Greeks & (GREEK_GAMMA | GREEK_THETA | GREEK_VEGA)) != 0;
+
+        EurKernelResult res = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+        double sqrtT = sqrt(T);
+        double dPlus = (log(S0 / K) + (r + 0.5 * pow(sigma, 2.0)) * T) / (sigma * sqrtT);
+        double cdfPlus = needPlus ? Cdf::cdf(sign * dPlus) : 0.0;
+        double density = needDensity ? EurNormalBS::pdf(dPlus) : 0.0;
+        double discount = 0.0, cdfMinus = 0.0;
+        if (needMinus) {
+            double dMinus = dPlus - sigma * sqrtT;
+            discount = exp(-r * T);
+            cdfMinus = Cdf::cdf(sign * dMinus);
+        }
+
+        if (Greeks & GREEK_PRICE) res.price = sign * S0 * cdfPlus - sign * (K * discount * cdfMinus);
+        if (Greeks & GREEK_DELTA) res.delta = sign * cdfPlus;
+        if (Greeks & GREEK_GAMMA) res.gamma = density / (sigma * S0 * sqrtT);
+        if (Greeks & GREEK_THETA) res.theta = -((sigma * S0) / (2 * sqrtT)) * density - sign * (r * K * discount * cdfMinus);
+        if (Greeks & GREEK_VEGA) res.vega = S0 * density * sqrtT;
+        return res;
+    }
+
+    // Batch loop of this instantiation, the outputs of the requested Greeks must not be null
+    static void evaluateBatch(const EurBSBatchInput& in, const EurBSBatchOutput& out) {
+        for (size_t i = 0; i < in.n; ++i) {
+            EurKernelResult res = evaluate(in.T[i], in.K[i], in.S0[i], in.sigma[i], in.r[i]);
+            if (Greeks & GREEK_PRICE) out.price[i] = res.price;
+            if (Greeks & GREEK_DELTA) out.delta[i] = res.delta;
+            if (Greeks & GREEK_GAMMA) out.gamma[i] = res.gamma;
+            if (Greeks & GREEK_THETA) out.theta[i] = res.theta;
+        }
+    }
+};
+
+// Runs the EurKernelBS instantiation whose Greeks are the non null outputs of a batch
+template <EurPayoff Payoff, class Cdf, unsigned Greeks = 0>
+struct EurKernelDispatch
+{
+    static void evaluateBatch(unsigned requested, const EurBSBatchInput& in, const EurBSBatchOutput& out) {
+        if (requested == Greeks) EurKernelBS<Payoff, Greeks, Cdf>::evaluateBatch(in, out);
+        else EurKernelDispatch<Payoff, Cdf, Greeks + 1>::evaluateBatch(requested, in, out);
+    }
+};
+
+template <EurPayoff Payoff, class Cdf>
+struct EurKernelDispatch<Payoff, Cdf, GREEK_BATCH + 1>
+{
+    static void evaluateBatch(unsigned, const EurBSBatchInput&, const EurBSBatchOutput&) {}
+};
+
+/****************************************************************************************
+*									FUNCTIONS											*
+****************************************************************************************/
+
+// One contract through the kernel of the CDF backend selected in NormalCDFBS
+template <EurPayoff Payoff, unsigned Greeks>
+inline EurKernelResult evaluateSelected(double T, double K, double S0, double sigma, double r) {
+    switch (NormalCDFBS::getBackend()) {
+    case CDF_FAST: return EurKernelBS<Payoff, Greeks, CdfFastBS>::evaluate(T, K, S0, sigma, r);
+    case CDF_ERFC: return EurKernelBS<Payoff, Greeks, CdfErfcBS>::evaluate(T, K, S0, sigma, r);
+    case CDF_WEST: return EurKernelBS<Payoff, Greeks, CdfWestBS>::evaluate(T, K, S0, sigma, r);
+    default: return EurKernelBS<Payoff, Greeks, CdfAbramowitzStegunBS>::evaluate(T, K, S0, sigma, r);
+    }
+}
+
+// A batch through the kernel of the selected backend and of its non null outputs
+template <EurPayoff Payoff>
+inline void evaluateSelectedBatch(const EurBSBatchInput& in, const EurBSBatchOutput& out) {
+    unsigned requested = (out.price ? GREEK_PRICE : 0) | (out.delta ? GREEK_DELTA : 0)
+        | (out.gamma ? GREEK_GAMMA : 0) | (out.theta ? GREEK_THETA : 0);
+    switch (NormalCDFBS::getBackend()) {
+    case CDF_FAST: EurKernelDispatch<Payoff, CdfFastBS>::evaluateBatch(requested, in, out); break;
+    case CDF_ERFC: EurKernelDispatch<Payoff, CdfErfcBS>::evaluateBatch(requested, in, out); break;
+    case CDF_WEST: EurKernelDispatch<Payoff, CdfWestBS>::evaluateBatch(requested, in, out); break;
+    default: EurKernelDispatch<Payoff, CdfAbramowitzStegunBS>::evaluateBatch(requested, in, out); break;
+    }
+}
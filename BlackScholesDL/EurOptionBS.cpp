@@ -19,6 +19,7 @@
 *								#INCLUDES AND #CONSTANTS								*
 ****************************************************************************************/
 #include "EurOptionBS.h"
+#include "EurKernelBS.h"
 
 /****************************************************************************************
 *									MEMBER FUNCTIONS									*
@@ -53,24 +54,19 @@ double EurOptionBS::dMinus(double S0, double sigma, double r) {
 	return dPlus(S0, sigma, r) - sigma * sqrt(m_T);
 }
 
-// Aproximate the valude of the normal CDF at a given point x.
+// Calculate the Vega using the Black-Scholes model, the same for calls and puts.
+double EurOptionBS::vegaByBSFormula(double S0, double sigma, double r) {
+    return evaluateSelected<PAYOFF_CALL, GREEK_VEGA>(m_T, m_K, S0, sigma, r).vega;
+}
+
+// Aproximate the valude of the normal CDF at a given point x, with the selected backend.
 double EurOptionBS::normalCDF(double x) {
-    double gamma = 0.2316419;     double a1 = 0.319381530;
-    double a2 = -0.356563782;   double a3 = 1.781477937;
-    double a4 = -1.821255978;   double a5 = 1.330274429;
-    double pi = 4.0 * atan(1.0); double k = 1.0 / (1.0 + gamma * x);
-    if (x >= 0.0)
-    {
-        return 1.0 - ((((a5 * k + a4) * k + a3) * k + a2) * k + a1) * k * exp(-x * x / 2.0) / sqrt(2.0 * pi);
-    }
-    else return 1.0 - normalCDF(-x);
+    return NormalCDFBS::cdf(x);
 }
 
 // Aproximate the valude of the normal PDF at a given point x.
 double EurOptionBS::normalPDF(double x) {
-
-    double pi = 4.0 * atan(1.0); 
-    return exp(-(x*x) / 2.0) / sqrt(2.0 * pi);
+    return EurNormalBS::pdf(x);
 }
 
 //Default destructor
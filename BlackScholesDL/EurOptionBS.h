@@ -44,21 +44,24 @@ class EurOptionBS
         virtual double deltaByBSFormula(double S0, double sigma, double r) = 0;
         virtual double gammaByBSFormula(double S0, double sigma, double r) = 0;
         virtual double thetaByBSFormula(double S0, double sigma, double r) = 0;
+        double vegaByBSFormula(double S0, double sigma, double r);
+
+        // Normal distribution helpers, shared with the batch pricers (see EurNormalBS)
+        static double normalCDF(double x);
+        static double normalPDF(double x);
 
         //destructors
-        ~EurOptionBS();
+        virtual ~EurOptionBS();
 
     protected:
 
         // protected Member functions
         double dPlus(double S0, double sigma, double r);
         double dMinus(double S0, double sigma, double r);
-        double normalCDF(double x);
-        double normalPDF(double x);
 
         // protected  Member variables
         double m_T;  // Time to maturity in years 
         double m_K;  // Strike (Exercise) Price
-        string m_type; // String for option type
+        const char* m_type; // Option type, a literal so the objects hold no heap string
 };
 
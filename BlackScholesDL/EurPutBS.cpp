@@ -19,6 +19,7 @@
 *								#INCLUDES AND #CONSTANTS								*
 ****************************************************************************************/
 #include "EurPutBS.h"
+#include "EurKernelBS.h"
 
 /****************************************************************************************
 *									MEMBER FUNCTIONS									*
@@ -33,21 +34,20 @@ double EurPutBS::priceByBSFormula(double S0, double sigma, double r) {
     // S0   : Initial Stock Price
     // sigma: Annualized volatility
     // r    : Annual risk-free interest rate
-   // return S0 * normalCDF(dPlus(S0, sigma, r)) - m_K * exp(-r * m_T) * normalCDF(dMinus(S0, sigma, r));
-    return -S0 * normalCDF(-dPlus(S0, sigma, r)) + m_K * exp(-r * m_T) * normalCDF(-dMinus(S0, sigma, r));
+    return evaluateSelected<PAYOFF_PUT, GREEK_PRICE>(m_T, m_K, S0, sigma, r).price;
 }
 
 // Calculate the Delta of using the Black-Scholes model.
 double EurPutBS::deltaByBSFormula(double S0, double sigma, double r) {
-    return -normalCDF(-dPlus(S0, sigma, r));
+    return evaluateSelected<PAYOFF_PUT, GREEK_DELTA>(m_T, m_K, S0, sigma, r).delta;
 }
 
 // Calculate the Gamma of using the Black-Scholes model.
 double EurPutBS::gammaByBSFormula(double S0, double sigma, double r) {
-    return normalPDF(dPlus(S0, sigma, r)) / (sigma * S0 * sqrt(m_T));
+    return evaluateSelected<PAYOFF_PUT, GREEK_GAMMA>(m_T, m_K, S0, sigma, r).gamma;
 }
 
 // Calculate the Theta of using the Black-Scholes model.
 double EurPutBS::thetaByBSFormula(double S0, double sigma, double r) {
-    return -((sigma * S0) / (2*sqrt(m_T)))* normalPDF(-dPlus(S0, sigma, r)) + r * m_K * exp(-r * m_T) * normalCDF(-dMinus(S0, sigma, r));
-}
\ No newline at end of file
+    return evaluateSelected<PAYOFF_PUT, GREEK_THETA>(m_T, m_K, S0, sigma, r).theta;
+}
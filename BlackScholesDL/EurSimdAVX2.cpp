@@ -0,0 +1,101 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurSimdAVX2.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	AVX2 and FMA instantiation of the EurSimdKernel templates
+*
+* References	:	- Intel Intrinsics Guide, https://software.intel.com/sites/landingpage/IntrinsicsGuide/
+* Other files	:	EurSimdKernel.h, EurSimdBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "EurSimdBS.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+
+// Only the kernels below are compiled for AVX2 and FMA, the library headers above are not
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+#include "EurSimdKernel.h"
+
+/****************************************************************************************
+*									VECTOR TRAITS										*
+****************************************************************************************/
+
+// Four doubles per register with fused multiply-add
+struct VecAVX2
+{
+    typedef __m256d Vec;
+    typedef __m256d Mask;
+    enum { W = 4 };
+
+    static inline Vec set1(double a) { return _mm256_set1_pd(a); }
+    static inline Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    static inline void store(double* p, Vec a) { _mm256_storeu_pd(p, a); }
+    static inline Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    static inline Vec div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+    static inline Vec fmadd(Vec a, Vec b, Vec c) { return _mm256_fmadd_pd(a, b, c); }
+    static inline Vec fnmadd(Vec a, Vec b, Vec c) { return _mm256_fnmadd_pd(a, b, c); }
+    static inline Vec sqrt(Vec a) { return _mm256_sqrt_pd(a); }
+    static inline Vec abs(Vec a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static inline Vec min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+    static inline Vec max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+    static inline Mask lt(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return _mm256_blendv_pd(b, a, m); }
+    static inline Vec round(Vec a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    // 2^n for integral n in [-1022, 1023]
+    static inline Vec pow2(Vec n) {
+        __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(4503599627371519.0)));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52));
+    }
+
+    // x = m * 2^e with m in [0.5, 1), for normal positive x
+    static inline Vec frexp(Vec x, Vec& e) {
+        __m256i bits = _mm256_castpd_si256(x);
+        __m256i biased = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x4330000000000000LL));
+        e = _mm256_sub_pd(_mm256_castsi256_pd(biased), _mm256_set1_pd(4503599627371518.0));
+        __m256i mant = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)), _mm256_set1_epi64x(0x3FE0000000000000LL));
+        return _mm256_castsi256_pd(mant);
+    }
+};
+
+template struct EurSimdKernel<VecAVX2>;
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+/****************************************************************************************
+*										FUNCTIONS										*
+****************************************************************************************/
+
+const EurSimdKernels* eurSimdKernelsAVX2() {
+    typedef EurSimdKernel<VecAVX2> Kernel;
+    static const EurSimdKernels kernels = { SIMD_AVX2, VecAVX2::W, &Kernel::normalCDF, &Kernel::normalPDF,
+        &Kernel::exp, &Kernel::log, &Kernel::evaluateBatch, &Kernel::evaluateBatchFast, &Kernel::dense,
+        &Kernel::scenarioRow };
+    return &kernels;
+}
+
+#else
+
+const EurSimdKernels* eurSimdKernelsAVX2() { return nullptr; }
+
+#endif
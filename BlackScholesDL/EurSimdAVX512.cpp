@@ -0,0 +1,104 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurSimdAVX512.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	AVX-512F instantiation of the EurSimdKernel templates
+*
+* References	:	- Intel Intrinsics Guide, https://software.intel.com/sites/landingpage/IntrinsicsGuide/
+* Other files	:	EurSimdKernel.h, EurSimdBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "EurSimdBS.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+
+// Only the kernels below are compiled for AVX-512F, the library headers above are not
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+// GCC 12 flags the _mm512_undefined placeholders inside its own intrinsics
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "EurSimdKernel.h"
+
+/****************************************************************************************
+*									VECTOR TRAITS										*
+****************************************************************************************/
+
+// Eight doubles per register, comparisons produce a k-mask
+struct VecAVX512
+{
+    typedef __m512d Vec;
+    typedef __mmask8 Mask;
+    enum { W = 8 };
+
+    static inline Vec set1(double a) { return _mm512_set1_pd(a); }
+    static inline Vec load(const double* p) { return _mm512_loadu_pd(p); }
+    static inline void store(double* p, Vec a) { _mm512_storeu_pd(p, a); }
+    static inline Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+    static inline Vec div(Vec a, Vec b) { return _mm512_div_pd(a, b); }
+    static inline Vec fmadd(Vec a, Vec b, Vec c) { return _mm512_fmadd_pd(a, b, c); }
+    static inline Vec fnmadd(Vec a, Vec b, Vec c) { return _mm512_fnmadd_pd(a, b, c); }
+    static inline Vec sqrt(Vec a) { return _mm512_sqrt_pd(a); }
+    static inline Vec abs(Vec a) { return _mm512_abs_pd(a); }
+    static inline Vec min(Vec a, Vec b) { return _mm512_min_pd(a, b); }
+    static inline Vec max(Vec a, Vec b) { return _mm512_max_pd(a, b); }
+    static inline Mask lt(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return _mm512_mask_blend_pd(m, b, a); }
+    static inline Vec round(Vec a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    // 2^n for integral n in [-1022, 1023]
+    static inline Vec pow2(Vec n) {
+        __m512i bits = _mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(4503599627371519.0)));
+        return _mm512_castsi512_pd(_mm512_slli_epi64(bits, 52));
+    }
+
+    // x = m * 2^e with m in [0.5, 1), for normal positive x
+    static inline Vec frexp(Vec x, Vec& e) {
+        __m512i bits = _mm512_castpd_si512(x);
+        __m512i biased = _mm512_or_si512(_mm512_srli_epi64(bits, 52), _mm512_set1_epi64(0x4330000000000000LL));
+        e = _mm512_sub_pd(_mm512_castsi512_pd(biased), _mm512_set1_pd(4503599627371518.0));
+        __m512i mant = _mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL)), _mm512_set1_epi64(0x3FE0000000000000LL));
+        return _mm512_castsi512_pd(mant);
+    }
+};
+
+template struct EurSimdKernel<VecAVX512>;
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+/****************************************************************************************
+*										FUNCTIONS										*
+****************************************************************************************/
+
+const EurSimdKernels* eurSimdKernelsAVX512() {
+    typedef EurSimdKernel<VecAVX512> Kernel;
+    static const EurSimdKernels kernels = { SIMD_AVX512, VecAVX512::W, &Kernel::normalCDF, &Kernel::normalPDF,
+        &Kernel::exp, &Kernel::log, &Kernel::evaluateBatch, &Kernel::evaluateBatchFast, &Kernel::dense,
+        &Kernel::scenarioRow };
+    return &kernels;
+}
+
+#else
+
+const EurSimdKernels* eurSimdKernelsAVX512() { return nullptr; }
+
+#endif
@@ -0,0 +1,166 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurSimdBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the EurSimdBS Class, runtime
+*					detection of the instruction set and the scalar fallback kernels.
+*
+* References	:	- Intel 64 and IA-32 Architectures Software Developer's Manual, CPUID
+* Other files	:	EurSimdSSE2.cpp, EurSimdAVX2.cpp, EurSimdAVX512.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "EurSimdBS.h"
+#include "NormalCDFBS.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+/****************************************************************************************
+*									SCALAR FALLBACK										*
+****************************************************************************************/
+
+static void scalarNormalCDF(size_t n, const double* x, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = CdfAbramowitzStegunBS::cdf(x[i]);
+}
+
+static void scalarNormalPDF(size_t n, const double* x, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = EurOptionBS::normalPDF(x[i]);
+}
+
+static void scalarExp(size_t n, const double* x, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = std::exp(x[i]);
+}
+
+static void scalarLog(size_t n, const double* x, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = std::log(x[i]);
+}
+
+static void scalarDense(size_t rows, size_t inputs, size_t outputs, const double* weights, const double* bias,
+    bool relu, const double* x, double* y) {
+    for (size_t o = 0; o < outputs; ++o) {
+        for (size_t r = 0; r < rows; ++r) {
+            double a = bias[o];
+            for (size_t i = 0; i < inputs; ++i) a += weights[o * inputs + i] * x[i * rows + r];
+            y[o * rows + r] = (relu && a < 0.0) ? 0.0 : a;
+        }
+    }
+}
+
+static void scalarScenarioRow(const EurScenarioRow& row) {
+    for (size_t s = 0; s < row.n; ++s) {
+        double d1 = row.a + row.logShift[s] * row.inverseSd, density = EurOptionBS::normalPDF(d1);
+        double S = row.S0 * row.factor[s];
+        double legPlus = CdfAbramowitzStegunBS::cdf(d1) - row.shift;
+        double legMinus = row.discountedStrike * (CdfAbramowitzStegunBS::cdf(d1 - row.sd) - row.shift);
+        row.value[s] += row.weight * (S * legPlus - legMinus);
+        row.delta[s] += row.weight * legPlus;
+        row.gamma[s] += row.gammaScale * density * row.inverseFactor[s];
+        row.vega[s] += row.vegaScale * row.factor[s] * density;
+        row.theta[s] += row.weight * (row.thetaScale * S * density - row.r * legMinus);
+    }
+}
+
+static const EurSimdKernels scalarKernels = { SIMD_SCALAR, 1, &scalarNormalCDF, &scalarNormalPDF,
+    &scalarExp, &scalarLog, &EurBatchBS::evaluateBatch, &EurBatchBS::evaluateBatch, &scalarDense, &scalarScenarioRow };
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+// Best instruction set supported by both the processor and the operating system
+SimdLevel EurSimdBS::detectLevel() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool avxState = (xcr0 & 0x6) == 0x6;
+    bool avx512State = (xcr0 & 0xE6) == 0xE6;
+    bool avx2 = false, avx512f = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        avx512f = (info[1] & (1 << 16)) != 0;
+    }
+    if (avx512f && avx2 && fma && avx512State) return SIMD_AVX512;
+    if (avx2 && fma && avxState) return SIMD_AVX2;
+    if (sse2) return SIMD_SSE2;
+    return SIMD_SCALAR;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+    return SIMD_SCALAR;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+// Kernel table for a level, falling back to narrower ones not built for this target
+const EurSimdKernels* EurSimdBS::kernelsFor(SimdLevel level) {
+    const EurSimdKernels* kernels = nullptr;
+    if (level >= SIMD_AVX512) kernels = eurSimdKernelsAVX512();
+    if (!kernels && level >= SIMD_AVX2) kernels = eurSimdKernelsAVX2();
+    if (!kernels && level >= SIMD_SSE2) kernels = eurSimdKernelsSSE2();
+    return kernels ? kernels : &scalarKernels;
+}
+
+// Currently selected table, initialized on first use
+const EurSimdKernels*& EurSimdBS::active() {
+    static const EurSimdKernels* kernels = kernelsFor(detectLevel());
+    return kernels;
+}
+
+SimdLevel EurSimdBS::getLevel() { return active()->level; }
+size_t EurSimdBS::getWidth() { return active()->width; }
+
+// Select a level, clamped to what the processor supports; not safe while pricing runs
+SimdLevel EurSimdBS::setLevel(SimdLevel level) {
+    SimdLevel supported = detectLevel();
+    active() = kernelsFor(level < supported ? level : supported);
+    return active()->level;
+}
+
+string EurSimdBS::getLevelName() {
+    switch (getLevel()) {
+    case SIMD_AVX512: return "avx512";
+    case SIMD_AVX2: return "avx2";
+    case SIMD_SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+void EurSimdBS::normalCDF(size_t n, const double* x, double* out) { active()->normalCDF(n, x, out); }
+void EurSimdBS::normalPDF(size_t n, const double* x, double* out) { active()->normalPDF(n, x, out); }
+void EurSimdBS::exp(size_t n, const double* x, double* out) { active()->exp(n, x, out); }
+void EurSimdBS::log(size_t n, const double* x, double* out) { active()->log(n, x, out); }
+
+void EurSimdBS::dense(size_t rows, size_t inputs, size_t outputs, const double* weights, const double* bias,
+    bool relu, const double* x, double* y) {
+    active()->dense(rows, inputs, outputs, weights, bias, relu, x, y);
+}
+
+void EurSimdBS::scenarioRow(const EurScenarioRow& row) { active()->scenarioRow(row); }
+
+// The kernel of the selected CDF backend
+void EurSimdBS::evaluateBatch(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put) {
+    switch (NormalCDFBS::getBackend()) {
+    case CDF_FAST: active()->evaluateBatchFast(in, call, put); break;
+    case CDF_ABRAMOWITZ_STEGUN: active()->evaluateBatch(in, call, put); break;
+    default: EurBatchBS::evaluateBatch(in, call, put); break;
+    }
+}
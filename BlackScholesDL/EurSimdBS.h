@@ -0,0 +1,117 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurSimdBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the EurSimdBS Class, SIMD vectorized normal
+*					distribution, exp, log, Black-Scholes batch and scenario grid kernels
+*					with runtime selection of SSE2, AVX2 or AVX-512.
+*
+* References	:	- M. Abramowitz and I. Stegun, Handbook of Mathematical Functions, 26.2.17
+*					- S. Moshier, Cephes Mathematical Library, exp.c and log.c
+*                   - Greeks from P. Wilmott Introduces Quantitative Finance, Second Ed.
+* Other files	:	EurSimdKernel.h, EurSimdSSE2.cpp, EurSimdAVX2.cpp, EurSimdAVX512.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <string>
+#include "EurBatchBS.h"
+
+using namespace std;
+
+// Instruction sets in increasing order of width
+enum SimdLevel { SIMD_SCALAR = 0, SIMD_SSE2 = 1, SIMD_AVX2 = 2, SIMD_AVX512 = 3 };
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// One position under the spot shocks of one vol shock, the value and Greeks at S0 * factor[s]
+// are added to element s of the outputs; d1 = a + logShift[s] * inverseSd and d2 = d1 - sd
+struct EurScenarioRow {
+    size_t n;                       // Spot shocks in the row
+    const double* logShift;         // ln(1 + shock)
+    const double* factor;           // 1 + shock
+    const double* inverseFactor;    // 1 / (1 + shock)
+    double a, inverseSd, sd;
+    double S0, discountedStrike, r;
+    double shift;                   // 0 for a call, 1 for a put, N(d) - shift are the put legs
+    double weight;                  // Quantity of the position
+    double gammaScale;              // weight / (S0 sigma sqrt(T))
+    double vegaScale;               // weight S0 sqrt(T)
+    double thetaScale;              // -sigma / (2 sqrt(T))
+    double* value;
+    double* delta;
+    double* gamma;
+    double* vega;
+    double* theta;
+};
+
+// Table of kernels implemented once per instruction set
+struct EurSimdKernels {
+    SimdLevel level;
+    size_t width;
+    void (*normalCDF)(size_t n, const double* x, double* out);
+    void (*normalPDF)(size_t n, const double* x, double* out);
+    void (*exp)(size_t n, const double* x, double* out);
+    void (*log)(size_t n, const double* x, double* out);
+    void (*evaluateBatch)(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put);
+    void (*evaluateBatchFast)(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put);
+    void (*dense)(size_t rows, size_t inputs, size_t outputs, const double* weights, const double* bias,
+        bool relu, const double* x, double* y);
+    void (*scenarioRow)(const EurScenarioRow& row);
+};
+
+// Per instruction set tables, null when the build target has no such instructions
+const EurSimdKernels* eurSimdKernelsSSE2();
+const EurSimdKernels* eurSimdKernelsAVX2();
+const EurSimdKernels* eurSimdKernelsAVX512();
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class EurSimdBS
+{
+    public:
+
+        // Instruction set selection, the best supported one is used by default
+        static SimdLevel detectLevel();
+        static SimdLevel getLevel();
+        static SimdLevel setLevel(SimdLevel level);
+        static size_t getWidth();
+        static string getLevelName();
+
+        // Element wise kernels over n contiguous values
+        static void normalCDF(size_t n, const double* x, double* out);
+        static void normalPDF(size_t n, const double* x, double* out);
+        static void exp(size_t n, const double* x, double* out);
+        static void log(size_t n, const double* x, double* out);
+
+        // Vectorized counterpart of EurBatchBS::evaluateBatch. Results agree with it to rounding
+        // level (not bit for bit) and each element is independent of its position in the batch.
+        // The fast and Abramowitz-Stegun CDF backends are vectorized, the accurate ones run
+        // on EurBatchBS::evaluateBatch. The element wise normalCDF is always Abramowitz-Stegun.
+        static void evaluateBatch(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put);
+
+        // Dense neural network layer y = act(W x + b) over a tile of rows, x[i * rows + row],
+        // y[o * rows + row] and W[o * inputs + i]; relu clamps at zero, otherwise linear
+        static void dense(size_t rows, size_t inputs, size_t outputs, const double* weights, const double* bias,
+            bool relu, const double* x, double* y);
+
+        // Add a position to one row of scenario surfaces, fused d1, d2, Abramowitz-Stegun
+        // N(d1), N(d2), density and accumulation without intermediate arrays
+        static void scenarioRow(const EurScenarioRow& row);
+
+    private:
+
+        static const EurSimdKernels* kernelsFor(SimdLevel level);
+        static const EurSimdKernels*& active();
+};
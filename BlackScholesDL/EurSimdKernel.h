@@ -0,0 +1,378 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurSimdKernel.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Generic SIMD kernels for the EurSimdBS Class, written once against
+*					a vector traits class V and instantiated by each instruction set file.
+*					Include only from EurSimdSSE2.cpp, EurSimdAVX2.cpp and EurSimdAVX512.cpp,
+*					after the target options of that file are in effect.
+*
+* References	:	- M. Abramowitz and I. Stegun, Handbook of Mathematical Functions, 26.2.17
+*					- S. Moshier, Cephes Mathematical Library, exp.c and log.c
+*                   - Greeks from P. Wilmott Introduces Quantitative Finance, Second Ed.
+* Other files	:	EurSimdBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include "EurSimdBS.h"
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+// V provides: Vec, Mask, W, set1, load, store, add, sub, mul, div, fmadd (a*b+c),
+// fnmadd (c-a*b), sqrt, abs, min, max, lt, select (m ? a : b), round, pow2, frexp
+template <class V>
+struct EurSimdKernel
+{
+    typedef typename V::Vec Vec;
+    typedef typename V::Mask Mask;
+
+    // exp(x) by Cody-Waite reduction and a degree 12 Taylor polynomial, |r| <= ln(2)/2
+    static inline Vec expV(Vec x) {
+        x = V::min(V::max(x, V::set1(-708.0)), V::set1(709.0));
+        Vec n = V::round(V::mul(x, V::set1(1.4426950408889634074)));
+        Vec r = V::fnmadd(n, V::set1(6.93145751953125E-1), x);
+        r = V::fnmadd(n, V::set1(1.42860682030941723212E-6), r);
+        Vec p = V::set1(2.08767569878680989792E-9);
+        p = V::fmadd(p, r, V::set1(2.50521083854417187751E-8));
+        p = V::fmadd(p, r, V::set1(2.75573192239858906526E-7));
+        p = V::fmadd(p, r, V::set1(2.75573192239858906526E-6));
+        p = V::fmadd(p, r, V::set1(2.48015873015873015873E-5));
+        p = V::fmadd(p, r, V::set1(1.98412698412698412698E-4));
+        p = V::fmadd(p, r, V::set1(1.38888888888888888889E-3));
+        p = V::fmadd(p, r, V::set1(8.33333333333333333333E-3));
+        p = V::fmadd(p, r, V::set1(4.16666666666666666667E-2));
+        p = V::fmadd(p, r, V::set1(1.66666666666666666667E-1));
+        p = V::fmadd(p, r, V::set1(0.5));
+        p = V::fmadd(p, r, V::set1(1.0));
+        p = V::fmadd(p, r, V::set1(1.0));
+        return V::mul(p, V::pow2(n));
+    }
+
+    // log(x) for normal positive x, by 2*atanh(s) with s = f/(2+f) and m = 1+f in [sqrt(0.5), sqrt(2))
+    static inline Vec logV(Vec x) {
+        Vec e;
+        Vec m = V::frexp(x, e);
+        Mask small = V::lt(m, V::set1(0.70710678118654752440));
+        m = V::select(small, V::add(m, m), m);
+        e = V::select(small, V::sub(e, V::set1(1.0)), e);
+        Vec f = V::sub(m, V::set1(1.0));
+        Vec s = V::div(f, V::add(V::set1(2.0), f));
+        Vec s2 = V::mul(s, s);
+        Vec p = V::set1(1.0 / 23.0);
+        p = V::fmadd(p, s2, V::set1(1.0 / 21.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 19.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 17.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 15.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 13.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 11.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 9.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 7.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 5.0));
+        p = V::fmadd(p, s2, V::set1(1.0 / 3.0));
+        Vec twoS = V::add(s, s);
+        Vec logM = V::fmadd(V::mul(twoS, s2), p, twoS);
+        Vec lo = V::fmadd(e, V::set1(1.90821492927058770002E-10), logM);
+        return V::fmadd(e, V::set1(6.93147180369123816490E-1), lo);
+    }
+
+    // Standard normal density
+    static inline Vec pdfV(Vec x) {
+        return V::mul(expV(V::mul(V::set1(-0.5), V::mul(x, x))), V::set1(0.39894228040143267794));
+    }
+
+    // Abramowitz-Stegun polynomial in k, the tail is poly(k) * k * pdf(x)
+    static inline Vec tailV(Vec k, Vec pdf) {
+        Vec poly = V::fmadd(V::set1(1.330274429), k, V::set1(-1.821255978));
+        poly = V::fmadd(poly, k, V::set1(1.781477937));
+        poly = V::fmadd(poly, k, V::set1(-0.356563782));
+        poly = V::fmadd(poly, k, V::set1(0.319381530));
+        return V::mul(V::mul(poly, k), pdf);
+    }
+
+    // Abramowitz-Stegun 26.2.19 tail 0.5 * (1 + d1*x + ... + d6*x^6)^-16, without exp,
+    // the CdfFastBS backend
+    static inline Vec tailFastV(Vec absX) {
+        Vec poly = V::fmadd(V::set1(5.383e-6), absX, V::set1(4.88906e-5));
+        poly = V::fmadd(poly, absX, V::set1(3.80036e-5));
+        poly = V::fmadd(poly, absX, V::set1(3.2776263e-3));
+        poly = V::fmadd(poly, absX, V::set1(2.11410061e-2));
+        poly = V::fmadd(poly, absX, V::set1(4.9867347e-2));
+        poly = V::fmadd(poly, absX, V::set1(1.0));
+        Vec q = V::div(V::set1(1.0), poly);
+        q = V::mul(q, q);
+        q = V::mul(q, q);
+        q = V::mul(q, q);
+        q = V::mul(q, q);
+        return V::mul(V::set1(0.5), q);
+    }
+
+    // N(x) and N(-x) from a tail, the sign is resolved by a select instead of a branch
+    static inline void reflectV(Vec x, Vec tail, Vec& cdfPos, Vec& cdfNeg) {
+        Vec upper = V::sub(V::set1(1.0), tail);
+        Mask negative = V::lt(x, V::set1(0.0));
+        cdfPos = V::select(negative, tail, upper);
+        cdfNeg = V::select(negative, upper, tail);
+    }
+
+    // Standard normal CDF, |x| is clamped at 37 where N(x) is already 0 or 1
+    static inline Vec cdfV(Vec x) {
+        Vec one = V::set1(1.0);
+        Vec absX = V::min(V::abs(x), V::set1(37.0));
+        Vec k = V::div(one, V::fmadd(V::set1(0.2316419), absX, one));
+        Vec cdfPos, cdfNeg;
+        reflectV(x, tailV(k, pdfV(absX)), cdfPos, cdfNeg);
+        return cdfPos;
+    }
+
+    // Apply a lane wise function, the tail runs through a padded block so every
+    // element gets the same instruction sequence wherever it sits in the array
+    template <Vec (*F)(Vec)>
+    static void apply(size_t n, const double* x, double* out) {
+        size_t i = 0;
+        for (; i + V::W <= n; i += V::W) {
+            V::store(out + i, F(V::load(x + i)));
+        }
+        if (i < n) {
+            double xb[V::W], ob[V::W];
+            for (size_t j = 0; j < V::W; ++j) xb[j] = (i + j < n) ? x[i + j] : 1.0;
+            V::store(ob, F(V::load(xb)));
+            for (size_t j = 0; i + j < n; ++j) out[i + j] = ob[j];
+        }
+    }
+
+    static void normalCDF(size_t n, const double* x, double* out) { apply<cdfV>(n, x, out); }
+    static void normalPDF(size_t n, const double* x, double* out) { apply<pdfV>(n, x, out); }
+    static void exp(size_t n, const double* x, double* out) { apply<expV>(n, x, out); }
+    static void log(size_t n, const double* x, double* out) { apply<logV>(n, x, out); }
+
+    static inline void storeIf(double* p, size_t i, Vec a) {
+        if (p) V::store(p + i, a);
+    }
+
+    // Fused call and put price and Greeks for W contracts, mirrors EurBatchBS::evaluate.
+    // Fast selects the CdfFastBS tails, otherwise the Abramowitz-Stegun 26.2.17 ones.
+    template <bool Fast>
+    static inline void evaluateLanes(const double* pT, const double* pK, const double* pS0, const double* pSigma,
+        const double* pR, const EurBSBatchOutput& call, const EurBSBatchOutput& put, size_t i) {
+        Vec T = V::load(pT), K = V::load(pK), S0 = V::load(pS0), sigma = V::load(pSigma), r = V::load(pR);
+        Vec one = V::set1(1.0);
+        Vec sqrtT = V::sqrt(T);
+        Vec sigmaSqrtT = V::mul(sigma, sqrtT);
+        Vec invSigmaSqrtT = V::div(one, sigmaSqrtT);
+        Vec drift = V::fmadd(V::mul(V::set1(0.5), sigma), sigma, r);
+        Vec dPlus = V::mul(V::fmadd(drift, T, logV(V::div(S0, K))), invSigmaSqrtT);
+        Vec dMinus = V::sub(dPlus, sigmaSqrtT);
+        Vec discountK = V::mul(K, expV(V::mul(V::sub(V::set1(0.0), r), T)));
+        // Beyond |d| = 37 the density is below 1e-297 and N(d) is 0 or 1 in double precision;
+        // clamping keeps every product out of the slow subnormal range
+        Vec dLimit = V::set1(37.0);
+        Vec absPlus = V::min(V::abs(dPlus), dLimit);
+        Vec absMinus = V::min(V::abs(dMinus), dLimit);
+        Vec pdfPlus = pdfV(absPlus);
+        Vec nPlus, nNegPlus, nMinus, nNegMinus;
+        if (Fast) {
+            reflectV(dPlus, tailFastV(absPlus), nPlus, nNegPlus);
+            reflectV(dMinus, tailFastV(absMinus), nMinus, nNegMinus);
+        }
+        else {
+            // Both k = 1/(1 + gamma*|d|) from a single division
+            Vec pdfMinus = pdfV(absMinus);
+            Vec denPlus = V::fmadd(V::set1(0.2316419), absPlus, one);
+            Vec denMinus = V::fmadd(V::set1(0.2316419), absMinus, one);
+            Vec invBoth = V::div(one, V::mul(denPlus, denMinus));
+            reflectV(dPlus, tailV(V::mul(denMinus, invBoth), pdfPlus), nPlus, nNegPlus);
+            reflectV(dMinus, tailV(V::mul(denPlus, invBoth), pdfMinus), nMinus, nNegMinus);
+        }
+
+        // sigma/sqrt(T) = sigma^2/(sigma*sqrt(T)) reuses the reciprocal above
+        Vec sigmaOverSqrtT = V::mul(V::mul(sigma, sigma), invSigmaSqrtT);
+        Vec thetaDecay = V::mul(V::mul(V::set1(-0.5), sigmaOverSqrtT), V::mul(S0, pdfPlus));
+        Vec rDiscountK = V::mul(r, discountK);
+
+        storeIf(call.price, i, V::fnmadd(discountK, nMinus, V::mul(S0, nPlus)));
+        storeIf(call.delta, i, nPlus);
+        storeIf(call.theta, i, V::fnmadd(rDiscountK, nMinus, thetaDecay));
+        storeIf(put.price, i, V::fnmadd(S0, nNegPlus, V::mul(discountK, nNegMinus)));
+        storeIf(put.delta, i, V::sub(V::set1(0.0), nNegPlus));
+        storeIf(put.theta, i, V::fmadd(rDiscountK, nNegMinus, thetaDecay));
+        if (call.gamma || put.gamma) {
+            Vec gamma = V::div(V::mul(pdfPlus, invSigmaSqrtT), S0);
+            storeIf(call.gamma, i, gamma);
+            storeIf(put.gamma, i, gamma);
+        }
+    }
+
+    template <bool Fast>
+    static void evaluateBatchWith(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put) {
+        size_t i = 0;
+        for (; i + V::W <= in.n; i += V::W) {
+            evaluateLanes<Fast>(in.T + i, in.K + i, in.S0 + i, in.sigma + i, in.r + i, call, put, i);
+        }
+        if (i < in.n) {
+            // Pad the tail with a benign contract and run it through the same lanes
+            double T[V::W], K[V::W], S0[V::W], sigma[V::W], r[V::W], res[8][V::W];
+            for (size_t j = 0; j < V::W; ++j) {
+                bool live = i + j < in.n;
+                T[j] = live ? in.T[i + j] : 1.0;
+                K[j] = live ? in.K[i + j] : 1.0;
+                S0[j] = live ? in.S0[i + j] : 1.0;
+                sigma[j] = live ? in.sigma[i + j] : 1.0;
+                r[j] = live ? in.r[i + j] : 0.0;
+            }
+            EurBSBatchOutput callTail = { res[0], res[1], res[2], res[3] };
+            EurBSBatchOutput putTail = { res[4], res[5], res[6], res[7] };
+            evaluateLanes<Fast>(T, K, S0, sigma, r, callTail, putTail, 0);
+            double* dst[8] = { call.price, call.delta, call.gamma, call.theta, put.price, put.delta, put.gamma, put.theta };
+            for (int c = 0; c < 8; ++c) {
+                if (!dst[c]) continue;
+                for (size_t j = 0; i + j < in.n; ++j) dst[c][i + j] = res[c][j];
+            }
+        }
+    }
+
+    static void evaluateBatch(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put) {
+        evaluateBatchWith<false>(in, call, put);
+    }
+
+    static void evaluateBatchFast(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put) {
+        evaluateBatchWith<true>(in, call, put);
+    }
+
+    // Fully connected layer y = act(W x + b) with the rows in the lanes, x and y feature major
+    // (x[i * rows + row]) and W row major (W[o * inputs + i]). Two outputs times four row
+    // vectors are accumulated at once, so each x vector loaded from L1 feeds two fmadds and
+    // the eight independent chains hide the fmadd latency.
+    static inline void denseStore(double* out, Vec a, bool relu) {
+        V::store(out, relu ? V::max(a, V::set1(0.0)) : a);
+    }
+
+    static void dense(size_t rows, size_t inputs, size_t outputs, const double* weights, const double* bias,
+        bool relu, const double* x, double* y) {
+        const size_t block = 4 * V::W;
+        size_t o = 0;
+        for (; o + 2 <= outputs; o += 2) {
+            const double* w0 = weights + o * inputs;
+            const double* w1 = w0 + inputs;
+            double* out0 = y + o * rows;
+            double* out1 = out0 + rows;
+            size_t r = 0;
+            for (; r + block <= rows; r += block) {
+                Vec a0 = V::set1(bias[o]), a1 = a0, a2 = a0, a3 = a0;
+                Vec b0 = V::set1(bias[o + 1]), b1 = b0, b2 = b0, b3 = b0;
+                for (size_t i = 0; i < inputs; ++i) {
+                    const double* xi = x + i * rows + r;
+                    Vec x0 = V::load(xi), x1 = V::load(xi + V::W), x2 = V::load(xi + 2 * V::W), x3 = V::load(xi + 3 * V::W);
+                    Vec wa = V::set1(w0[i]), wb = V::set1(w1[i]);
+                    a0 = V::fmadd(wa, x0, a0);
+                    a1 = V::fmadd(wa, x1, a1);
+                    a2 = V::fmadd(wa, x2, a2);
+                    a3 = V::fmadd(wa, x3, a3);
+                    b0 = V::fmadd(wb, x0, b0);
+                    b1 = V::fmadd(wb, x1, b1);
+                    b2 = V::fmadd(wb, x2, b2);
+                    b3 = V::fmadd(wb, x3, b3);
+                }
+                denseStore(out0 + r, a0, relu);
+                denseStore(out0 + r + V::W, a1, relu);
+                denseStore(out0 + r + 2 * V::W, a2, relu);
+                denseStore(out0 + r + 3 * V::W, a3, relu);
+                denseStore(out1 + r, b0, relu);
+                denseStore(out1 + r + V::W, b1, relu);
+                denseStore(out1 + r + 2 * V::W, b2, relu);
+                denseStore(out1 + r + 3 * V::W, b3, relu);
+            }
+            if (r < rows) {
+                denseTail(rows, r, inputs, w0, bias[o], relu, x, out0);
+                denseTail(rows, r, inputs, w1, bias[o + 1], relu, x, out1);
+            }
+        }
+        if (o < outputs) denseTail(rows, 0, inputs, weights + o * inputs, bias[o], relu, x, y + o * rows);
+    }
+
+    // Rows [r, rows) of one output, by whole vectors and then one row at a time
+    static void denseTail(size_t rows, size_t r, size_t inputs, const double* w, double bias, bool relu,
+        const double* x, double* out) {
+        for (; r + V::W <= rows; r += V::W) {
+            Vec a = V::set1(bias);
+            for (size_t i = 0; i < inputs; ++i) a = V::fmadd(V::set1(w[i]), V::load(x + i * rows + r), a);
+            denseStore(out + r, a, relu);
+        }
+        for (; r < rows; ++r) {
+            double a = bias;
+            for (size_t i = 0; i < inputs; ++i) a += w[i] * x[i * rows + r];
+            out[r] = (relu && a < 0.0) ? 0.0 : a;
+        }
+    }
+
+    // W spot shocks of a scenario row from element i, the legs and density as in
+    // evaluateLanes with the put taken as the call with N(d) - 1
+    static inline void scenarioLanes(const EurScenarioRow& row, size_t i) {
+        Vec one = V::set1(1.0);
+        Vec factor = V::load(row.factor + i);
+        Vec dPlus = V::fmadd(V::load(row.logShift + i), V::set1(row.inverseSd), V::set1(row.a));
+        Vec dMinus = V::sub(dPlus, V::set1(row.sd));
+        Vec dLimit = V::set1(37.0);
+        Vec absPlus = V::min(V::abs(dPlus), dLimit);
+        Vec absMinus = V::min(V::abs(dMinus), dLimit);
+        Vec pdfPlus = pdfV(absPlus);
+        Vec denPlus = V::fmadd(V::set1(0.2316419), absPlus, one);
+        Vec denMinus = V::fmadd(V::set1(0.2316419), absMinus, one);
+        Vec invBoth = V::div(one, V::mul(denPlus, denMinus));
+        Vec nPlus, nNegPlus, nMinus, nNegMinus;
+        reflectV(dPlus, tailV(V::mul(denMinus, invBoth), pdfPlus), nPlus, nNegPlus);
+        reflectV(dMinus, tailV(V::mul(denPlus, invBoth), pdfV(absMinus)), nMinus, nNegMinus);
+
+        Vec weight = V::set1(row.weight), shift = V::set1(row.shift);
+        Vec S = V::mul(V::set1(row.S0), factor);
+        Vec legPlus = V::sub(nPlus, shift);
+        Vec legMinus = V::mul(V::set1(row.discountedStrike), V::sub(nMinus, shift));
+        Vec decay = V::mul(V::mul(V::set1(row.thetaScale), S), pdfPlus);
+        V::store(row.value + i, V::fmadd(weight, V::sub(V::mul(S, legPlus), legMinus), V::load(row.value + i)));
+        V::store(row.delta + i, V::fmadd(weight, legPlus, V::load(row.delta + i)));
+        V::store(row.gamma + i, V::fmadd(V::mul(V::set1(row.gammaScale), pdfPlus), V::load(row.inverseFactor + i),
+            V::load(row.gamma + i)));
+        V::store(row.vega + i, V::fmadd(V::mul(V::set1(row.vegaScale), factor), pdfPlus, V::load(row.vega + i)));
+        V::store(row.theta + i, V::fmadd(weight, V::fnmadd(V::set1(row.r), legMinus, decay), V::load(row.theta + i)));
+    }
+
+    static void scenarioRow(const EurScenarioRow& row) {
+        size_t i = 0;
+        for (; i + V::W <= row.n; i += V::W) scenarioLanes(row, i);
+        if (i < row.n) {
+            // Pad the tail with unshocked spots and run it through the same lanes on a copy of
+            // the outputs, so every element is summed the same way wherever it sits in the row
+            double* dst[5] = { row.value, row.delta, row.gamma, row.vega, row.theta };
+            double logShift[V::W], factor[V::W], inverseFactor[V::W], res[5][V::W];
+            for (size_t j = 0; j < V::W; ++j) {
+                bool live = i + j < row.n;
+                logShift[j] = live ? row.logShift[i + j] : 0.0;
+                factor[j] = live ? row.factor[i + j] : 1.0;
+                inverseFactor[j] = live ? row.inverseFactor[i + j] : 1.0;
+                for (int c = 0; c < 5; ++c) res[c][j] = live ? dst[c][i + j] : 0.0;
+            }
+            EurScenarioRow tail = row;
+            tail.logShift = logShift;
+            tail.factor = factor;
+            tail.inverseFactor = inverseFactor;
+            tail.value = res[0];
+            tail.delta = res[1];
+            tail.gamma = res[2];
+            tail.vega = res[3];
+            tail.theta = res[4];
+            scenarioLanes(tail, 0);
+            for (int c = 0; c < 5; ++c) {
+                for (size_t j = 0; i + j < row.n; ++j) dst[c][i + j] = res[c][j];
+            }
+        }
+    }
+};
@@ -0,0 +1,106 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	EurSimdSSE2.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	SSE2 instantiation of the EurSimdKernel templates
+*
+* References	:	- Intel Intrinsics Guide, https://software.intel.com/sites/landingpage/IntrinsicsGuide/
+* Other files	:	EurSimdKernel.h, EurSimdBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "EurSimdBS.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+
+// Only the kernels below are compiled for SSE2, the library headers above are not
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#include "EurSimdKernel.h"
+
+/****************************************************************************************
+*									VECTOR TRAITS										*
+****************************************************************************************/
+
+// Two doubles per register, no fused multiply-add
+struct VecSSE2
+{
+    typedef __m128d Vec;
+    typedef __m128d Mask;
+    enum { W = 2 };
+
+    static inline Vec set1(double a) { return _mm_set1_pd(a); }
+    static inline Vec load(const double* p) { return _mm_loadu_pd(p); }
+    static inline void store(double* p, Vec a) { _mm_storeu_pd(p, a); }
+    static inline Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+    static inline Vec div(Vec a, Vec b) { return _mm_div_pd(a, b); }
+    static inline Vec fmadd(Vec a, Vec b, Vec c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static inline Vec fnmadd(Vec a, Vec b, Vec c) { return _mm_sub_pd(c, _mm_mul_pd(a, b)); }
+    static inline Vec sqrt(Vec a) { return _mm_sqrt_pd(a); }
+    static inline Vec abs(Vec a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static inline Vec min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+    static inline Vec max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+    static inline Mask lt(Vec a, Vec b) { return _mm_cmplt_pd(a, b); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+
+    // Round to nearest even, |a| < 2^51
+    static inline Vec round(Vec a) {
+        Vec magic = _mm_set1_pd(6755399441055744.0);
+        return _mm_sub_pd(_mm_add_pd(a, magic), magic);
+    }
+
+    // 2^n for integral n in [-1022, 1023]
+    static inline Vec pow2(Vec n) {
+        __m128i bits = _mm_castpd_si128(_mm_add_pd(n, _mm_set1_pd(4503599627371519.0)));
+        return _mm_castsi128_pd(_mm_slli_epi64(bits, 52));
+    }
+
+    // x = m * 2^e with m in [0.5, 1), for normal positive x
+    static inline Vec frexp(Vec x, Vec& e) {
+        __m128i bits = _mm_castpd_si128(x);
+        __m128i biased = _mm_or_si128(_mm_srli_epi64(bits, 52), _mm_set1_epi64x(0x4330000000000000LL));
+        e = _mm_sub_pd(_mm_castsi128_pd(biased), _mm_set1_pd(4503599627371518.0));
+        __m128i mant = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL)), _mm_set1_epi64x(0x3FE0000000000000LL));
+        return _mm_castsi128_pd(mant);
+    }
+};
+
+template struct EurSimdKernel<VecSSE2>;
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+/****************************************************************************************
+*										FUNCTIONS										*
+****************************************************************************************/
+
+const EurSimdKernels* eurSimdKernelsSSE2() {
+    typedef EurSimdKernel<VecSSE2> Kernel;
+    static const EurSimdKernels kernels = { SIMD_SSE2, VecSSE2::W, &Kernel::normalCDF, &Kernel::normalPDF,
+        &Kernel::exp, &Kernel::log, &Kernel::evaluateBatch, &Kernel::evaluateBatchFast, &Kernel::dense,
+        &Kernel::scenarioRow };
+    return &kernels;
+}
+
+#else
+
+const EurSimdKernels* eurSimdKernelsSSE2() { return nullptr; }
+
+#endif
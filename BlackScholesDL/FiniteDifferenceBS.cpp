@@ -0,0 +1,356 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	FiniteDifferenceBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the FiniteDifferenceBS Class
+*
+* References	:	- P. Wilmott, Paul Wilmott Introduces Quantitative Finance, Second Ed.
+*					- P. A. Forsyth and K. R. Vetzal, Quadratic convergence for valuing
+*					  American options using a penalty method, SIAM J. Sci. Comput., 2002
+* Other files	:	EurBatchBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <thread>
+
+#include "FiniteDifferenceBS.h"
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// L contracts on the grid of v = V / K over x = S / K, node i of lane l at [i * L + l]. The PDE
+// dv/dtau = alpha_i v(i-1) + beta_i v(i) + gamma_i v(i+1) is stepped from tau = 0 to T with
+// (1 - theta*dt*A) v_new = (1 + (1 - theta)*dt*A) v_old, theta 1/2 for Crank-Nicolson, 1 implicit.
+template <int L>
+struct FdLanes
+{
+    const FiniteDifferenceSpec& spec;
+    size_t N;                                   // Space intervals
+    double h;                                   // Node spacing of x
+    double T[L], sigma[L], r[L], dt[L];
+    bool isCall[L];
+    vector<double> alpha, beta, gamma;          // Operator A, per node and lane
+    vector<double> value, payoff, rhs, work, diag;
+    vector<double> cnUpper, cnInvPivot;         // Thomas factors of the Crank-Nicolson step
+    vector<double> halfUpper, halfInvPivot;     // Thomas factors of the implicit half step
+    long long iterations[L];                    // Constraint iterations of every step
+
+    FdLanes(const FiniteDifferenceSpec& gridSpec) : spec(gridSpec), N(gridSpec.numSpace),
+        h(gridSpec.sMaxMultiple / gridSpec.numSpace) {
+        size_t size = (N + 1) * L;
+        for (vector<double>* v : { &alpha, &beta, &gamma, &value, &payoff, &rhs, &work, &diag,
+            &cnUpper, &cnInvPivot, &halfUpper, &halfInvPivot }) v->assign(size, 0.0);
+    }
+
+    // Boundary values at tau, v(0) and v(xMax)
+    inline void boundaries(int l, double tau, double& low, double& high) const {
+        double discount = exp(-r[l] * tau);
+        low = isCall[l] ? 0.0 : (spec.exercise == FD_AMERICAN ? 1.0 : discount);
+        high = isCall[l] ? spec.sMaxMultiple - discount : 0.0;
+    }
+
+    // LU factors of (1 - theta*step*A), the same for every step of that size
+    void factor(double theta, double stepScale, vector<double>& upper, vector<double>& invPivot) {
+        for (int l = 0; l < L; ++l) upper[l] = 0.0;
+        for (size_t i = 1; i < N; ++i) {
+            for (int l = 0; l < L; ++l) {
+                size_t k = i * L + l;
+                double step = theta * stepScale * dt[l];
+                double pivot = 1.0 - step * beta[k] + step * alpha[k] * upper[k - L];
+                invPivot[k] = 1.0 / pivot;
+                upper[k] = -step * gamma[k] * invPivot[k];
+            }
+        }
+    }
+
+    // Right hand side of one step, with the new boundary values moved to it
+    void buildRhs(double theta, double stepScale, const double* low, const double* high) {
+        for (size_t i = 1; i < N; ++i) {
+            for (int l = 0; l < L; ++l) {
+                size_t k = i * L + l;
+                double explicitStep = (1.0 - theta) * stepScale * dt[l];
+                rhs[k] = value[k] + explicitStep * (alpha[k] * value[k - L] + beta[k] * value[k] + gamma[k] * value[k + L]);
+            }
+        }
+        for (int l = 0; l < L; ++l) {
+            double step = theta * stepScale * dt[l];
+            rhs[L + l] += step * alpha[L + l] * low[l];
+            rhs[(N - 1) * L + l] += step * gamma[(N - 1) * L + l] * high[l];
+            value[l] = low[l];
+            value[N * L + l] = high[l];
+        }
+    }
+
+    // Forward and backward sweeps with the stored factors
+    void thomas(double theta, double stepScale, const vector<double>& upper, const vector<double>& invPivot) {
+        for (int l = 0; l < L; ++l) work[l] = 0.0;
+        for (size_t i = 1; i < N; ++i) {
+            for (int l = 0; l < L; ++l) {
+                size_t k = i * L + l;
+                work[k] = (rhs[k] + theta * stepScale * dt[l] * alpha[k] * work[k - L]) * invPivot[k];
+            }
+        }
+        for (int l = 0; l < L; ++l) value[(N - 1) * L + l] = work[(N - 1) * L + l];
+        for (size_t i = N - 2; i >= 1; --i) {
+            for (int l = 0; l < L; ++l) {
+                size_t k = i * L + l;
+                value[k] = work[k] - upper[k] * value[k + L];
+            }
+        }
+    }
+
+    // Penalty iteration: nodes below the payoff get a large diagonal pulling them onto it,
+    // each pass is a full Thomas solve with that diagonal
+    void penalty(double theta, double stepScale) {
+        double large = 1.0 / spec.tolerance;
+        bool active[L];
+        for (int l = 0; l < L; ++l) active[l] = true;
+        for (int pass = 0; pass < spec.maxIterations; ++pass) {
+            for (int l = 0; l < L; ++l) {
+                work[l] = 0.0;
+                diag[l] = 0.0;
+            }
+            for (size_t i = 1; i < N; ++i) {
+                for (int l = 0; l < L; ++l) {
+                    size_t k = i * L + l;
+                    double step = theta * stepScale * dt[l];
+                    double p = value[k] < payoff[k] ? large : 0.0;
+                    double pivot = 1.0 - step * beta[k] + p + step * alpha[k] * diag[k - L];
+                    double inverse = 1.0 / pivot;
+                    diag[k] = -step * gamma[k] * inverse;
+                    work[k] = (rhs[k] + p * payoff[k] + step * alpha[k] * work[k - L]) * inverse;
+                }
+            }
+            double change[L] = {};
+            for (size_t i = N - 1; i >= 1; --i) {
+                for (int l = 0; l < L; ++l) {
+                    size_t k = i * L + l;
+                    double updated = work[k] - (i < N - 1 ? diag[k] * value[k + L] : 0.0);
+                    change[l] = max(change[l], fabs(updated - value[k]));
+                    value[k] = updated;
+                }
+            }
+            bool any = false;
+            for (int l = 0; l < L; ++l) {
+                if (active[l]) ++iterations[l];
+                active[l] = active[l] && change[l] > spec.tolerance;
+                any = any || active[l];
+            }
+            if (!any) break;
+        }
+    }
+
+    // Projected SOR from the unconstrained solution projected onto the payoff, the boundary
+    // values are already in the right hand side
+    void psor(double theta, double stepScale, const vector<double>& upper, const vector<double>& invPivot) {
+        thomas(theta, stepScale, upper, invPivot);
+        for (size_t k = L; k < N * L; ++k) value[k] = max(value[k], payoff[k]);
+        bool active[L];
+        for (int l = 0; l < L; ++l) active[l] = true;
+        for (int pass = 0; pass < spec.maxIterations; ++pass) {
+            double change[L] = {};
+            for (size_t i = 1; i < N; ++i) {
+                for (int l = 0; l < L; ++l) {
+                    size_t k = i * L + l;
+                    double step = theta * stepScale * dt[l];
+                    double below = i > 1 ? value[k - L] : 0.0, above = i < N - 1 ? value[k + L] : 0.0;
+                    double gaussSeidel = (rhs[k] + step * (alpha[k] * below + gamma[k] * above)) / (1.0 - step * beta[k]);
+                    double updated = max(payoff[k], value[k] + spec.omega * (gaussSeidel - value[k]));
+                    change[l] = max(change[l], fabs(updated - value[k]));
+                    value[k] = updated;
+                }
+            }
+            bool any = false;
+            for (int l = 0; l < L; ++l) {
+                if (active[l]) ++iterations[l];
+                active[l] = active[l] && change[l] > spec.tolerance;
+                any = any || active[l];
+            }
+            if (!any) break;
+        }
+    }
+
+    // One step of size stepScale * dt ending at tauScale * T
+    void step(double theta, double stepScale, double tauScale, const vector<double>& upper, const vector<double>& invPivot) {
+        double low[L], high[L];
+        for (int l = 0; l < L; ++l) boundaries(l, tauScale * T[l], low[l], high[l]);
+        buildRhs(theta, stepScale, low, high);
+        if (spec.exercise == FD_EUROPEAN) thomas(theta, stepScale, upper, invPivot);
+        else if (spec.constraint == FD_PENALTY) penalty(theta, stepScale);
+        else psor(theta, stepScale, upper, invPivot);
+    }
+
+    // March from the payoff at maturity to today
+    void solve() {
+        size_t M = spec.numTime;
+        for (int l = 0; l < L; ++l) {
+            dt[l] = T[l] / M;
+            iterations[l] = 0;
+        }
+        for (size_t i = 0; i <= N; ++i) {
+            double x = i * h;
+            for (int l = 0; l < L; ++l) {
+                size_t k = i * L + l;
+                double diffusion = sigma[l] * sigma[l] * (double)i * i, drift = r[l] * (double)i;
+                alpha[k] = 0.5 * (diffusion - drift);
+                beta[k] = -(diffusion + r[l]);
+                gamma[k] = 0.5 * (diffusion + drift);
+                payoff[k] = spec.exercise == FD_AMERICAN ? max(isCall[l] ? x - 1.0 : 1.0 - x, 0.0) : 0.0;
+                value[k] = max(isCall[l] ? x - 1.0 : 1.0 - x, 0.0);
+            }
+        }
+        factor(1.0, 0.5, halfUpper, halfInvPivot);
+        factor(0.5, 1.0, cnUpper, cnInvPivot);
+
+        // Rannacher start, two implicit half steps in place of the first Crank-Nicolson step
+        step(1.0, 0.5, 0.5 / M, halfUpper, halfInvPivot);
+        step(1.0, 0.5, 1.0 / M, halfUpper, halfInvPivot);
+        for (size_t n = 2; n <= M; ++n) step(0.5, 1.0, (double)n / M, cnUpper, cnInvPivot);
+    }
+
+    // Quadratic through the three nodes closest to x, with its first and second derivatives
+    void interpolate(const vector<double>& v, int l, double x, double& value0, double& first, double& second) const {
+        size_t j = (size_t)min(max(floor(x / h + 0.5), 1.0), (double)(N - 1));
+        double t = x / h - (double)j;
+        double a = v[(j - 1) * L + l], b = v[j * L + l], c = v[(j + 1) * L + l];
+        double slope = 0.5 * (c - a), curvature = c - 2.0 * b + a;
+        value0 = b + t * slope + 0.5 * t * t * curvature;
+        first = (slope + t * curvature) / h;
+        second = curvature / (h * h);
+    }
+
+    // Price and Greeks of lane l at S0, scaled back from the unit strike grid. Theta is -dv/dtau
+    // from the PDE, second order like delta and gamma, and zero where early exercise is optimal.
+    FiniteDifferenceResult result(int l, double K, double S0) const {
+        double x = S0 / K, v, v1, v2;
+        interpolate(value, l, x, v, v1, v2);
+        double exercise = max(isCall[l] ? x - 1.0 : 1.0 - x, 0.0);
+        bool exercised = spec.exercise == FD_AMERICAN && v <= exercise + spec.tolerance;
+        double theta = exercised ? 0.0 : -K * (0.5 * sigma[l] * sigma[l] * x * x * v2 + r[l] * x * v1 - r[l] * v);
+        return { K * v, v1, v2 / K, theta, (double)iterations[l] / spec.numTime };
+    }
+};
+
+// Inputs a grid can price, S0 needs a node on each side of it
+static bool validContract(const FiniteDifferenceSpec& spec, double T, double K, double S0, double sigma, double r) {
+    double xMax = spec.sMaxMultiple * (spec.numSpace - 1) / spec.numSpace;
+    return T > 0 && K > 0 && S0 > 0 && sigma > 0 && isfinite(r) && S0 / K < xMax && isfinite(T * sigma * K);
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+FiniteDifferenceBS::FiniteDifferenceBS() : m_threads(0) {}
+
+//Parametrized constructor
+FiniteDifferenceBS::FiniteDifferenceBS(const FiniteDifferenceSpec& spec) : m_spec(spec), m_threads(0) {}
+
+//accessors
+void FiniteDifferenceBS::setSpec(const FiniteDifferenceSpec& spec) { m_spec = spec; }
+void FiniteDifferenceBS::setThreads(int numThreads) { m_threads = numThreads; }
+FiniteDifferenceSpec FiniteDifferenceBS::getSpec() { return m_spec; }
+int FiniteDifferenceBS::getThreads() { return m_threads; }
+
+bool FiniteDifferenceBS::validSpec() const {
+    return m_spec.numSpace >= 4 && m_spec.numTime >= 1 && m_spec.sMaxMultiple > 1.0 && m_spec.tolerance > 0
+        && m_spec.maxIterations > 0 && m_spec.omega > 0 && m_spec.omega < 2.0;
+}
+
+// Every node of one solve, delta and gamma by central differences, one sided at the ends
+bool FiniteDifferenceBS::solve(double T, double K, double sigma, double r, bool isCall, FiniteDifferenceSurface& surface) const {
+    if (!validSpec() || !validContract(m_spec, T, K, K, sigma, r)) return false;
+    FdLanes<1> grid(m_spec);
+    grid.T[0] = T;
+    grid.sigma[0] = sigma;
+    grid.r[0] = r;
+    grid.isCall[0] = isCall;
+    grid.solve();
+
+    size_t N = m_spec.numSpace;
+    const vector<double>& v = grid.value;
+    surface.S.resize(N + 1);
+    surface.price.resize(N + 1);
+    surface.delta.resize(N + 1);
+    surface.gamma.resize(N + 1);
+    for (size_t i = 0; i <= N; ++i) {
+        size_t j = min(max(i, (size_t)1), N - 1);
+        surface.S[i] = K * i * grid.h;
+        surface.price[i] = K * v[i];
+        surface.delta[i] = i == 0 ? (v[1] - v[0]) / grid.h : i == N ? (v[N] - v[N - 1]) / grid.h : (v[i + 1] - v[i - 1]) / (2.0 * grid.h);
+        surface.gamma[i] = (v[j + 1] - 2.0 * v[j] + v[j - 1]) / (grid.h * grid.h * K);
+    }
+    return true;
+}
+
+bool FiniteDifferenceBS::price(double T, double K, double S0, double sigma, double r, bool isCall, FiniteDifferenceResult& result) const {
+    if (!validSpec() || !validContract(m_spec, T, K, S0, sigma, r)) return false;
+    FdLanes<1> grid(m_spec);
+    grid.T[0] = T;
+    grid.sigma[0] = sigma;
+    grid.r[0] = r;
+    grid.isCall[0] = isCall;
+    grid.solve();
+    result = grid.result(0, K, S0);
+    return true;
+}
+
+// Groups of lanes contracts shared round robin between the threads, contracts the grid
+// cannot price get NaN
+bool FiniteDifferenceBS::priceBatch(const FiniteDifferenceBatchInput& in, const EurBSBatchOutput& out) const {
+    if (!validSpec()) return false;
+    size_t numGroups = (in.n + lanes - 1) / lanes;
+    size_t threads = m_threads > 0 ? (size_t)m_threads : max(1u, thread::hardware_concurrency());
+    threads = min(threads, numGroups);
+    auto work = [this, &in, &out, numGroups, threads](size_t worker) {
+        for (size_t g = worker; g < numGroups; g += threads) {
+            size_t first = g * lanes;
+            priceGroup(in, out, first, min((size_t)lanes, in.n - first));
+        }
+    };
+    if (threads <= 1) {
+        if (numGroups > 0) work(0);
+        return true;
+    }
+    vector<future<void>> workers;
+    for (size_t t = 1; t < threads; ++t) workers.push_back(async(launch::async, work, t));
+    work(0);
+    for (auto& worker : workers) worker.get();
+    return true;
+}
+
+// Contracts [first, first + count), count <= lanes, unused and invalid lanes solve a placeholder
+void FiniteDifferenceBS::priceGroup(const FiniteDifferenceBatchInput& in, const EurBSBatchOutput& out, size_t first, size_t count) const {
+    FdLanes<lanes> grid(m_spec);
+    bool valid[lanes];
+    for (int l = 0; l < lanes; ++l) {
+        size_t i = first + min((size_t)l, count - 1);
+        valid[l] = validContract(m_spec, in.T[i], in.K[i], in.S0[i], in.sigma[i], in.r[i]);
+        grid.T[l] = valid[l] ? in.T[i] : 1.0;
+        grid.sigma[l] = valid[l] ? in.sigma[i] : 0.2;
+        grid.r[l] = valid[l] ? in.r[i] : 0.0;
+        grid.isCall[l] = in.isCall[i] != 0;
+    }
+    grid.solve();
+    for (size_t l = 0; l < count; ++l) {
+        size_t i = first + l;
+        double nan = numeric_limits<double>::quiet_NaN();
+        FiniteDifferenceResult rec = valid[l] ? grid.result((int)l, in.K[i], in.S0[i]) : FiniteDifferenceResult{ nan, nan, nan, nan, 0 };
+        if (out.price) out.price[i] = rec.price;
+        if (out.delta) out.delta[i] = rec.delta;
+        if (out.gamma) out.gamma[i] = rec.gamma;
+        if (out.theta) out.theta[i] = rec.theta;
+    }
+}
@@ -0,0 +1,126 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	FiniteDifferenceBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the FiniteDifferenceBS Class, Crank-Nicolson solution of
+*					the Black-Scholes PDE for European and American calls and puts, giving
+*					the price, delta and gamma over a whole grid of S in one solve.
+*
+*					Grid      : numSpace intervals of S / K in [0, sMaxMultiple], so every
+*					            strike of the same T, sigma and r shares one solve, and
+*					            numTime steps in time, the first one replaced by two fully
+*					            implicit half steps (Rannacher) to damp the payoff kink.
+*					Solver    : Thomas algorithm factored once per step size, then one
+*					            forward and one backward sweep per time step.
+*					Exercise  : American early exercise by a penalty term (Forsyth and
+*					            Vetzal) or by projected SOR.
+*					Batches   : lanes contracts are stepped together, their nodes
+*					            interleaved so the inner loops run over contiguous lanes,
+*					            and groups of lanes are spread over the threads.
+*
+* References	:	- P. Wilmott, Paul Wilmott Introduces Quantitative Finance, Second Ed.,
+*					  chapters 77 and 78
+*					- P. A. Forsyth and K. R. Vetzal, Quadratic convergence for valuing
+*					  American options using a penalty method, SIAM J. Sci. Comput., 2002
+*					- M. Giles and R. Carter, Convergence analysis of Crank-Nicolson and
+*					  Rannacher time-marching, J. Comput. Finance, 2006
+* Other files	:	EurBatchBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "EurBatchBS.h"
+
+using namespace std;
+
+// Exercise style of the contracts
+enum FdExercise { FD_EUROPEAN = 0, FD_AMERICAN = 1 };
+
+// Treatment of the early exercise constraint
+enum FdConstraint { FD_PENALTY = 0, FD_PSOR = 1 };
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Grid and solver settings
+struct FiniteDifferenceSpec {
+    size_t numSpace = 400;          // Intervals of S / K in [0, sMaxMultiple]
+    size_t numTime = 200;           // Time steps to maturity
+    double sMaxMultiple = 4.0;      // Upper S boundary in strikes
+    FdExercise exercise = FD_EUROPEAN;
+    FdConstraint constraint = FD_PENALTY;
+    double tolerance = 1e-8;        // Change per unit strike that stops the constraint iteration
+    int maxIterations = 200;        // Constraint iterations per time step
+    double omega = 1.2;             // PSOR over-relaxation factor in (0, 2)
+};
+
+// Contracts of a batch, each pointer addresses n contiguous values
+struct FiniteDifferenceBatchInput {
+    size_t n;               // Number of contracts
+    const double* T;        // Time to maturity in years
+    const double* K;        // Strike (Exercise) Price
+    const double* S0;       // Initial Stock Price
+    const double* sigma;    // Annualized volatility
+    const double* r;        // Annual risk-free interest rate
+    const char* isCall;     // Non zero for a call, zero for a put
+};
+
+// Price and Greeks of one contract, interpolated at S0
+struct FiniteDifferenceResult {
+    double price;
+    double delta;
+    double gamma;
+    double theta;           // From the PDE at S0, per year of calendar time
+    double iterations;      // Constraint iterations per time step, 0 for European
+};
+
+// Every node of a solve, S from 0 to sMaxMultiple * K
+struct FiniteDifferenceSurface {
+    vector<double> S, price, delta, gamma;
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class FiniteDifferenceBS
+{
+    public:
+
+        //constructors
+        FiniteDifferenceBS();
+        FiniteDifferenceBS(const FiniteDifferenceSpec& spec);
+
+        //accessors
+        void setSpec(const FiniteDifferenceSpec& spec);
+        void setThreads(int numThreads);
+        FiniteDifferenceSpec getSpec();
+        int getThreads();
+
+        // Public Member functions, false on an invalid spec or contract
+        bool solve(double T, double K, double sigma, double r, bool isCall, FiniteDifferenceSurface& surface) const;
+        bool price(double T, double K, double S0, double sigma, double r, bool isCall, FiniteDifferenceResult& result) const;
+        bool priceBatch(const FiniteDifferenceBatchInput& in, const EurBSBatchOutput& out) const;
+
+        // Contracts stepped together by priceBatch
+        static const int lanes = 4;
+
+    private:
+
+        // private Member functions
+        bool validSpec() const;
+        void priceGroup(const FiniteDifferenceBatchInput& in, const EurBSBatchOutput& out, size_t first, size_t count) const;
+
+        // private  Member variables
+        FiniteDifferenceSpec m_spec;    // Grid and solver settings
+        int m_threads;                  // Threads of priceBatch, 0 uses every hardware thread
+};
@@ -0,0 +1,270 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ImpliedVolBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the ImpliedVolBS Class
+*
+* References	:	- P. Jaeckel, Let's be rational, Wilmott Magazine, January 2015
+*					- C. Corrado and T. Miller, A note on a simple, accurate formula to
+*					  compute implied standard deviations, J. Banking & Finance, 1996
+* Other files	:	EurSimdBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "ImpliedVolBS.h"
+#include "EurSimdBS.h"
+
+static const double pi = 4.0 * atan(1.0);
+static const double sqrtTwoPi = sqrt(2.0 * pi);
+static const double infinity = numeric_limits<double>::infinity();
+
+// Out of class definition, min() binds blockSize by reference
+const size_t ImpliedVolBS::blockSize;
+
+// Slope of the Abramowitz-Stegun CDF of EurOptionBS at x, given |x|, k = 1/(1 + 0.2316419|x|)
+// and phi(x). The pricers use that approximation, whose slope differs from phi by up to a few
+// percent in the tails; Newton steps taken with phi would only converge linearly out there.
+static inline double normalCDFSlope(double y, double k, double phi) {
+    double poly = ((((1.330274429 * k - 1.821255978) * k + 1.781477937) * k - 0.356563782) * k + 0.319381530) * k;
+    double polySlope = (((5.0 * 1.330274429 * k - 4.0 * 1.821255978) * k + 3.0 * 1.781477937) * k - 2.0 * 0.356563782) * k + 0.319381530;
+    return phi * (y * poly + 0.2316419 * k * k * polySlope);
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+ImpliedVolBS::ImpliedVolBS() : m_tolerance(1e-12), m_maxIterations(32), m_threads(1) {
+}
+
+//Parametrized constructor
+ImpliedVolBS::ImpliedVolBS(double tolerance, int maxIterations) :
+    m_tolerance(tolerance), m_maxIterations(maxIterations), m_threads(1) {
+}
+
+//accessors
+void ImpliedVolBS::setTolerance(double tolerance) { m_tolerance = tolerance; }
+void ImpliedVolBS::setMaxIterations(int maxIterations) { m_maxIterations = maxIterations; }
+void ImpliedVolBS::setThreads(int numThreads) { m_threads = numThreads; }
+double ImpliedVolBS::getTolerance() { return m_tolerance; }
+int ImpliedVolBS::getMaxIterations() { return m_maxIterations; }
+int ImpliedVolBS::getThreads() { return m_threads; }
+
+// Implied volatility of a single quote
+ImpliedVolResult ImpliedVolBS::solve(double price, double T, double K, double S0, double r, bool isCall) const {
+    char call = isCall ? 1 : 0;
+    double sigma = 0;
+    int iterations = 0, status = IMPLIED_INVALID_INPUT;
+    ImpliedVolBatchInput in = { 1, &price, &T, &K, &S0, &r, &call };
+    ImpliedVolBatchOutput out = { &sigma, &iterations, &status };
+    solveBlock(in, out, 0, 1);
+    return { sigma, iterations, (ImpliedVolStatus)status };
+}
+
+// Implied volatilities of a whole chain, blocks are shared round robin between the threads
+void ImpliedVolBS::solveBatch(const ImpliedVolBatchInput& in, const ImpliedVolBatchOutput& out) const {
+    size_t numBlocks = (in.n + blockSize - 1) / blockSize;
+    size_t threads = m_threads > 0 ? (size_t)m_threads : max(1u, thread::hardware_concurrency());
+    threads = min(threads, numBlocks);
+    auto work = [this, &in, &out, numBlocks, threads](size_t worker) {
+        for (size_t b = worker; b < numBlocks; b += threads) {
+            size_t first = b * blockSize;
+            solveBlock(in, out, first, min(blockSize, in.n - first));
+        }
+    };
+    if (threads <= 1) {
+        if (numBlocks > 0) work(0);
+        return;
+    }
+    vector<future<void>> workers;
+    for (size_t t = 1; t < threads; ++t) workers.push_back(async(launch::async, work, t));
+    work(0);
+    for (auto& worker : workers) worker.get();
+}
+
+// Solve quotes [first, first + count), count <= blockSize.
+// Every quote is reduced to an out of the money call on a unit forward: with x = -|ln(F/K)|
+// and s = sigma*sqrt(T) its normalized price b(s) = e^(x/2) N(x/s + s/2) - e^(-x/2) N(x/s - s/2)
+// increases in s and has one inflection point at sc = sqrt(2|x|). Below b(sc) the iteration
+// runs on ln b, above it on b, so each objective is well conditioned on its side; a bracket
+// [lo, hi] around the root, narrowed after every evaluation, rejects Householder steps that
+// would leave it and bisects instead, which bounds the iteration even for extreme quotes.
+void ImpliedVolBS::solveBlock(const ImpliedVolBatchInput& in, const ImpliedVolBatchOutput& out, size_t first, size_t count) const {
+    double x[blockSize], target[blockSize], resolution[blockSize], ex2[blockSize], emx2[blockSize], sqrtT[blockSize];
+    double s[blockSize], invS[blockSize], lo[blockSize], hi[blockSize], price[blockSize], work[blockSize];
+    double d[2 * blockSize], cdf[2 * blockSize], pdf[blockSize];
+    bool lower[blockSize];
+    int iterations[blockSize], status[blockSize];
+    size_t active[blockSize];
+    size_t m = 0;
+    work[0] = d[0] = 0;
+
+    // Normalize every valid quote; exp(rT), ln(F/K) and exp(x/2) each take one vector pass
+    for (size_t i = 0; i < count; ++i) {
+        size_t j = first + i;
+        iterations[i] = 0;
+        s[i] = 0;
+        status[i] = IMPLIED_INVALID_INPUT;
+        if (in.T[j] > 0 && in.K[j] > 0 && in.S0[j] > 0 && isfinite(in.price[j] + in.T[j] + in.K[j] + in.S0[j] + in.r[j])) {
+            work[m] = in.r[j] * in.T[j];
+            active[m++] = i;
+        }
+    }
+    EurSimdBS::exp(m, work, pdf);
+    for (size_t a = 0; a < m; ++a) {
+        size_t j = first + active[a];
+        double F = in.S0[j] * pdf[a];
+        double forwardPrice = in.price[j] * pdf[a];
+        double intrinsic = in.isCall[j] ? F - in.K[j] : in.K[j] - F;
+        double scale = 1.0 / sqrt(F * in.K[j]);
+        target[active[a]] = (intrinsic > 0 ? forwardPrice - intrinsic : forwardPrice) * scale;
+        resolution[active[a]] = 4.0 * numeric_limits<double>::epsilon() * forwardPrice * scale;
+        work[a] = F / in.K[j];
+    }
+    EurSimdBS::log(m, work, cdf);
+    for (size_t a = 0; a < m; ++a) {
+        x[active[a]] = -fabs(cdf[a]);
+        work[a] = 0.5 * x[active[a]];
+    }
+    EurSimdBS::exp(m, work, pdf);
+
+    // Reject quotes outside the no arbitrage bounds, store -sc to evaluate N(-sc) in one pass
+    size_t numValid = m;
+    m = 0;
+    for (size_t a = 0; a < numValid; ++a) {
+        size_t i = active[a];
+        ex2[i] = pdf[a];
+        emx2[i] = 1.0 / ex2[i];
+        sqrtT[i] = sqrt(in.T[first + i]);
+        if (!(target[i] > 0)) status[i] = IMPLIED_BELOW_INTRINSIC;
+        else if (target[i] >= ex2[i]) status[i] = IMPLIED_ABOVE_MAXIMUM;
+        else {
+            status[i] = IMPLIED_NOT_CONVERGED;
+            d[m] = -sqrt(-2.0 * x[i]);
+            active[m++] = i;
+        }
+    }
+    EurSimdBS::normalCDF(m, d, cdf);
+
+    // Bracket from the inflection point and the Corrado-Miller initial guess
+    for (size_t a = 0; a < m; ++a) {
+        size_t i = active[a];
+        double sc = -d[a];
+        double inflection = 0.5 * ex2[i] - emx2[i] * cdf[a];
+        double half = 0.5 * (ex2[i] - emx2[i]);
+        double excess = target[i] - half;
+        double root = excess * excess - 4.0 * half * half / pi;
+        double guess = sqrtTwoPi / (ex2[i] + emx2[i]) * (excess + sqrt(max(root, 0.0)));
+        lower[i] = target[i] < inflection;
+        lo[i] = lower[i] ? 0.0 : sc;
+        hi[i] = lower[i] ? sc : infinity;
+        s[i] = (guess > lo[i] && guess < hi[i]) ? guess : (lower[i] ? 0.5 * sc : max(sc, 2.0 * guess));
+        if (!(s[i] > 0)) s[i] = 1.0;
+    }
+
+    for (int k = 0; k < m_maxIterations && m > 0; ++k) {
+
+        // d1 in d[0, m), d2 in d[m, 2m), N of both and phi(d1) in two vector passes
+        for (size_t a = 0; a < m; ++a) {
+            size_t i = active[a];
+            invS[a] = 1.0 / s[i];
+            d[a] = x[i] * invS[a] + 0.5 * s[i];
+            d[m + a] = d[a] - s[i];
+        }
+        EurSimdBS::normalCDF(2 * m, d, cdf);
+        EurSimdBS::normalPDF(m, d, pdf);
+
+        // Normalized prices, and their ratio to the target for the ln b objective
+        for (size_t a = 0; a < m; ++a) {
+            size_t i = active[a];
+            price[a] = ex2[i] * cdf[a] - emx2[i] * cdf[m + a];
+            work[a] = lower[i] && price[a] > 0 ? price[a] / target[i] : 1.0;
+        }
+        EurSimdBS::log(m, work, cdf);
+
+        size_t remaining = 0;
+        for (size_t a = 0; a < m; ++a) {
+            size_t i = active[a];
+            double si = s[i];
+            double b = price[a];
+            double xOverS = x[i] * invS[a], xOverS2 = xOverS * invS[a];
+
+            // b'(s) from the slopes at d1 and d2, both k from a single division;
+            // e^(x/2) phi(d1) = e^(-x/2) phi(d2) so phi(d1) serves both terms
+            double y1 = fabs(d[a]), y2 = fabs(d[m + a]);
+            double den1 = 1.0 + 0.2316419 * y1, den2 = 1.0 + 0.2316419 * y2;
+            double invBoth = 1.0 / (den1 * den2);
+            double vega = ex2[i] * (normalCDFSlope(y1, den2 * invBoth, pdf[a]) * (0.5 - xOverS2)
+                + normalCDFSlope(y2, den1 * invBoth, pdf[a]) * (0.5 + xOverS2));
+            ++iterations[i];
+
+            // Ratios b''/b' and b'''/b' of the normalized price
+            double gamma2 = xOverS2 * xOverS - 0.25 * si;
+            double gamma3 = gamma2 * gamma2 - 3.0 * xOverS2 * xOverS2 - 0.25;
+
+            double g, gPrime;
+            bool valid = vega > 0;
+            if (lower[i]) {
+                valid = valid && b > 0;
+                double u = vega / b;
+                g = valid ? cdf[a] : -infinity;
+                gPrime = u;
+                gamma3 = gamma3 - 3.0 * gamma2 * u + 2.0 * u * u;
+                gamma2 = gamma2 - u;
+            }
+            else {
+                g = b - target[i];
+                gPrime = vega;
+            }
+            if (g < 0) lo[i] = max(lo[i], si);
+            else hi[i] = min(hi[i], si);
+
+            // Matched to the rounding of the quote: deep in the money quotes carry too little
+            // time value to resolve sigma any further
+            if (fabs(b - target[i]) <= resolution[i]) {
+                status[i] = IMPLIED_OK;
+                continue;
+            }
+
+            // Third order Householder step, bisection when it is unusable or leaves the bracket
+            double next = -1.0;
+            if (valid) {
+                double nu = -g / gPrime;
+                next = si + nu * (1.0 + 0.5 * nu * gamma2) / (1.0 + nu * (gamma2 + nu * gamma3 / 6.0));
+            }
+            if (!(next >= lo[i] && next <= hi[i])) {
+                next = isinf(hi[i]) ? 2.0 * si : 0.5 * (lo[i] + hi[i]);
+            }
+            s[i] = next;
+
+            if (fabs(next - si) <= m_tolerance * next || hi[i] - lo[i] <= m_tolerance * next) {
+                status[i] = IMPLIED_OK;
+            }
+            else {
+                active[remaining++] = i;
+            }
+        }
+        m = remaining;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        bool solved = status[i] == IMPLIED_OK || status[i] == IMPLIED_NOT_CONVERGED;
+        if (out.sigma) out.sigma[first + i] = solved ? s[i] / sqrtT[i] : numeric_limits<double>::quiet_NaN();
+        if (out.iterations) out.iterations[first + i] = iterations[i];
+        if (out.status) out.status[first + i] = status[i];
+    }
+}
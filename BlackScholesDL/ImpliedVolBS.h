@@ -0,0 +1,100 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ImpliedVolBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the ImpliedVolBS Class, implied volatility of European
+*					options from quoted prices, one at a time or over whole option chains.
+*
+* References	:	- P. Jaeckel, Let's be rational, Wilmott Magazine, January 2015
+*					- C. Corrado and T. Miller, A note on a simple, accurate formula to
+*					  compute implied standard deviations, J. Banking & Finance, 1996
+* Other files	:	EurSimdBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+
+using namespace std;
+
+// Outcome of a solve, sigma is NaN unless IMPLIED_OK or IMPLIED_NOT_CONVERGED
+enum ImpliedVolStatus {
+    IMPLIED_OK = 0,                 // Converged to the tolerance
+    IMPLIED_NOT_CONVERGED = 1,      // Iteration limit reached, sigma is the last iterate
+    IMPLIED_BELOW_INTRINSIC = 2,    // Price at or below the discounted intrinsic value
+    IMPLIED_ABOVE_MAXIMUM = 3,      // Call above S0, or put above the discounted strike
+    IMPLIED_INVALID_INPUT = 4       // Non positive T, K or S0, or a non finite input
+};
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Quotes of n options, each pointer addresses n contiguous values
+struct ImpliedVolBatchInput {
+    size_t n;               // Number of quotes
+    const double* price;    // Quoted option price
+    const double* T;        // Time to maturity in years
+    const double* K;        // Strike (Exercise) Price
+    const double* S0;       // Initial Stock Price
+    const double* r;        // Annual risk-free interest rate
+    const char* isCall;     // Non zero for a call, zero for a put
+};
+
+// Output arrays of n values, a null pointer skips that result
+struct ImpliedVolBatchOutput {
+    double* sigma;          // Implied annualized volatility
+    int* iterations;        // Iterations taken by each quote
+    int* status;            // ImpliedVolStatus of each quote
+};
+
+// Result of a single solve
+struct ImpliedVolResult {
+    double sigma;
+    int iterations;
+    ImpliedVolStatus status;
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class ImpliedVolBS
+{
+    public:
+
+        //constructors
+        ImpliedVolBS();
+        ImpliedVolBS(double tolerance, int maxIterations);
+
+        //accessors
+        void setTolerance(double tolerance);
+        void setMaxIterations(int maxIterations);
+        void setThreads(int numThreads);
+        double getTolerance();
+        int getMaxIterations();
+        int getThreads();
+
+        // Public Member functions
+        ImpliedVolResult solve(double price, double T, double K, double S0, double r, bool isCall) const;
+        void solveBatch(const ImpliedVolBatchInput& in, const ImpliedVolBatchOutput& out) const;
+
+        // Quotes iterated together, every pass prices the unconverged ones with the SIMD kernels
+        static const size_t blockSize = 256;
+
+    private:
+
+        // private Member functions
+        void solveBlock(const ImpliedVolBatchInput& in, const ImpliedVolBatchOutput& out, size_t first, size_t count) const;
+
+        // private  Member variables
+        double m_tolerance;         // Relative change of sigma*sqrt(T) that stops the iteration
+        int m_maxIterations;        // Iteration limit per quote
+        int m_threads;              // Threads of solveBatch, 0 uses every hardware thread
+};
@@ -0,0 +1,565 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	MlpPricerBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the MlpPricerBS Class
+*
+* References	:	- ECMA-404, The JSON data interchange syntax, 2017
+* Other files	:	EurSimdBS.cpp, SamplerBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <thread>
+
+#include "CounterRNG.h"
+#include "EurSimdBS.h"
+#include "MlpPricerBS.h"
+
+// Bytes of L1 given to the two activation buffers of a tile
+static const size_t tileBytes = 32768;
+
+// Rows sampled and priced at a time by measureAccuracy
+static const size_t accuracyChunk = 1 << 18;
+
+// Nesting limit of a JSON document
+static const int maxJsonDepth = 32;
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// Run work(first, count) over blocks of blockRows rows, the blocks taken round robin by
+// the threads as in ImpliedVolBS::solveBatch
+template <class Work>
+static void runBlocks(size_t n, size_t blockRows, int numThreads, Work work) {
+    size_t numBlocks = (n + blockRows - 1) / blockRows;
+    size_t threads = numThreads > 0 ? (size_t)numThreads : max(1u, thread::hardware_concurrency());
+    threads = min(threads, numBlocks);
+    auto worker = [&work, n, blockRows, numBlocks, threads](size_t t) {
+        for (size_t b = t; b < numBlocks; b += threads) {
+            size_t first = b * blockRows;
+            work(first, min(blockRows, n - first));
+        }
+    };
+    if (threads <= 1) {
+        if (numBlocks > 0) worker(0);
+        return;
+    }
+    vector<future<void>> workers;
+    for (size_t t = 1; t < threads; ++t) workers.push_back(async(launch::async, worker, t));
+    worker(0);
+    for (auto& w : workers) w.get();
+}
+
+// Column of a feature in a batch
+static const double* featureColumn(const EurBSBatchInput& in, MlpFeature feature) {
+    switch (feature) {
+    case MLP_T: return in.T;
+    case MLP_K: return in.K;
+    case MLP_S0: return in.S0;
+    case MLP_SIGMA: return in.sigma;
+    default: return in.r;
+    }
+}
+
+// Minimal JSON document, enough for a model file: objects, arrays, numbers and strings
+struct JsonValue {
+    enum Type { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT } type = JSON_NULL;
+    double number = 0;
+    string text;
+    vector<string> keys;        // Object member names, items holds their values
+    vector<JsonValue> items;
+
+    const JsonValue* find(const string& key) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) return &items[i];
+        }
+        return nullptr;
+    }
+};
+
+class JsonReader
+{
+    public:
+
+        JsonReader(const string& text) : m_p(text.c_str()), m_end(text.c_str() + text.size()) {}
+
+        // The whole text must be one value
+        bool parse(JsonValue& value) {
+            if (!parseValue(value, 0)) return false;
+            skipSpace();
+            return m_p == m_end;
+        }
+
+    private:
+
+        void skipSpace() {
+            while (m_p < m_end && (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r')) ++m_p;
+        }
+
+        bool literal(const char* word) {
+            size_t length = strlen(word);
+            if ((size_t)(m_end - m_p) < length || strncmp(m_p, word, length) != 0) return false;
+            m_p += length;
+            return true;
+        }
+
+        // Escapes are kept as the escaped character, names in a model file are plain ASCII
+        bool parseString(string& out) {
+            if (m_p >= m_end || *m_p != '"') return false;
+            for (++m_p; m_p < m_end && *m_p != '"'; ++m_p) {
+                if (*m_p == '\\' && ++m_p >= m_end) return false;
+                out += *m_p;
+            }
+            if (m_p >= m_end) return false;
+            ++m_p;
+            return true;
+        }
+
+        bool parseValue(JsonValue& value, int depth) {
+            skipSpace();
+            if (m_p >= m_end || depth > maxJsonDepth) return false;
+            if (*m_p == '{' || *m_p == '[') {
+                bool isObject = *m_p == '{';
+                char close = isObject ? '}' : ']';
+                value.type = isObject ? JsonValue::JSON_OBJECT : JsonValue::JSON_ARRAY;
+                ++m_p;
+                skipSpace();
+                if (m_p < m_end && *m_p == close) {
+                    ++m_p;
+                    return true;
+                }
+                while (true) {
+                    if (isObject) {
+                        value.keys.emplace_back();
+                        skipSpace();
+                        if (!parseString(value.keys.back())) return false;
+                        skipSpace();
+                        if (m_p >= m_end || *m_p++ != ':') return false;
+                    }
+                    value.items.emplace_back();
+                    if (!parseValue(value.items.back(), depth + 1)) return false;
+                    skipSpace();
+                    if (m_p >= m_end) return false;
+                    if (*m_p == ',') {
+                        ++m_p;
+                        continue;
+                    }
+                    return *m_p++ == close;
+                }
+            }
+            if (*m_p == '"') {
+                value.type = JsonValue::JSON_STRING;
+                return parseString(value.text);
+            }
+            if (literal("true") || literal("false")) {
+                value.type = JsonValue::JSON_BOOL;
+                value.number = m_p[-2] == 'u';
+                return true;
+            }
+            if (literal("null")) return true;
+            // strtod stops at the first character that is not part of a number, and the text
+            // is null terminated so it never reads past m_end
+            char* stop = nullptr;
+            value.type = JsonValue::JSON_NUMBER;
+            value.number = strtod(m_p, &stop);
+            if (stop == m_p) return false;
+            m_p = stop;
+            return true;
+        }
+
+        const char* m_p;
+        const char* m_end;
+};
+
+// Array of numbers into values
+static bool jsonNumbers(const JsonValue* array, vector<double>& values) {
+    if (!array || array->type != JsonValue::JSON_ARRAY) return false;
+    values.clear();
+    for (const JsonValue& item : array->items) {
+        if (item.type != JsonValue::JSON_NUMBER) return false;
+        values.push_back(item.number);
+    }
+    return true;
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+MlpPricerBS::MlpPricerBS() : m_width(0), m_tileRows(0), m_threads(0) {}
+
+//Parametrized constructor
+MlpPricerBS::MlpPricerBS(const MlpModel& model) : MlpPricerBS() {
+    setModel(model);
+}
+
+//accessors
+const MlpModel& MlpPricerBS::getModel() const { return m_model; }
+void MlpPricerBS::setThreads(int numThreads) { m_threads = numThreads; }
+int MlpPricerBS::getThreads() { return m_threads; }
+size_t MlpPricerBS::getTileRows() const { return m_tileRows; }
+bool MlpPricerBS::isLoaded() const { return !m_model.layers.empty(); }
+string MlpPricerBS::getError() { return m_error; }
+
+size_t MlpPricerBS::getNumParameters() const {
+    size_t parameters = 0;
+    for (const MlpLayer& layer : m_model.layers) parameters += layer.weights.size() + layer.bias.size();
+    return parameters;
+}
+
+// Use a model, the tile keeps both activation buffers of the widest layer in tileBytes, in
+// multiples of 32 rows (four AVX-512 vectors, the register block of the dense kernel)
+bool MlpPricerBS::setModel(const MlpModel& model) {
+    if (!validModel(model)) return false;
+    m_model = model;
+    m_width = model.features.size();
+    for (const MlpLayer& layer : model.layers) m_width = max(m_width, layer.outputs);
+    m_tileRows = min((size_t)256, max((size_t)32, tileBytes / (2 * sizeof(double) * m_width) / 32 * 32));
+    return true;
+}
+
+string MlpPricerBS::getFeatureName(MlpFeature feature) {
+    switch (feature) {
+    case MLP_T: return "T";
+    case MLP_K: return "K";
+    case MLP_S0: return "S0";
+    case MLP_SIGMA: return "sigma";
+    default: return "r";
+    }
+}
+
+bool MlpPricerBS::parseFeature(const string& name, MlpFeature& feature) {
+    for (int f = MLP_T; f < MLP_FEATURES; ++f) {
+        if (name == getFeatureName((MlpFeature)f)) {
+            feature = (MlpFeature)f;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Shapes must chain from the features to a single output and every value must be finite
+bool MlpPricerBS::validModel(const MlpModel& model) {
+    size_t numFeatures = model.features.size();
+    if (numFeatures == 0 || numFeatures > MLP_FEATURES || model.inputScale.size() != numFeatures) {
+        m_error = "The model needs 1 to 5 features, each with an input scale";
+        return false;
+    }
+    for (size_t f = 0; f < numFeatures; ++f) {
+        if (model.features[f] < MLP_T || model.features[f] >= MLP_FEATURES || !isfinite(model.inputScale[f])
+            || model.inputScale[f] == 0) {
+            m_error = "Unknown feature or zero input scale";
+            return false;
+        }
+    }
+    if (model.layers.empty() || model.layers.size() > maxLayers || !isfinite(model.outputScale)) {
+        m_error = "The model needs 1 to 64 layers and a finite output scale";
+        return false;
+    }
+    size_t inputs = numFeatures;
+    for (size_t l = 0; l < model.layers.size(); ++l) {
+        const MlpLayer& layer = model.layers[l];
+        if (layer.inputs != inputs || layer.outputs == 0 || layer.outputs > maxWidth
+            || layer.weights.size() != layer.inputs * layer.outputs || layer.bias.size() != layer.outputs
+            || (layer.activation != MLP_LINEAR && layer.activation != MLP_RELU)) {
+            m_error = "Layer " + to_string(l) + " does not match the previous one or has a wrong shape";
+            return false;
+        }
+        for (double value : layer.weights) {
+            if (!isfinite(value)) {
+                m_error = "Layer " + to_string(l) + " has a non finite weight";
+                return false;
+            }
+        }
+        for (double value : layer.bias) {
+            if (!isfinite(value)) {
+                m_error = "Layer " + to_string(l) + " has a non finite bias";
+                return false;
+            }
+        }
+        inputs = layer.outputs;
+    }
+    if (inputs != 1) {
+        m_error = "The last layer must have a single output";
+        return false;
+    }
+    return true;
+}
+
+// Read a binary model written by save() or a JSON export, the current model is kept when
+// the file is not valid
+bool MlpPricerBS::load(const string& fileName) {
+    ifstream file(fileName, ios::binary);
+    if (!file) {
+        m_error = "Unable to read the model file " + fileName;
+        return false;
+    }
+    stringstream buffer;
+    buffer << file.rdbuf();
+    string data = buffer.str();
+    MlpModel model;
+    bool binary = data.size() >= sizeof(mlpModelMagic) && memcmp(data.data(), mlpModelMagic, sizeof(mlpModelMagic)) == 0;
+    if (!(binary ? loadBinary(data, model) : loadJson(data, model))) return false;
+    return setModel(model);
+}
+
+// {"features": ["T", "K", "S0", "sigma"], "input_scale": [...], "output_scale": x,
+//  "layers": [{"activation": "relu", "kernel": [[...]], "bias": [...]}, ...]}
+// with each kernel in the Keras layout, kernel[i][o]
+bool MlpPricerBS::loadJson(const string& text, MlpModel& model) {
+    JsonValue root;
+    if (!JsonReader(text).parse(root) || root.type != JsonValue::JSON_OBJECT) {
+        m_error = "The model file is neither a binary model nor valid JSON";
+        return false;
+    }
+    const JsonValue* features = root.find("features");
+    const JsonValue* outputScale = root.find("output_scale");
+    const JsonValue* layers = root.find("layers");
+    if (!features || features->type != JsonValue::JSON_ARRAY || !jsonNumbers(root.find("input_scale"), model.inputScale)
+        || !outputScale || outputScale->type != JsonValue::JSON_NUMBER || !layers || layers->type != JsonValue::JSON_ARRAY) {
+        m_error = "The JSON model needs features, input_scale, output_scale and layers";
+        return false;
+    }
+    for (const JsonValue& name : features->items) {
+        MlpFeature feature;
+        if (name.type != JsonValue::JSON_STRING || !parseFeature(name.text, feature)) {
+            m_error = "Unknown feature: " + name.text + ", expected T, K, S0, sigma or r";
+            return false;
+        }
+        model.features.push_back(feature);
+    }
+    model.outputScale = outputScale->number;
+
+    for (const JsonValue& item : layers->items) {
+        MlpLayer layer;
+        const JsonValue* activation = item.find("activation");
+        const JsonValue* kernel = item.find("kernel");
+        if (!activation || activation->type != JsonValue::JSON_STRING || !kernel || kernel->type != JsonValue::JSON_ARRAY
+            || kernel->items.empty() || !jsonNumbers(item.find("bias"), layer.bias)) {
+            m_error = "Every layer needs an activation, a kernel and a bias";
+            return false;
+        }
+        if (activation->text == "relu") layer.activation = MLP_RELU;
+        else if (activation->text == "linear") layer.activation = MLP_LINEAR;
+        else {
+            m_error = "Unsupported activation: " + activation->text + ", expected relu or linear";
+            return false;
+        }
+        layer.inputs = kernel->items.size();
+        layer.outputs = layer.bias.size();
+        layer.weights.assign(layer.inputs * layer.outputs, 0.0);
+        vector<double> row;
+        for (size_t i = 0; i < layer.inputs; ++i) {
+            if (!jsonNumbers(&kernel->items[i], row) || row.size() != layer.outputs) {
+                m_error = "Every kernel row needs one weight per bias";
+                return false;
+            }
+            for (size_t o = 0; o < layer.outputs; ++o) layer.weights[o * layer.inputs + i] = row[o];
+        }
+        model.layers.push_back(layer);
+    }
+    return true;
+}
+
+bool MlpPricerBS::loadBinary(const string& data, MlpModel& model) {
+    size_t offset = 0;
+    auto read = [&data, &offset](void* dst, size_t bytes) {
+        if (data.size() - offset < bytes) return false;
+        memcpy(dst, data.data() + offset, bytes);
+        offset += bytes;
+        return true;
+    };
+    MlpFileHeader header;
+    if (!read(&header, sizeof(header)) || header.version != mlpModelVersion
+        || header.numFeatures == 0 || header.numFeatures > MLP_FEATURES || header.numLayers > maxLayers) {
+        m_error = "Unsupported binary model version or header";
+        return false;
+    }
+    vector<uint32_t> features(header.numFeatures);
+    model.inputScale.resize(header.numFeatures);
+    bool ok = read(features.data(), features.size() * sizeof(uint32_t))
+        && read(model.inputScale.data(), model.inputScale.size() * sizeof(double));
+    for (uint32_t feature : features) model.features.push_back((MlpFeature)min(feature, (uint32_t)MLP_FEATURES));
+    model.outputScale = header.outputScale;
+    for (uint32_t l = 0; ok && l < header.numLayers; ++l) {
+        MlpFileLayer entry;
+        MlpLayer layer;
+        ok = read(&entry, sizeof(entry)) && entry.inputs <= maxWidth && entry.outputs <= maxWidth;
+        if (!ok) break;
+        layer.inputs = entry.inputs;
+        layer.outputs = entry.outputs;
+        layer.activation = (MlpActivation)entry.activation;
+        layer.weights.resize(layer.inputs * layer.outputs);
+        layer.bias.resize(layer.outputs);
+        ok = read(layer.weights.data(), layer.weights.size() * sizeof(double)) && read(layer.bias.data(), layer.bias.size() * sizeof(double));
+        model.layers.push_back(layer);
+    }
+    if (!ok || offset != data.size()) {
+        m_error = "The binary model is truncated or has trailing bytes";
+        return false;
+    }
+    return true;
+}
+
+// Binary layout of MlpFileHeader, loaded back by load()
+bool MlpPricerBS::save(const string& fileName) const {
+    if (!isLoaded()) return false;
+    MlpFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, mlpModelMagic, sizeof(mlpModelMagic));
+    header.version = mlpModelVersion;
+    header.numFeatures = (uint32_t)m_model.features.size();
+    header.numLayers = (uint32_t)m_model.layers.size();
+    header.outputScale = m_model.outputScale;
+
+    ofstream file(fileName, ios::binary | ios::trunc);
+    file.write((const char*)&header, sizeof(header));
+    for (MlpFeature feature : m_model.features) {
+        uint32_t value = (uint32_t)feature;
+        file.write((const char*)&value, sizeof(value));
+    }
+    file.write((const char*)m_model.inputScale.data(), (streamsize)(m_model.inputScale.size() * sizeof(double)));
+    for (const MlpLayer& layer : m_model.layers) {
+        MlpFileLayer entry = { (uint32_t)layer.inputs, (uint32_t)layer.outputs, (uint32_t)layer.activation, 0 };
+        file.write((const char*)&entry, sizeof(entry));
+        file.write((const char*)layer.weights.data(), (streamsize)(layer.weights.size() * sizeof(double)));
+        file.write((const char*)layer.bias.data(), (streamsize)(layer.bias.size() * sizeof(double)));
+    }
+    return file.good();
+}
+
+// Network price of one contract, zero when no model is loaded
+double MlpPricerBS::price(double T, double K, double S0, double sigma, double r) const {
+    if (!isLoaded()) return 0;
+    double result = 0;
+    EurBSBatchInput in = { 1, &T, &K, &S0, &sigma, &r };
+    vector<double> buffers(2 * m_width);
+    priceTile(in, &result, 0, 1, buffers.data(), buffers.data() + m_width);
+    return result;
+}
+
+// Network prices of in.n contracts into price[0, in.n)
+void MlpPricerBS::priceBatch(const EurBSBatchInput& in, double* price) const {
+    if (!isLoaded()) {
+        fill(price, price + in.n, 0.0);
+        return;
+    }
+    runBlocks(in.n, blockRows, m_threads, [this, &in, price](size_t first, size_t count) {
+        vector<double> buffers(2 * m_tileRows * m_width);
+        for (size_t done = 0; done < count; done += m_tileRows) {
+            priceTile(in, price, first + done, min(m_tileRows, count - done), buffers.data(), buffers.data() + m_tileRows * m_width);
+        }
+    });
+}
+
+// Rows [first, first + count), count <= m_tileRows, through every layer. The activations
+// ping-pong between a and b, feature major with count rows per feature
+void MlpPricerBS::priceTile(const EurBSBatchInput& in, double* price, size_t first, size_t count, double* a, double* b) const {
+    for (size_t f = 0; f < m_model.features.size(); ++f) {
+        const double* column = featureColumn(in, m_model.features[f]) + first;
+        double scale = m_model.inputScale[f];
+        double* x = a + f * count;
+        for (size_t i = 0; i < count; ++i) x[i] = column[i] / scale;
+    }
+    for (const MlpLayer& layer : m_model.layers) {
+        EurSimdBS::dense(count, layer.inputs, layer.outputs, layer.weights.data(), layer.bias.data(),
+            layer.activation == MLP_RELU, a, b);
+        swap(a, b);
+    }
+    for (size_t i = 0; i < count; ++i) price[first + i] = a[i] * m_model.outputScale;
+}
+
+// Sample the inputs as the generator does by default, uniform in [nMin, max) with the
+// sampling and seed of params, and price them with the network and the SIMD closed form call
+bool MlpPricerBS::measureAccuracy(const DataSetParams& params, MlpAccuracy& accuracy) {
+    accuracy = MlpAccuracy();
+    if (!isLoaded() || params.numSamples <= 0) {
+        m_error = "A model and a positive number of samples are needed";
+        return false;
+    }
+    SamplerBS sampler(params.sampling, params.seed, params.numSamples);
+    const double maxima[SamplerBS::dimensions] = { params.tMax, params.pMax, params.pMax, params.sigmaMax, params.rMax };
+    size_t chunk = (size_t)min((long long)accuracyChunk, params.numSamples);
+    vector<vector<double>> inputs(SamplerBS::dimensions, vector<double>(chunk));
+    vector<double> mlpPrice(chunk), bsPrice(chunk);
+    double* unit[SamplerBS::dimensions];
+    for (int d = 0; d < SamplerBS::dimensions; ++d) unit[d] = inputs[d].data();
+    int savedThreads = m_threads;
+    m_threads = params.numThreads;
+    double sumAbs = 0, sumSquares = 0;
+
+    for (long long first = 0; first < params.numSamples; first += (long long)chunk) {
+        size_t count = (size_t)min((long long)chunk, params.numSamples - first);
+        sampler.fill(first, (long long)count, unit);
+        for (int d = 0; d < SamplerBS::dimensions; ++d) {
+            for (size_t i = 0; i < count; ++i) inputs[d][i] = EurDataSetBS::nMin + (maxima[d] - EurDataSetBS::nMin) * inputs[d][i];
+        }
+        EurBSBatchInput in = { count, unit[0], unit[1], unit[2], unit[3], unit[4] };
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        priceBatch(in, mlpPrice.data());
+        chrono::steady_clock::time_point middle = chrono::steady_clock::now();
+        runBlocks(count, blockRows, m_threads, [&in, &bsPrice](size_t begin, size_t rows) {
+            EurBSBatchInput block = { rows, in.T + begin, in.K + begin, in.S0 + begin, in.sigma + begin, in.r + begin };
+            EurBSBatchOutput call = { bsPrice.data() + begin, nullptr, nullptr, nullptr };
+            EurBSBatchOutput put = { nullptr, nullptr, nullptr, nullptr };
+            EurSimdBS::evaluateBatch(block, call, put);
+        });
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+        accuracy.mlpSeconds += chrono::duration<double>(middle - start).count();
+        accuracy.bsSeconds += chrono::duration<double>(end - middle).count();
+
+        for (size_t i = 0; i < count; ++i) {
+            double error = fabs(mlpPrice[i] - bsPrice[i]);
+            sumAbs += error;
+            sumSquares += error * error;
+            accuracy.maxAbsError = max(accuracy.maxAbsError, error);
+        }
+    }
+    m_threads = savedThreads;
+    accuracy.rows = params.numSamples;
+    accuracy.meanAbsError = sumAbs / (double)params.numSamples;
+    accuracy.rmsError = sqrt(sumSquares / (double)params.numSamples);
+    return true;
+}
+
+// Untrained network of the given widths (features first, then every layer) with He uniform
+// weights, for timing; relu everywhere but the output. The features are T, K, S0, sigma, r
+// truncated to widths[0].
+MlpModel MlpPricerBS::randomModel(const vector<size_t>& widths, uint64_t seed) {
+    MlpModel model;
+    CounterRNG rng(seed);
+    uint64_t row = 0;
+    size_t numFeatures = widths.empty() ? 0 : min(widths[0], (size_t)MLP_FEATURES);
+    for (size_t f = 0; f < numFeatures; ++f) {
+        model.features.push_back((MlpFeature)f);
+        model.inputScale.push_back(1.0);
+    }
+    for (size_t l = 1; l < widths.size(); ++l) {
+        MlpLayer layer;
+        layer.inputs = l == 1 ? numFeatures : widths[l - 1];
+        layer.outputs = widths[l];
+        layer.activation = l + 1 < widths.size() ? MLP_RELU : MLP_LINEAR;
+        double limit = sqrt(6.0 / (double)layer.inputs);
+        for (size_t k = 0; k < layer.inputs * layer.outputs; ++k) layer.weights.push_back(rng.uniform(row++, 0, -limit, limit));
+        layer.bias.assign(layer.outputs, 0.0);
+        model.layers.push_back(layer);
+    }
+    return model;
+}
@@ -0,0 +1,157 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	MlpPricerBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the MlpPricerBS Class, inference of the multilayer
+*					perceptron trained on the generated datasets (Keras Sequential of Dense
+*					layers), so the network can price next to the closed form it learned.
+*
+*					Model     : input features divided by inputScale, Dense layers with
+*					            relu or linear activations, one output times outputScale.
+*					Files     : a JSON export of the Keras weights or the binary layout of
+*					            save(), told apart by the signature.
+*					Batches   : rows split in tiles that go through every layer while the
+*					            activations stay in L1, each layer one EurSimdBS::dense
+*					            pass, and the tiles spread over the threads.
+*					Accuracy  : measureAccuracy prices sampled inputs with the network and
+*					            with EurSimdBS, reporting the errors and both throughputs.
+*
+* References	:	- F. Chollet and others, Keras, Dense layer, https://keras.io
+*					- K. Goto and R. A. van de Geijn, Anatomy of high-performance matrix
+*					  multiplication, ACM TOMS, 2008
+* Other files	:	EurSimdBS.h, EurDataSetBS.h, SamplerBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "EurBatchBS.h"
+#include "EurDataSetBS.h"
+
+using namespace std;
+
+// File signature and version of the binary model layout
+static const char mlpModelMagic[8] = { 'B', 'S', 'D', 'L', '_', 'M', 'L', 'P' };
+static const uint32_t mlpModelVersion = 1;
+
+// Activation applied after a layer
+enum MlpActivation { MLP_LINEAR = 0, MLP_RELU = 1 };
+
+// Network inputs, fields of EurBSBatchInput
+enum MlpFeature { MLP_T = 0, MLP_K = 1, MLP_S0 = 2, MLP_SIGMA = 3, MLP_R = 4, MLP_FEATURES };
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// One Dense layer, y = activation(W x + b)
+struct MlpLayer {
+    size_t inputs = 0;
+    size_t outputs = 0;
+    MlpActivation activation = MLP_RELU;
+    vector<double> weights;     // W[o * inputs + i], the transpose of the Keras kernel
+    vector<double> bias;        // b[o]
+};
+
+// The whole network with its scaling
+struct MlpModel {
+    vector<MlpFeature> features;    // Inputs in the order of the first layer
+    vector<double> inputScale;      // Each feature is divided by its scale
+    double outputScale = 1.0;       // The output is multiplied by it
+    vector<MlpLayer> layers;        // The last one has a single output
+};
+
+// Network against the closed form on the same inputs
+struct MlpAccuracy {
+    long long rows = 0;
+    double meanAbsError = 0;
+    double rmsError = 0;
+    double maxAbsError = 0;
+    double mlpSeconds = 0;      // Wall time of priceBatch over every row
+    double bsSeconds = 0;       // Wall time of EurSimdBS::evaluateBatch, same threads
+};
+
+// Fixed header of a binary model file, followed by the features (uint32), their scales
+// (double) and per layer an MlpFileLayer, its weights and its bias
+struct MlpFileHeader {
+    char magic[8];              // mlpModelMagic
+    uint32_t version;           // mlpModelVersion
+    uint32_t numFeatures;
+    uint32_t numLayers;
+    uint32_t reserved;          // Zero
+    double outputScale;
+};
+
+struct MlpFileLayer {
+    uint32_t inputs;
+    uint32_t outputs;
+    uint32_t activation;        // MlpActivation
+    uint32_t reserved;          // Zero
+};
+
+static_assert(sizeof(MlpFileHeader) == 32, "MlpFileHeader must be packed to 32 bytes");
+static_assert(sizeof(MlpFileLayer) == 16, "MlpFileLayer must be packed to 16 bytes");
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class MlpPricerBS
+{
+    public:
+
+        //constructors
+        MlpPricerBS();
+        MlpPricerBS(const MlpModel& model);
+
+        //accessors
+        bool setModel(const MlpModel& model);
+        const MlpModel& getModel() const;
+        void setThreads(int numThreads);
+        int getThreads();
+        size_t getNumParameters() const;
+        size_t getTileRows() const;
+        bool isLoaded() const;
+        string getError();
+
+        // Public Member functions
+        bool load(const string& fileName);
+        bool save(const string& fileName) const;
+        double price(double T, double K, double S0, double sigma, double r) const;
+        void priceBatch(const EurBSBatchInput& in, double* price) const;
+        bool measureAccuracy(const DataSetParams& params, MlpAccuracy& accuracy);
+        static MlpModel randomModel(const vector<size_t>& widths, uint64_t seed);
+        static bool parseFeature(const string& name, MlpFeature& feature);
+        static string getFeatureName(MlpFeature feature);
+
+        // Rows handed to a thread at a time, split in tiles of getTileRows() rows
+        static const size_t blockRows = 4096;
+
+        // Limits of a model file
+        static const size_t maxLayers = 64;
+        static const size_t maxWidth = 4096;
+
+    private:
+
+        // private Member functions
+        bool validModel(const MlpModel& model);
+        bool loadJson(const string& text, MlpModel& model);
+        bool loadBinary(const string& data, MlpModel& model);
+        void priceTile(const EurBSBatchInput& in, double* price, size_t first, size_t count, double* a, double* b) const;
+
+        // private  Member variables
+        MlpModel m_model;           // Network in use
+        size_t m_width;             // Widest layer, inputs included
+        size_t m_tileRows;          // Rows per tile, both activation buffers fit in 32 KB
+        int m_threads;              // Threads of priceBatch, 0 uses every hardware thread
+        string m_error;             // Reason of the last failure
+};
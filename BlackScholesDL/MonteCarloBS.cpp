@@ -0,0 +1,246 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	MonteCarloBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the MonteCarloBS Class
+*
+* References	:	- P. Glasserman, Monte Carlo Methods in Financial Engineering, 2003
+*					- T. F. Chan, G. H. Golub and R. J. LeVeque, Updating formulae and a
+*					  pairwise algorithm for computing sample variances, 1979
+* Other files	:	CounterRNG.cpp, NormalCDFBS.cpp, SobolBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#include "MonteCarloBS.h"
+#include "NormalCDFBS.h"
+#include "SobolBS.h"
+
+// Paths (or antithetic pairs) per block, the unit of work of a thread
+static const long long blockUnits = 4096;
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+// Running means and centred co-moments of the payoff x and the control c
+struct MonteCarloBS::Moments {
+    double n = 0, meanX = 0, meanC = 0, mXX = 0, mCC = 0, mXC = 0;
+
+    // Welford update with one sample
+    void add(double x, double c) {
+        n += 1;
+        double dx = x - meanX, dc = c - meanC;
+        meanX += dx / n;
+        meanC += dc / n;
+        mXX += dx * (x - meanX);
+        mCC += dc * (c - meanC);
+        mXC += dx * (c - meanC);
+    }
+
+    // Chan's pairwise combination of two blocks
+    void merge(const Moments& other) {
+        if (other.n == 0) return;
+        if (n == 0) {
+            *this = other;
+            return;
+        }
+        double total = n + other.n, dx = other.meanX - meanX, dc = other.meanC - meanC, weight = n * other.n / total;
+        mXX += other.mXX + dx * dx * weight;
+        mCC += other.mCC + dc * dc * weight;
+        mXC += other.mXC + dx * dc * weight;
+        meanX += dx * other.n / total;
+        meanC += dc * other.n / total;
+        n = total;
+    }
+};
+
+//Default constructor
+MonteCarloBS::MonteCarloBS() : m_rng(m_params.seed), m_unitsPerReplicate(0), m_threadsUsed(0), m_seconds(0), m_stdError(0) {}
+
+//Parametrized constructor
+MonteCarloBS::MonteCarloBS(const MonteCarloParams& params) : m_params(params), m_rng(params.seed), m_unitsPerReplicate(0),
+    m_threadsUsed(0), m_seconds(0), m_stdError(0) {}
+
+//accessors
+void MonteCarloBS::setParams(const MonteCarloParams& params) {
+    m_params = params;
+    m_rng = CounterRNG(params.seed);
+}
+MonteCarloParams MonteCarloBS::getParams() { return m_params; }
+int MonteCarloBS::getThreadsUsed() { return m_threadsUsed; }
+double MonteCarloBS::getSeconds() { return m_seconds; }
+string MonteCarloBS::getError() { return m_error; }
+
+double MonteCarloBS::getPathsPerSecond() {
+    long long units = m_unitsPerReplicate * (m_params.sampler == MC_SOBOL ? m_params.numReplicates : 1);
+    return m_seconds > 0 ? units * (m_params.antithetic ? 2 : 1) / m_seconds : 0;
+}
+
+double MonteCarloBS::getConvergencePerSecond() {
+    return m_seconds > 0 && m_stdError > 0 ? 1.0 / (m_stdError * m_stdError * m_seconds) : 0;
+}
+
+// Paths [first, last) of a block, a Sobol block starts from its first point by its Gray code
+void MonteCarloBS::simulateBlock(const MonteCarloOption& option, long long block, Moments& moments) const {
+    long long blocksPerReplicate = (m_unitsPerReplicate + blockUnits - 1) / blockUnits;
+    long long replicate = block / blocksPerReplicate;
+    long long first = (block % blocksPerReplicate) * blockUnits;
+    long long last = min(m_unitsPerReplicate, first + blockUnits);
+    int steps = m_params.numSteps;
+    bool sobol = m_params.sampler == MC_SOBOL;
+
+    double drift = (option.r - 0.5 * option.sigma * option.sigma) * option.T;
+    double vol = option.sigma * sqrt(option.T / steps);
+    double discount = exp(-option.r * option.T);
+    double sign = option.isCall ? 1.0 : -1.0;
+
+    // Point index first + 1, the origin is skipped
+    SobolBS points(sobol ? steps : 1, sobol ? (uint64_t)(first + 1) : 0);
+    uint32_t shift[maxSteps] = {};
+    if (sobol) {
+        for (int j = 0; j < steps; ++j) shift[j] = (uint32_t)(m_rng.bits((uint64_t)replicate, (uint64_t)j) >> 32);
+    }
+
+    for (long long unit = first; unit < last; ++unit) {
+        double sumZ = 0;
+        for (int j = 0; j < steps; ++j) {
+            double u = sobol ? points.uniform(j, shift[j])
+                : ((m_rng.bits((uint64_t)unit, (uint64_t)j) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+            sumZ += NormalCDFBS::inverse(u);
+        }
+        if (sobol) points.next();
+
+        double ST = option.S0 * exp(drift + vol * sumZ);
+        double payoff = max(sign * (ST - option.K), 0.0);
+        double control = ST;
+        if (m_params.antithetic) {
+            double mirrorST = option.S0 * exp(drift - vol * sumZ);
+            payoff = 0.5 * (payoff + max(sign * (mirrorST - option.K), 0.0));
+            control = 0.5 * (control + mirrorST);
+        }
+        moments.add(discount * payoff, discount * control);
+    }
+}
+
+// Checks the contract and the parameters, and splits the paths over the replicates
+bool MonteCarloBS::validate(const MonteCarloOption& option) {
+    bool sobol = m_params.sampler == MC_SOBOL;
+    long long replicates = sobol ? m_params.numReplicates : 1;
+    if (!(option.T > 0 && option.K > 0 && option.S0 > 0 && option.sigma > 0)) {
+        m_error = "T, K, S0 and sigma must be positive";
+        return false;
+    }
+    if (m_params.numSteps < 1 || m_params.numSteps > maxSteps || (sobol && replicates < 2)) {
+        m_error = "Steps must be in [1, " + to_string(maxSteps) + "] and Sobol needs at least 2 replicates";
+        return false;
+    }
+    m_unitsPerReplicate = m_params.numPaths / (m_params.antithetic ? 2 : 1) / replicates;
+    if (m_unitsPerReplicate < 2) {
+        m_error = "Too few paths for the replicates and antithetic pairs";
+        return false;
+    }
+    if (sobol && !(m_unitsPerReplicate < (long long)SobolBS::maxPoints)) {
+        m_error = "Sobol takes fewer than " + to_string(SobolBS::maxPoints) + " paths or antithetic pairs per replicate";
+        return false;
+    }
+    return true;
+}
+
+// Simulate every block over the worker threads, then combine the blocks in a fixed order
+bool MonteCarloBS::price(const MonteCarloOption& option, MonteCarloResult& result) {
+    if (!validate(option)) return false;
+    bool sobol = m_params.sampler == MC_SOBOL;
+    long long replicates = sobol ? m_params.numReplicates : 1;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    long long blocksPerReplicate = (m_unitsPerReplicate + blockUnits - 1) / blockUnits;
+    long long numBlocks = blocksPerReplicate * replicates;
+    int threads = m_params.numThreads > 0 ? m_params.numThreads : (int)thread::hardware_concurrency();
+    m_threadsUsed = (int)max(1LL, min((long long)threads, numBlocks));
+
+    vector<Moments> blocks((size_t)numBlocks);
+    auto worker = [&](int w) {
+        for (long long b = w; b < numBlocks; b += m_threadsUsed) simulateBlock(option, b, blocks[(size_t)b]);
+    };
+    vector<future<void>> workers;
+    for (int w = 1; w < m_threadsUsed; ++w) workers.push_back(async(launch::async, worker, w));
+    worker(0);
+    for (auto& w : workers) w.get();
+
+    // One estimate per replicate, with the regression coefficient of the control on its own samples
+    vector<double> estimates;
+    double residualVariance = 0;
+    for (long long rep = 0; rep < replicates; ++rep) {
+        Moments total;
+        for (long long b = 0; b < blocksPerReplicate; ++b) total.merge(blocks[(size_t)(rep * blocksPerReplicate + b)]);
+        double estimate = total.meanX, squares = total.mXX, dof = total.n - 1;
+        if (m_params.controlVariate && total.mCC > 0) {
+            double beta = total.mXC / total.mCC;
+            estimate -= beta * (total.meanC - option.S0);
+            squares -= beta * total.mXC;
+            dof -= 1;
+        }
+        estimates.push_back(estimate);
+        residualVariance = max(0.0, squares) / max(1.0, dof);
+    }
+
+    result.paths = m_unitsPerReplicate * replicates * (m_params.antithetic ? 2 : 1);
+    result.price = 0;
+    for (double estimate : estimates) result.price += estimate;
+    result.price /= replicates;
+    if (sobol) {
+        double squares = 0;
+        for (double estimate : estimates) squares += (estimate - result.price) * (estimate - result.price);
+        result.stdError = sqrt(squares / (replicates * (replicates - 1)));
+    }
+    else result.stdError = sqrt(residualVariance / m_unitsPerReplicate);
+
+    m_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    m_stdError = result.stdError;
+    return true;
+}
+
+// Paths per second from one thread to numThreads, the same paths at every count.
+// Nothing is printed when the parameters are invalid.
+bool MonteCarloBS::scalingReport(const MonteCarloOption& option, ostream& report) {
+    if (!validate(option)) return false;
+    int maxThreads = m_params.numThreads > 0 ? m_params.numThreads : (int)thread::hardware_concurrency();
+    if (maxThreads < 1) maxThreads = 1;
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    report << "threads,paths_per_sec,speedup,efficiency" << "\n";
+    double base = 0;
+    for (int t : counts) {
+        MonteCarloParams run = m_params;
+        run.numThreads = t;
+        MonteCarloBS engine(run);
+        MonteCarloResult result;
+        if (!engine.price(option, result)) {
+            m_error = engine.getError();
+            return false;
+        }
+        double rate = engine.getPathsPerSecond();
+        if (t == 1) base = rate;
+        double speedup = base > 0 ? rate / base : 0;
+        report << t << "," << fixed << setprecision(0) << rate << "," << setprecision(2) << speedup << "," << speedup / t << "\n";
+        report.unsetf(ios::floatfield);
+    }
+    report << setprecision(6);
+    return true;
+}
@@ -0,0 +1,120 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	MonteCarloBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the MonteCarloBS Class, Monte Carlo pricing of European
+*					calls and puts under geometric Brownian motion, to validate against
+*					the closed form before moving to payoffs without one.
+*
+*					Paths     : exact log-normal steps, path i takes its draws from row i
+*					            of a CounterRNG (or point i of a Sobol sequence), so the
+*					            result does not depend on the number of threads.
+*					Variance  : antithetic pairs (z, -z) and a control variate, the
+*					            discounted terminal price, whose Black-Scholes value is S0.
+*					Sobol     : randomised by numReplicates random digital shifts, the
+*					            standard error is the one of the replicate means.
+*					Metric    : convergence per second 1 / (stdError^2 * seconds), the
+*					            inverse of the variance bought by one second of compute.
+*
+* References	:	- P. Glasserman, Monte Carlo Methods in Financial Engineering, 2003,
+*					  chapters 4 and 5
+*					- S. Joe and F. Y. Kuo, Constructing Sobol sequences with better
+*					  two-dimensional projections, SIAM J. Sci. Comput., 2008
+* Other files	:	CounterRNG.h, NormalCDFBS.h, SobolBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "CounterRNG.h"
+
+using namespace std;
+
+// Source of the uniform draws
+enum MonteCarloSampler { MC_PSEUDO = 0, MC_SOBOL = 1 };
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Simulation parameters
+struct MonteCarloParams {
+    long long numPaths = 1 << 20;   // Simulated paths, antithetic mirrors included
+    int numSteps = 1;               // Time steps per path, at most MonteCarloBS::maxSteps
+    MonteCarloSampler sampler = MC_PSEUDO;
+    bool antithetic = false;        // Pair every path with its mirror
+    bool controlVariate = false;    // Regress on the discounted terminal price
+    int numReplicates = 16;         // Independent Sobol shifts, at least 2
+    uint64_t seed = 1;              // Seed of the random stream and of the shifts
+    int numThreads = 0;             // Worker threads, 0 uses every hardware thread
+};
+
+// The contract priced
+struct MonteCarloOption {
+    double T = 1.0;
+    double K = 100.0;
+    double S0 = 100.0;
+    double sigma = 0.2;
+    double r = 0.05;
+    bool isCall = true;
+};
+
+// Estimate and its standard error
+struct MonteCarloResult {
+    double price = 0;
+    double stdError = 0;
+    long long paths = 0;            // Paths simulated, numPaths rounded down to whole pairs and replicates
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class MonteCarloBS
+{
+    public:
+
+        //constructors
+        MonteCarloBS();
+        MonteCarloBS(const MonteCarloParams& params);
+
+        //accessors
+        void setParams(const MonteCarloParams& params);
+        MonteCarloParams getParams();
+        int getThreadsUsed();
+        double getSeconds();
+        double getPathsPerSecond();
+        double getConvergencePerSecond();
+        string getError();
+
+        // Public Member functions
+        bool price(const MonteCarloOption& option, MonteCarloResult& result);
+        bool scalingReport(const MonteCarloOption& option, ostream& report);
+
+        // Steps per path, one random draw each
+        static const int maxSteps = (int)CounterRNG::drawsPerRow;
+
+    private:
+
+        // private Member functions
+        struct Moments;
+        bool validate(const MonteCarloOption& option);
+        void simulateBlock(const MonteCarloOption& option, long long block, Moments& moments) const;
+
+        // private  Member variables
+        MonteCarloParams m_params;  // Simulation parameters
+        CounterRNG m_rng;           // Pseudo random stream and Sobol shifts
+        long long m_unitsPerReplicate;  // Paths, or antithetic pairs, per replicate
+        int m_threadsUsed;          // Threads used by the last run
+        double m_seconds;           // Wall time of the last run
+        double m_stdError;          // Standard error of the last run
+        string m_error;             // Reason of the last failure
+};
@@ -0,0 +1,162 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	NormalCDFBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the NormalCDFBS Class
+*
+* References	:	- G. West, Better approximations to cumulative normal functions,
+*					  Wilmott Magazine, 2005
+*					- P. J. Acklam, An algorithm for computing the inverse normal
+*					  cumulative distribution function, 2003
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "NormalCDFBS.h"
+
+// Error scan over [-errorRange, errorRange], beyond it every backend is 0 or 1 to 1e-23
+static const double errorRange = 10.0;
+static const size_t errorPoints = 2000001;
+
+// Timing runs over a cache resident array for at least this long
+static const size_t timingValues = 4096;
+static const double timingSeconds = 0.02;
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+template <class Cdf>
+static void cdfLoop(size_t n, const double* x, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = Cdf::cdf(x[i]);
+}
+
+// Extended precision reference, as accurate as double where long double is double (MSVC)
+static double referenceCDF(double x) {
+    return (double)(0.5L * erfcl(-(long double)x / sqrtl(2.0L)));
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+// Relaxed, the backend is a value on its own and orders no other memory
+atomic<int>& NormalCDFBS::selected() {
+    static atomic<int> backend(CDF_ABRAMOWITZ_STEGUN);
+    return backend;
+}
+
+CdfBackend NormalCDFBS::getBackend() { return (CdfBackend)selected().load(memory_order_relaxed); }
+
+void NormalCDFBS::setBackend(CdfBackend backend) {
+    if (backend >= CDF_FAST && backend < CDF_BACKENDS) selected().store(backend, memory_order_relaxed);
+}
+
+string NormalCDFBS::getBackendName(CdfBackend backend) {
+    switch (backend) {
+    case CDF_FAST: return "fast";
+    case CDF_ERFC: return "erfc";
+    case CDF_WEST: return "west";
+    default: return "as";
+    }
+}
+
+bool NormalCDFBS::parseBackend(const string& name, CdfBackend& backend) {
+    for (int b = CDF_FAST; b < CDF_BACKENDS; ++b) {
+        if (name == getBackendName((CdfBackend)b)) {
+            backend = (CdfBackend)b;
+            return true;
+        }
+    }
+    return false;
+}
+
+double NormalCDFBS::cdf(double x) {
+    switch (getBackend()) {
+    case CDF_FAST: return CdfFastBS::cdf(x);
+    case CDF_ERFC: return CdfErfcBS::cdf(x);
+    case CDF_WEST: return CdfWestBS::cdf(x);
+    default: return CdfAbramowitzStegunBS::cdf(x);
+    }
+}
+
+void NormalCDFBS::cdfPair(double x, double& cdfPos, double& cdfNeg) {
+    switch (getBackend()) {
+    case CDF_FAST: CdfFastBS::cdfPair(x, cdfPos, cdfNeg); break;
+    case CDF_ERFC: CdfErfcBS::cdfPair(x, cdfPos, cdfNeg); break;
+    case CDF_WEST: CdfWestBS::cdfPair(x, cdfPos, cdfNeg); break;
+    default: CdfAbramowitzStegunBS::cdfPair(x, cdfPos, cdfNeg); break;
+    }
+}
+
+// The backend is chosen once for the whole array
+void NormalCDFBS::cdfBatch(size_t n, const double* x, double* out) {
+    switch (getBackend()) {
+    case CDF_FAST: cdfLoop<CdfFastBS>(n, x, out); break;
+    case CDF_ERFC: cdfLoop<CdfErfcBS>(n, x, out); break;
+    case CDF_WEST: cdfLoop<CdfWestBS>(n, x, out); break;
+    default: cdfLoop<CdfAbramowitzStegunBS>(n, x, out); break;
+    }
+}
+
+// Acklam's rational approximations, central for p in [0.02425, 0.97575] and tails outside
+double NormalCDFBS::inverse(double p) {
+    static const double a[6] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+        1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[5] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+        6.680131188771972e+01, -1.328068155288572e+01 };
+    static const double c[6] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+        -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[4] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+        3.754408661907416e+00 };
+    static const double pLow = 0.02425;
+    if (p <= 0.0) return -HUGE_VAL;
+    if (p >= 1.0) return HUGE_VAL;
+    if (p < pLow || p > 1.0 - pLow) {
+        double q = sqrt(-2.0 * log(p < pLow ? p : 1.0 - p));
+        double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+            / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+        return p < pLow ? x : -x;
+    }
+    double q = p - 0.5, t = q * q;
+    return (((((a[0] * t + a[1]) * t + a[2]) * t + a[3]) * t + a[4]) * t + a[5]) * q
+        / (((((b[0] * t + b[1]) * t + b[2]) * t + b[3]) * t + b[4]) * t + 1.0);
+}
+
+// Error on a uniform grid with step 1e-5, time on evenly spread points of [-8, 8]
+NormalCDFReport NormalCDFBS::measure(CdfBackend backend) {
+    CdfBackend previous = getBackend();
+    setBackend(backend);
+    NormalCDFReport report = { getBackend(), 0.0, 0.0 };
+
+    vector<double> x(timingValues), out(timingValues);
+    for (size_t i = 0; i < errorPoints; i += timingValues) {
+        size_t n = min(timingValues, errorPoints - i);
+        for (size_t j = 0; j < n; ++j) x[j] = -errorRange + 2.0 * errorRange * (i + j) / (errorPoints - 1);
+        cdfBatch(n, &x[0], &out[0]);
+        for (size_t j = 0; j < n; ++j) report.maxError = max(report.maxError, fabs(out[j] - referenceCDF(x[j])));
+    }
+
+    for (size_t j = 0; j < timingValues; ++j) x[j] = -8.0 + 16.0 * j / (timingValues - 1);
+    size_t calls = 0;
+    double seconds = 0, sink = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (seconds < timingSeconds) {
+        cdfBatch(timingValues, &x[0], &out[0]);
+        sink += out[calls % timingValues];
+        calls += timingValues;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    report.nsPerCall = seconds * 1e9 / calls + (sink < 0 ? 1 : 0);
+    setBackend(previous);
+    return report;
+}
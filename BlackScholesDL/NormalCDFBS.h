@@ -0,0 +1,205 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	NormalCDFBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the NormalCDFBS Class, selectable implementations of
+*					the standard normal CDF used by every price and Greek, trading
+*					accuracy for speed.
+*
+*					Backends  : one inline struct each, usable as a template argument of
+*					            EurKernelBS, plus a process wide selection read by the
+*					            scalar classes and the batch and SIMD pricers.
+*					Default   : CDF_ABRAMOWITZ_STEGUN, the original approximation, so
+*					            results are unchanged unless another backend is chosen.
+*					Errors    : max absolute errors over [-10, 10] and ns per call are
+*					            measured by measure(), e.g. by "BlackScholesDL cdf".
+*
+* References	:	- M. Abramowitz and I. Stegun, Handbook of Mathematical Functions,
+*					  26.2.17 and 26.2.19
+*					- G. West, Better approximations to cumulative normal functions,
+*					  Wilmott Magazine, 2005, after W. J. Cody and J. F. Hart
+*					- P. J. Acklam, An algorithm for computing the inverse normal
+*					  cumulative distribution function, 2003
+* Other files	:	EurKernelBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// CDF implementations, from the fastest to the most accurate
+enum CdfBackend {
+    CDF_FAST = 0,                   // A&S 26.2.19, no exp, error 1.5e-7
+    CDF_ABRAMOWITZ_STEGUN = 1,      // A&S 26.2.17, error 7.5e-8, the default
+    CDF_ERFC = 2,                   // 0.5 * erfc(-x / sqrt(2)) of the standard library
+    CDF_WEST = 3,                   // West's double precision Hart / Cody rational
+    CDF_BACKENDS
+};
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Accuracy and cost of one backend
+struct NormalCDFReport {
+    CdfBackend backend;
+    double maxError;        // Largest absolute error against a long double erfc
+    double nsPerCall;       // Scalar time per value over a cache resident array
+};
+
+// Each backend provides cdf(x) and cdfPair(x, N(x), N(-x)) from one tail evaluation
+
+// Polynomial only, the tail 0.5 * (1 + d1*x + ... + d6*x^6)^-16
+struct CdfFastBS
+{
+    static inline double tail(double absX) {
+        double p = ((((((5.383e-6 * absX + 4.88906e-5) * absX + 3.80036e-5) * absX + 3.2776263e-3) * absX
+            + 2.11410061e-2) * absX + 4.9867347e-2) * absX + 1.0);
+        double q = 1.0 / p;
+        q *= q;
+        q *= q;
+        q *= q;
+        q *= q;
+        return 0.5 * q;
+    }
+
+    static inline void cdfPair(double x, double& cdfPos, double& cdfNeg) {
+        double q = tail(x >= 0.0 ? x : -x);
+        cdfPos = x >= 0.0 ? 1.0 - q : q;
+        cdfNeg = x >= 0.0 ? q : 1.0 - q;
+    }
+
+    static inline double cdf(double x) {
+        double q = tail(x >= 0.0 ? x : -x);
+        return x >= 0.0 ? 1.0 - q : q;
+    }
+};
+
+// The approximation of EurOptionBS, including its 1 - N(-x) reflection for x < 0
+struct CdfAbramowitzStegunBS
+{
+    // expTerm = exp(-absX*absX/2), callers that also need the density pass the one they have
+    static inline double upper(double absX, double expTerm) {
+        double gamma = 0.2316419;     double a1 = 0.319381530;
+        double a2 = -0.356563782;   double a3 = 1.781477937;
+        double a4 = -1.821255978;   double a5 = 1.330274429;
+        double k = 1.0 / (1.0 + gamma * absX);
+        return 1.0 - ((((a5 * k + a4) * k + a3) * k + a2) * k + a1) * k * expTerm / 2.5066282746310002;
+    }
+
+    static inline double upper(double absX) {
+        return upper(absX, exp(-absX * absX / 2.0));
+    }
+
+    static inline void cdfPair(double x, double expTerm, double& cdfPos, double& cdfNeg) {
+        double value = upper(x >= 0.0 ? x : -x, expTerm);
+        cdfPos = x >= 0.0 ? value : 1.0 - value;
+        cdfNeg = -x >= 0.0 ? value : 1.0 - value;
+    }
+
+    static inline void cdfPair(double x, double& cdfPos, double& cdfNeg) {
+        cdfPair(x, exp(-x * x / 2.0), cdfPos, cdfNeg);
+    }
+
+    static inline double cdf(double x) {
+        double value = upper(x >= 0.0 ? x : -x);
+        return x >= 0.0 ? value : 1.0 - value;
+    }
+};
+
+// Standard library complementary error function
+struct CdfErfcBS
+{
+    static inline void cdfPair(double x, double& cdfPos, double& cdfNeg) {
+        cdfPos = 0.5 * erfc(-x * 0.70710678118654752440);
+        cdfNeg = 0.5 * erfc(x * 0.70710678118654752440);
+    }
+
+    static inline double cdf(double x) {
+        return 0.5 * erfc(-x * 0.70710678118654752440);
+    }
+};
+
+// Hart's rational approximation below |x| = 7.07 and a continued fraction above it
+struct CdfWestBS
+{
+    static inline double tail(double absX) {
+        if (absX > 37.0) return 0.0;
+        double e = exp(-absX * absX / 2.0);
+        if (absX < 7.07106781186547) {
+            double num = 3.52624965998911e-2 * absX + 0.700383064443688;
+            num = num * absX + 6.37396220353165;
+            num = num * absX + 33.912866078383;
+            num = num * absX + 112.079291497871;
+            num = num * absX + 221.213596169931;
+            num = num * absX + 220.206867912376;
+            double den = 8.83883476483184e-2 * absX + 1.75566716318264;
+            den = den * absX + 16.064177579207;
+            den = den * absX + 86.7807322029461;
+            den = den * absX + 296.564248779674;
+            den = den * absX + 637.333633378831;
+            den = den * absX + 793.826512519948;
+            den = den * absX + 440.413735824752;
+            return e * num / den;
+        }
+        double fraction = absX + 0.65;
+        fraction = absX + 4.0 / fraction;
+        fraction = absX + 3.0 / fraction;
+        fraction = absX + 2.0 / fraction;
+        fraction = absX + 1.0 / fraction;
+        return e / fraction / 2.506628274631;
+    }
+
+    static inline void cdfPair(double x, double& cdfPos, double& cdfNeg) {
+        double q = tail(x >= 0.0 ? x : -x);
+        cdfPos = x >= 0.0 ? 1.0 - q : q;
+        cdfNeg = x >= 0.0 ? q : 1.0 - q;
+    }
+
+    static inline double cdf(double x) {
+        double q = tail(x >= 0.0 ? x : -x);
+        return x >= 0.0 ? 1.0 - q : q;
+    }
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class NormalCDFBS
+{
+    public:
+
+        // Process wide selection, read by every pricing thread; a change while they run
+        // applies to the contracts evaluated after it
+        static CdfBackend getBackend();
+        static void setBackend(CdfBackend backend);
+        static string getBackendName(CdfBackend backend);
+        static bool parseBackend(const string& name, CdfBackend& backend);
+
+        // The selected backend on one value, a pair or n contiguous values
+        static double cdf(double x);
+        static void cdfPair(double x, double& cdfPos, double& cdfNeg);
+        static void cdfBatch(size_t n, const double* x, double* out);
+
+        // Quantile, the x with N(x) = p for p in (0, 1), relative error of x below 1.2e-9
+        static double inverse(double p);
+
+        // Max error and speed of a backend, measured on the running machine
+        static NormalCDFReport measure(CdfBackend backend);
+
+    private:
+
+        static atomic<int>& selected();
+};
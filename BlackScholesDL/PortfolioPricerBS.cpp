@@ -0,0 +1,355 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	PortfolioPricerBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the PortfolioPricerBS Class
+*
+* References	:
+* Other files	:	EurSimdBS.cpp, ColumnarReaderBS.cpp, ColumnarWriterBS.cpp, CsvFormatBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <thread>
+
+#include "PortfolioPricerBS.h"
+#include "CsvFormatBS.h"
+#include "EurSimdBS.h"
+#include "ProfilerBS.h"
+
+// Input column names of a binary portfolio, type is optional
+static const char* binaryColumns[6] = { "time", "strike_price", "stock_price", "volatility", "interest_rate", "type" };
+
+// Decimals of the CSV output, and the room reserved per row of about 50 bytes
+static const int csvPrecision = 8;
+static const size_t csvRowBytes = 64;
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+PortfolioPricerBS::PortfolioPricerBS() : m_chunkRows(1 << 20), m_threads(0), m_binaryInput(false),
+    m_binaryOutput(false), m_csvLine(0), m_binColumns(), m_bothLegs(false), m_nextRow(0), m_positions(0), m_seconds(0) {}
+
+//accessors
+void PortfolioPricerBS::setChunkRows(size_t chunkRows) { m_chunkRows = chunkRows > 0 ? chunkRows : 1; }
+void PortfolioPricerBS::setThreads(int numThreads) { m_threads = numThreads; }
+long long PortfolioPricerBS::getPositions() { return m_positions; }
+double PortfolioPricerBS::getSeconds() { return m_seconds; }
+double PortfolioPricerBS::getPositionsPerSecond() { return m_seconds > 0 ? m_positions / m_seconds : 0; }
+string PortfolioPricerBS::getError() { return m_error; }
+
+// Option type from call/put, c/p or 1/-1, the whole field up to the next comma or the end
+// of the line must be one of these tokens
+bool PortfolioPricerBS::parseType(const char* text, char& isCall) {
+    while (*text == ' ') ++text;
+    const char* end = text;
+    while (*end && *end != ',' && *end != '\r' && *end != ' ') ++end;
+    const char* rest = end;
+    while (*rest == ' ' || *rest == '\r') ++rest;
+    if (*rest && *rest != ',') return false;
+    string token(text, end);
+    for (auto& c : token) c = (char)tolower((unsigned char)c);
+    if (token == "call" || token == "c" || token == "1") { isCall = 1; return true; }
+    if (token == "put" || token == "p" || token == "-1") { isCall = 0; return true; }
+    return false;
+}
+
+// Inputs the price command accepts: finite, positive T, K, S0 and sigma, r not negative
+bool PortfolioPricerBS::isValidPosition(double T, double K, double S0, double sigma, double r) {
+    return isfinite(T) && isfinite(K) && isfinite(S0) && isfinite(sigma) && isfinite(r)
+        && T > 0 && K > 0 && S0 > 0 && sigma > 0 && r >= 0;
+}
+
+// A line whose first field is not a number is a column header
+bool PortfolioPricerBS::isHeader(const char* line) {
+    char* end = nullptr;
+    strtod(line, &end);
+    return end == line;
+}
+
+// Open a columnar file when the name ends in .bsdl, a CSV file otherwise
+bool PortfolioPricerBS::openInput(const string& inputFile) {
+    m_binaryInput = inputFile.size() > 5 && inputFile.compare(inputFile.size() - 5, 5, ".bsdl") == 0;
+    m_nextRow = 0;
+    m_csvLine = 0;
+    m_bothLegs = false;
+    if (!m_binaryInput) {
+        m_csvIn.open(inputFile, ios::binary);
+        if (!m_csvIn.is_open()) {
+            m_error = "Unable to open " + inputFile;
+            return false;
+        }
+        return true;
+    }
+    if (!m_binIn.open(inputFile)) {
+        m_error = "Unable to open " + inputFile + " as a columnar file";
+        return false;
+    }
+    for (int c = 0; c < 6; ++c) {
+        m_binColumns[c] = m_binIn.findColumn(binaryColumns[c]);
+        if (m_binColumns[c] < 0 && c < 5) {
+            m_error = string("Missing column ") + binaryColumns[c] + " in " + inputFile;
+            return false;
+        }
+    }
+    m_bothLegs = m_binColumns[5] < 0;
+    return true;
+}
+
+// Parse up to m_chunkRows lines, an empty chunk marks the end of the file
+bool PortfolioPricerBS::readCsvChunk(PortfolioChunk& chunk) {
+    vector<double>* fields[5] = { &chunk.ownT, &chunk.ownK, &chunk.ownS0, &chunk.ownSigma, &chunk.ownR };
+    for (auto field : fields) field->reserve(m_chunkRows);
+    chunk.isCall.reserve(m_chunkRows);
+
+    BSDL_PROFILE_SCOPE(STAGE_READ, ProfilerBS::ioWorker);
+    long long bytes = 0;
+    string line;
+    while (chunk.isCall.size() < m_chunkRows && getline(m_csvIn, line)) {
+        ++m_csvLine;
+        bytes += (long long)line.size() + 1;
+        if (line.empty() || line == "\r") continue;
+        const char* p = line.c_str();
+        double values[5];
+        bool valid = true;
+        for (int f = 0; f < 5 && valid; ++f) {
+            char* end = nullptr;
+            values[f] = strtod(p, &end);
+            valid = end != p && *end == ',';
+            p = end + 1;
+        }
+        char isCall = 0;
+        valid = valid && parseType(p, isCall);
+        if (!valid && m_csvLine == 1 && isHeader(line.c_str())) continue;
+        if (!valid || !isValidPosition(values[0], values[1], values[2], values[3], values[4])) {
+            m_readError = "Invalid position at line " + to_string(m_csvLine) + ": " + line
+                + (valid ? ", T, K, S0 and sigma must be positive and r not negative" : "");
+            return false;
+        }
+        for (int f = 0; f < 5; ++f) fields[f]->push_back(values[f]);
+        chunk.isCall.push_back(isCall);
+    }
+    chunk.count = chunk.isCall.size();
+    BSDL_PROFILE_COUNT(STAGE_READ, ProfilerBS::ioWorker, (long long)chunk.count, bytes);
+    chunk.T = chunk.ownT.data();
+    chunk.K = chunk.ownK.data();
+    chunk.S0 = chunk.ownS0.data();
+    chunk.sigma = chunk.ownSigma.data();
+    chunk.r = chunk.ownR.data();
+    return true;
+}
+
+// Take the next rows straight from the mapping, float32 files are widened
+bool PortfolioPricerBS::readBinaryChunk(PortfolioChunk& chunk) {
+    BSDL_PROFILE_SCOPE(STAGE_READ, ProfilerBS::ioWorker);
+    long long remaining = (long long)m_binIn.getNumRows() - m_nextRow;
+    chunk.count = (size_t)max(0LL, min((long long)m_chunkRows, remaining));
+    const double** views[5] = { &chunk.T, &chunk.K, &chunk.S0, &chunk.sigma, &chunk.r };
+    vector<double>* owned[5] = { &chunk.ownT, &chunk.ownK, &chunk.ownS0, &chunk.ownSigma, &chunk.ownR };
+    for (int c = 0; c < 5; ++c) {
+        const double* column = m_binIn.columnFloat64((uint32_t)m_binColumns[c]);
+        if (column) {
+            *views[c] = column + m_nextRow;
+        }
+        else {
+            const float* narrow = m_binIn.columnFloat32((uint32_t)m_binColumns[c]) + m_nextRow;
+            owned[c]->assign(narrow, narrow + chunk.count);
+            *views[c] = owned[c]->data();
+        }
+    }
+    for (size_t i = 0; i < chunk.count; ++i) {
+        if (!isValidPosition(chunk.T[i], chunk.K[i], chunk.S0[i], chunk.sigma[i], chunk.r[i])) {
+            m_readError = "Invalid position at row " + to_string(m_nextRow + (long long)i + 1)
+                + ", T, K, S0 and sigma must be positive and r not negative";
+            return false;
+        }
+    }
+    chunk.isCall.resize(chunk.count);
+    for (size_t i = 0; i < chunk.count && !m_bothLegs; ++i) {
+        chunk.isCall[i] = m_binIn.value((uint32_t)m_binColumns[5], (uint64_t)(m_nextRow + i)) > 0 ? 1 : 0;
+    }
+    m_nextRow += (long long)chunk.count;
+    // Mapped columns are not copied, no bytes are counted as read
+    BSDL_PROFILE_COUNT(STAGE_READ, ProfilerBS::ioWorker, (long long)chunk.count, 0);
+    return true;
+}
+
+bool PortfolioPricerBS::readChunk(PortfolioChunk& chunk) {
+    return m_binaryInput ? readBinaryChunk(chunk) : readCsvChunk(chunk);
+}
+
+// Price positions [begin, end) of a chunk with the batch kernel and keep the leg of each
+// type, or both legs straight into the chunk when the input has no type
+void PortfolioPricerBS::priceRange(PortfolioChunk& chunk, size_t begin, size_t end, int worker) {
+    BSDL_PROFILE_SCOPE(STAGE_PRICE, worker);
+    size_t n = end - begin;
+    EurBSBatchInput in = { n, chunk.T + begin, chunk.K + begin, chunk.S0 + begin, chunk.sigma + begin, chunk.r + begin };
+    if (m_bothLegs) {
+        EurBSBatchOutput call = { chunk.price.data() + begin, chunk.delta.data() + begin, chunk.gamma.data() + begin,
+            chunk.theta.data() + begin };
+        EurBSBatchOutput put = { chunk.putPrice.data() + begin, chunk.putDelta.data() + begin, nullptr,
+            chunk.putTheta.data() + begin };
+        EurSimdBS::evaluateBatch(in, call, put);
+        BSDL_PROFILE_COUNT(STAGE_PRICE, worker, (long long)n, 0);
+        return;
+    }
+    vector<double> callPrice(n), callDelta(n), callTheta(n), putPrice(n), putDelta(n), putTheta(n);
+    EurBSBatchOutput call = { callPrice.data(), callDelta.data(), chunk.gamma.data() + begin, callTheta.data() };
+    EurBSBatchOutput put = { putPrice.data(), putDelta.data(), nullptr, putTheta.data() };
+    EurSimdBS::evaluateBatch(in, call, put);
+    for (size_t i = 0; i < n; ++i) {
+        bool isCall = chunk.isCall[begin + i] != 0;
+        chunk.price[begin + i] = isCall ? callPrice[i] : putPrice[i];
+        chunk.delta[begin + i] = isCall ? callDelta[i] : putDelta[i];
+        chunk.theta[begin + i] = isCall ? callTheta[i] : putTheta[i];
+    }
+    BSDL_PROFILE_COUNT(STAGE_PRICE, worker, (long long)n, 0);
+}
+
+// Price a chunk split over the pricing threads, then format it for a CSV output
+void PortfolioPricerBS::priceChunk(PortfolioChunk& chunk) {
+    chunk.price.resize(chunk.count);
+    chunk.delta.resize(chunk.count);
+    chunk.gamma.resize(chunk.count);
+    chunk.theta.resize(chunk.count);
+    if (m_bothLegs) {
+        chunk.putPrice.resize(chunk.count);
+        chunk.putDelta.resize(chunk.count);
+        chunk.putTheta.resize(chunk.count);
+    }
+
+    int threads = m_threads > 0 ? m_threads : (int)thread::hardware_concurrency();
+    size_t slices = (size_t)max(1, threads);
+    size_t sliceRows = (chunk.count + slices - 1) / slices;
+    vector<future<void>> workers;
+    for (size_t begin = sliceRows; begin < chunk.count; begin += sliceRows) {
+        workers.push_back(async(launch::async, &PortfolioPricerBS::priceRange, this, ref(chunk), begin,
+            min(chunk.count, begin + sliceRows), (int)(begin / sliceRows)));
+    }
+    priceRange(chunk, 0, min(chunk.count, sliceRows), 0);
+    for (auto& worker : workers) worker.get();
+
+    if (!m_binaryOutput) {
+        BSDL_PROFILE_SCOPE(STAGE_FORMAT, 0);
+        const size_t rowRoom = 8 * CsvFormatBS::maxFixedChars + 32;
+        size_t legs = m_bothLegs ? 2 : 1;
+        chunk.text.resize(chunk.count * legs * csvRowBytes + rowRoom);
+        char* p = &chunk.text[0];
+        for (size_t i = 0; i < chunk.count; ++i) {
+            p = CsvFormatBS::reserve(chunk.text, p, rowRoom);
+            for (size_t leg = 0; leg < legs; ++leg) {
+                bool isCall = m_bothLegs ? leg == 0 : chunk.isCall[i] != 0;
+                p = isCall ? CsvFormatBS::writeText(p, "call,", 5) : CsvFormatBS::writeText(p, "put,", 4);
+                const double values[4] = { isCall || !m_bothLegs ? chunk.price[i] : chunk.putPrice[i],
+                    isCall || !m_bothLegs ? chunk.delta[i] : chunk.putDelta[i], chunk.gamma[i],
+                    isCall || !m_bothLegs ? chunk.theta[i] : chunk.putTheta[i] };
+                for (int v = 0; v < 4; ++v) {
+                    p = CsvFormatBS::writeFixed(p, values[v], csvPrecision);
+                    *p++ = v < 3 ? ',' : '\n';
+                }
+            }
+        }
+        chunk.text.resize((size_t)(p - &chunk.text[0]));
+        BSDL_PROFILE_COUNT(STAGE_FORMAT, 0, (long long)chunk.count, (long long)chunk.text.size());
+    }
+}
+
+bool PortfolioPricerBS::writeChunk(PortfolioChunk& chunk) {
+    BSDL_PROFILE_SCOPE(STAGE_WRITE, ProfilerBS::ioWorker);
+    size_t numColumns = m_bothLegs ? 7 : 4;
+    BSDL_PROFILE_COUNT(STAGE_WRITE, ProfilerBS::ioWorker, (long long)chunk.count,
+        m_binaryOutput ? (long long)(chunk.count * numColumns * sizeof(double)) : (long long)chunk.text.size());
+    if (!m_binaryOutput) {
+        m_csvOut.write(chunk.text.data(), chunk.text.size());
+        return m_csvOut.good();
+    }
+    if (m_bothLegs) {
+        const double* columns[7] = { chunk.price.data(), chunk.delta.data(), chunk.theta.data(), chunk.putPrice.data(),
+            chunk.putDelta.data(), chunk.putTheta.data(), chunk.gamma.data() };
+        return m_binOut.writeRows((uint64_t)chunk.first, chunk.count, columns);
+    }
+    const double* columns[4] = { chunk.price.data(), chunk.delta.data(), chunk.gamma.data(), chunk.theta.data() };
+    return m_binOut.writeRows((uint64_t)chunk.first, chunk.count, columns);
+}
+
+// Stream the portfolio through three overlapped stages: the next chunk is read and the
+// previous one written while the current one is priced, so memory stays at three chunks
+bool PortfolioPricerBS::reprice(const string& inputFile, const string& outputFile) {
+    m_positions = 0;
+    m_seconds = 0;
+    m_error.clear();
+    m_readError.clear();
+    auto start = chrono::steady_clock::now();
+    if (!openInput(inputFile)) return false;
+
+    m_binaryOutput = outputFile.size() > 5 && outputFile.compare(outputFile.size() - 5, 5, ".bsdl") == 0;
+    if (m_binaryOutput && !m_binaryInput) {
+        m_error = "A columnar output needs a columnar input, the row count must be known up front";
+        return false;
+    }
+    bool opened = false;
+    if (m_binaryOutput) {
+        vector<string> columns = { "price", "delta", "gamma", "theta" };
+        if (m_bothLegs) columns = { "price_o1", "delta_o1", "theta_o1", "price_o2", "delta_o2", "theta_o2", "gamma" };
+        opened = m_binOut.open(outputFile, columns, m_binIn.getNumRows(), 8, ColumnarHeader());
+    }
+    else {
+        m_csvOut.open(outputFile, ios::binary | ios::trunc);
+        opened = m_csvOut.is_open();
+        if (opened) m_csvOut << "type,price,delta,gamma,theta" << "\n";
+    }
+    if (!opened) {
+        m_error = "Unable to write " + outputFile;
+        return false;
+    }
+
+    PortfolioChunk current, next, writing;
+    bool ok = readChunk(current);
+    future<bool> pendingWrite;
+    while (ok && current.count > 0) {
+        next = PortfolioChunk();
+        next.first = current.first + (long long)current.count;
+        future<bool> pendingRead = async(launch::async, &PortfolioPricerBS::readChunk, this, ref(next));
+
+        priceChunk(current);
+        m_positions += (long long)current.count;
+        BSDL_PROFILE_PROGRESS(m_positions, m_binaryInput ? (long long)m_binIn.getNumRows() : 0, 0);
+
+        if (pendingWrite.valid() && !pendingWrite.get()) {
+            m_error = "Unable to write " + outputFile;
+            ok = false;
+        }
+        writing = move(current);
+        pendingWrite = async(launch::async, &PortfolioPricerBS::writeChunk, this, ref(writing));
+        ok = pendingRead.get() && ok;
+        current = move(next);
+    }
+    if (pendingWrite.valid() && !pendingWrite.get() && ok) {
+        m_error = "Unable to write " + outputFile;
+        ok = false;
+    }
+    // Every read has been joined, its error can be merged
+    if (m_error.empty()) m_error = m_readError;
+
+    bool closed = m_binaryOutput ? m_binOut.close() : (m_csvOut.close(), !m_csvOut.fail());
+    if (m_binaryInput) m_binIn.close(); else m_csvIn.close();
+    if (ok && !closed) {
+        m_error = "Unable to write " + outputFile;
+        ok = false;
+    }
+    m_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return ok;
+}
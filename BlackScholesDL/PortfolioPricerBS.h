@@ -0,0 +1,117 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	PortfolioPricerBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the PortfolioPricerBS Class, streaming repricing of
+*					a portfolio file of European options in fixed size chunks.
+*
+*					CSV input : T,K,S0,sigma,r,type per line, type is call/put (or c/p,
+*					            1/-1), a first line whose first field is not a number is
+*					            the header and skipped.
+*					Positions : T, K, S0 and sigma must be positive and r not negative, as
+*					            for the price command; the first invalid row stops the run.
+*					Binary    : columnar file (ColumnarFormatBS.h) with the columns time,
+*					            strike_price, stock_price, volatility, interest_rate and
+*					            an optional type (1 call, -1 put). Without type, as in the
+*					            files of generate --format bin64, both legs are priced.
+*					Output    : CSV type,price,delta,gamma,theta, one line per leg, or a
+*					            columnar file when both files are .bsdl with the columns
+*					            price, delta, gamma, theta, or price_o1, delta_o1,
+*					            theta_o1, price_o2, delta_o2, theta_o2, gamma (o1 call,
+*					            o2 put, as the generator) when both legs are priced
+* References	:
+* Other files	:	EurSimdBS.h, ColumnarReaderBS.h, ColumnarWriterBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ColumnarReaderBS.h"
+#include "ColumnarWriterBS.h"
+
+using namespace std;
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// One chunk of positions, the input pointers address either the owned vectors
+// (CSV input) or the memory mapped file (binary input)
+struct PortfolioChunk {
+    long long first = 0;
+    size_t count = 0;
+    const double* T = nullptr;
+    const double* K = nullptr;
+    const double* S0 = nullptr;
+    const double* sigma = nullptr;
+    const double* r = nullptr;
+    vector<double> ownT, ownK, ownS0, ownSigma, ownR;
+    vector<char> isCall;
+    vector<double> price, delta, gamma, theta;
+    vector<double> putPrice, putDelta, putTheta;  // Put leg when both legs are priced
+    string text;                        // Formatted CSV output of the chunk
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class PortfolioPricerBS
+{
+    public:
+
+        //constructors
+        PortfolioPricerBS();
+
+        //accessors
+        void setChunkRows(size_t chunkRows);
+        void setThreads(int numThreads);
+        long long getPositions();
+        double getSeconds();
+        double getPositionsPerSecond();
+        string getError();
+
+        // Public Member functions
+        bool reprice(const string& inputFile, const string& outputFile);
+        static bool parseType(const char* text, char& isCall);
+        static bool isHeader(const char* line);
+        static bool isValidPosition(double T, double K, double S0, double sigma, double r);
+
+    private:
+
+        // private Member functions
+        bool openInput(const string& inputFile);
+        bool readChunk(PortfolioChunk& chunk);
+        bool readCsvChunk(PortfolioChunk& chunk);
+        bool readBinaryChunk(PortfolioChunk& chunk);
+        void priceChunk(PortfolioChunk& chunk);
+        void priceRange(PortfolioChunk& chunk, size_t begin, size_t end, int worker);
+        bool writeChunk(PortfolioChunk& chunk);
+
+        // private  Member variables
+        size_t m_chunkRows;             // Positions per chunk
+        int m_threads;                  // Pricing threads, 0 uses every hardware thread
+        bool m_binaryInput;             // Input is a columnar file
+        bool m_binaryOutput;            // Output is a columnar file
+        ifstream m_csvIn;               // CSV input
+        long long m_csvLine;            // Last CSV line read, for error messages
+        ColumnarReaderBS m_binIn;       // Binary input
+        int m_binColumns[6];            // Input column indexes, type is -1 when absent
+        bool m_bothLegs;                // No type column, price the call and the put
+        long long m_nextRow;            // Next binary row to read
+        ofstream m_csvOut;              // CSV output
+        ColumnarWriterBS m_binOut;      // Binary output
+        long long m_positions;          // Positions priced by the last run
+        double m_seconds;               // Wall time of the last run
+        string m_error;                 // Reason of the last failure, written by the calling thread
+        string m_readError;             // Failure of the reading stage, merged into m_error after the join
+};
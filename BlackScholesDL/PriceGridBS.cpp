@@ -0,0 +1,399 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	PriceGridBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the PriceGridBS Class
+*
+* References	:
+* Other files	:	EurKernelBS.h, EurBatchBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <thread>
+
+#include "CounterRNG.h"
+#include "EurKernelBS.h"
+#include "PriceGridBS.h"
+
+// Largest number of nodes along one axis
+static const size_t maxAxisNodes = 1 << 20;
+
+// Random points checked by measureError on top of every cell centre
+static const uint64_t errorSamples = 1 << 16;
+
+// Grid growths tried by buildToTolerance before giving up
+static const int maxRefinements = 8;
+
+// Ranges must be finite and increasing, every axis needs enough nodes for the method
+static bool validSpec(const PriceGridSpec& spec) {
+    size_t minNodes = spec.method == GRID_CUBIC ? 4 : 2;
+    const double bounds[] = { spec.moneynessMin, spec.moneynessMax, spec.varianceMin, spec.varianceMax };
+    for (double bound : bounds) {
+        if (!isfinite(bound)) return false;
+    }
+    return (spec.method == GRID_LINEAR || spec.method == GRID_CUBIC)
+        && spec.moneynessMin > 0 && spec.moneynessMax > spec.moneynessMin
+        && spec.varianceMin > 0 && spec.varianceMax > spec.varianceMin
+        && spec.numMoneyness >= minNodes && spec.numVolatility >= minNodes
+        && spec.numMoneyness <= maxAxisNodes && spec.numVolatility <= maxAxisNodes;
+}
+
+// Exact node values at forward moneyness f and total volatility s, with T = 1, K = 1, r = 0
+static void exactNode(double f, double s, double value[GRID_CHANNELS]) {
+    EurKernelResult res = EurKernelBS<PAYOFF_CALL, GREEK_PRICE | GREEK_DELTA | GREEK_GAMMA>::evaluate(1.0, 1.0, f, s, 0.0);
+    value[GRID_PRICE] = res.price;
+    value[GRID_DELTA] = res.delta;
+    value[GRID_DENSITY] = res.gamma * s * f;
+    value[GRID_EXERCISE] = f * value[GRID_DELTA] - value[GRID_PRICE];
+}
+
+// Fold the difference between exact and interpolated values into the largest errors
+static void addError(const double exact[GRID_CHANNELS], const double approx[GRID_CHANNELS], PriceGridError& error) {
+    error.price = max(error.price, fabs(exact[GRID_PRICE] - approx[GRID_PRICE]));
+    error.delta = max(error.delta, fabs(exact[GRID_DELTA] - approx[GRID_DELTA]));
+    error.density = max(error.density, fabs(exact[GRID_DENSITY] - approx[GRID_DENSITY]));
+    error.exercise = max(error.exercise, fabs(exact[GRID_EXERCISE] - approx[GRID_EXERCISE]));
+}
+
+// Run body(0) ... body(count - 1) spread over the hardware threads
+static void forEachSlice(size_t count, const function<void(size_t)>& body) {
+    size_t numThreads = min(count, (size_t)max(1u, thread::hardware_concurrency()));
+    vector<future<void>> tasks;
+    for (size_t t = 0; t < numThreads; ++t) {
+        tasks.push_back(async(launch::async, [&body, t, numThreads, count]() {
+            for (size_t slice = t; slice < count; slice += numThreads) body(slice);
+        }));
+    }
+    for (future<void>& task : tasks) task.get();
+}
+
+// Weighted sum of P x P nodes, weight[axis][point]. Each row is summed on its own so the
+// rows do not wait on each other, and the sums stay in locals: value could alias the
+// nodes as far as the compiler knows and would be reloaded after every add
+template <int P>
+static void gather(const PriceGridNode* first, size_t strideS, const double weight[2][4], double value[GRID_CHANNELS]) {
+    double row[P][GRID_CHANNELS];
+    for (int j = 0; j < P; ++j) {
+        const PriceGridNode* node = first + j * strideS;
+        for (int c = 0; c < GRID_CHANNELS; ++c) row[j][c] = weight[0][0] * node[0].value[c];
+        for (int i = 1; i < P; ++i) {
+            for (int c = 0; c < GRID_CHANNELS; ++c) row[j][c] += weight[0][i] * node[i].value[c];
+        }
+    }
+    for (int c = 0; c < GRID_CHANNELS; ++c) {
+        double sum = 0;
+        for (int j = 0; j < P; ++j) sum += weight[1][j] * row[j][c];
+        value[c] = sum;
+    }
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+PriceGridBS::PriceGridBS() : m_error{ 0, 0, 0, 0 } {
+    setAxes();
+}
+
+//accessors
+const PriceGridSpec& PriceGridBS::getSpec() const { return m_spec; }
+const PriceGridError& PriceGridBS::getError() const { return m_error; }
+size_t PriceGridBS::getNumNodes() const { return m_nodes.size(); }
+size_t PriceGridBS::getMemoryBytes() const { return m_nodes.size() * sizeof(PriceGridNode); }
+bool PriceGridBS::isBuilt() const { return !m_nodes.empty(); }
+
+// Axes coordinates of the nodes from the spec
+void PriceGridBS::setAxes() {
+    m_lo[0] = m_spec.moneynessMin;
+    m_hi[0] = m_spec.moneynessMax;
+    m_lo[1] = sqrt(sqrt(m_spec.varianceMin));
+    m_hi[1] = sqrt(sqrt(m_spec.varianceMax));
+    m_num[0] = m_spec.numMoneyness;
+    m_num[1] = m_spec.numVolatility;
+    for (int a = 0; a < 2; ++a) {
+        m_step[a] = (m_hi[a] - m_lo[a]) / (double)(m_num[a] - 1);
+        m_invStep[a] = 1.0 / m_step[a];
+    }
+}
+
+// Evaluate every node with the closed form formulas, then measure the interpolation error
+bool PriceGridBS::build(const PriceGridSpec& spec) {
+    if (!validSpec(spec)) return false;
+    m_spec = spec;
+    setAxes();
+    m_nodes.assign(m_num[0] * m_num[1], PriceGridNode());
+    forEachSlice(m_num[1], [this](size_t j) {
+        double q = m_lo[1] + j * m_step[1], s = q * q;
+        for (size_t i = 0; i < m_num[0]; ++i) {
+            double f = m_lo[0] + i * m_step[0];
+            exactNode(f, s, m_nodes[j * m_num[0] + i].value);
+        }
+    });
+    m_error = measureError();
+    return true;
+}
+
+// Grow the axes whose own error is too large until the price error is within tolerance,
+// false when maxNodes or the refinement limit is reached first (the last grid is kept)
+bool PriceGridBS::buildToTolerance(const PriceGridSpec& spec, double tolerance, size_t maxNodes) {
+    if (!(tolerance > 0)) return false;
+    double order = spec.method == GRID_CUBIC ? 4.0 : 2.0;
+    PriceGridSpec current = spec;
+    for (int round = 0; ; ++round) {
+        if (!build(current)) return false;
+        if (m_error.price <= tolerance) return true;
+        if (round == maxRefinements) return false;
+
+        // Interpolation error falls as step^order, each axis is given half of the tolerance
+        double axisError[2], growth[2];
+        measureAxisErrors(axisError);
+        for (int a = 0; a < 2; ++a) {
+            growth[a] = axisError[a] > tolerance / 2 ? 1.1 * pow(axisError[a] * 2 / tolerance, 1.0 / order) : 1.0;
+        }
+        size_t* sizes[2] = { &current.numMoneyness, &current.numVolatility };
+        size_t grown[2];
+        auto grow = [&](double scale) {
+            for (int a = 0; a < 2; ++a) {
+                grown[a] = min(maxAxisNodes, (size_t)ceil((*sizes[a] - 1) * pow(growth[a], scale)) + 1);
+            }
+            return (double)grown[0] * (double)grown[1] <= (double)maxNodes;
+        };
+
+        // Scale the growth down when the full step would exceed maxNodes
+        if (!grow(1.0)) {
+            double lo = 0, hi = 1;
+            for (int step = 0; step < 30; ++step) {
+                double scale = 0.5 * (lo + hi);
+                if (grow(scale)) lo = scale;
+                else hi = scale;
+            }
+            grow(lo);
+        }
+        if (grown[0] == *sizes[0] && grown[1] == *sizes[1]) return false;
+        for (int a = 0; a < 2; ++a) *sizes[a] = grown[a];
+    }
+}
+
+// Largest errors over every cell centre, where bilinear interpolation is worst,
+// and over reproducible random points, where the cubic errors peak off centre
+PriceGridError PriceGridBS::measureError() const {
+    size_t cellsS = m_num[1] - 1;
+    vector<PriceGridError> sliceError(cellsS + 1, PriceGridError{ 0, 0, 0, 0 });
+    forEachSlice(cellsS + 1, [this, cellsS, &sliceError](size_t j) {
+        double exact[GRID_CHANNELS], approx[GRID_CHANNELS];
+        if (j < cellsS) {
+            double q = m_lo[1] + (j + 0.5) * m_step[1];
+            for (size_t i = 0; i + 1 < m_num[0]; ++i) {
+                double f = m_lo[0] + (i + 0.5) * m_step[0];
+                exactNode(f, q * q, exact);
+                interpolate(f, q, approx);
+                addError(exact, approx, sliceError[j]);
+            }
+            return;
+        }
+        CounterRNG rng(1);
+        for (uint64_t row = 0; row < errorSamples; ++row) {
+            double f = rng.uniform(row, 0, m_lo[0], m_hi[0]);
+            double q = rng.uniform(row, 1, m_lo[1], m_hi[1]);
+            exactNode(f, q * q, exact);
+            interpolate(f, q, approx);
+            addError(exact, approx, sliceError[j]);
+        }
+    });
+    PriceGridError error = { 0, 0, 0, 0 };
+    for (const PriceGridError& slice : sliceError) {
+        error.price = max(error.price, slice.price);
+        error.delta = max(error.delta, slice.delta);
+        error.density = max(error.density, slice.density);
+        error.exercise = max(error.exercise, slice.exercise);
+    }
+    return error;
+}
+
+// Largest price error halfway between nodes along one axis at a time, which isolates
+// the contribution of each axis to the total error
+void PriceGridBS::measureAxisErrors(double axisError[2]) const {
+    vector<PriceGridError> sliceError(2 * m_num[1], PriceGridError{ 0, 0, 0, 0 });
+    forEachSlice(m_num[1], [this, &sliceError](size_t j) {
+        double exact[GRID_CHANNELS], approx[GRID_CHANNELS];
+        for (size_t i = 0; i < m_num[0]; ++i) {
+            size_t index[2] = { i, j };
+            for (int a = 0; a < 2; ++a) {
+                if (index[a] + 1 == m_num[a]) continue;
+                double f = m_lo[0] + (i + (a == 0 ? 0.5 : 0.0)) * m_step[0];
+                double q = m_lo[1] + (j + (a == 1 ? 0.5 : 0.0)) * m_step[1];
+                exactNode(f, q * q, exact);
+                interpolate(f, q, approx);
+                addError(exact, approx, sliceError[2 * j + a]);
+            }
+        }
+    });
+    for (int a = 0; a < 2; ++a) {
+        axisError[a] = 0;
+        for (size_t j = 0; j < m_num[1]; ++j) axisError[a] = max(axisError[a], sliceError[2 * j + a].price);
+    }
+}
+
+// Header and nodes in one binary file, loaded back by load()
+bool PriceGridBS::save(const string& fileName) const {
+    if (!isBuilt()) return false;
+    PriceGridHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, priceGridMagic, sizeof(priceGridMagic));
+    header.version = priceGridVersion;
+    header.method = (uint32_t)m_spec.method;
+    header.numMoneyness = (uint32_t)m_spec.numMoneyness;
+    header.numVolatility = (uint32_t)m_spec.numVolatility;
+    header.channels = GRID_CHANNELS;
+    header.moneynessMin = m_spec.moneynessMin;
+    header.moneynessMax = m_spec.moneynessMax;
+    header.varianceMin = m_spec.varianceMin;
+    header.varianceMax = m_spec.varianceMax;
+    header.error = m_error;
+
+    ofstream file(fileName, ios::binary | ios::trunc);
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)m_nodes.data(), (streamsize)getMemoryBytes());
+    return file.good();
+}
+
+// Read a grid written by save(), the grid is left empty when the file is not valid
+bool PriceGridBS::load(const string& fileName) {
+    m_nodes.clear();
+    ifstream file(fileName, ios::binary);
+    PriceGridHeader header;
+    if (!file.read((char*)&header, sizeof(header))) return false;
+
+    PriceGridSpec spec;
+    spec.method = (PriceGridMethod)header.method;
+    spec.numMoneyness = header.numMoneyness;
+    spec.numVolatility = header.numVolatility;
+    spec.moneynessMin = header.moneynessMin;
+    spec.moneynessMax = header.moneynessMax;
+    spec.varianceMin = header.varianceMin;
+    spec.varianceMax = header.varianceMax;
+    if (memcmp(header.magic, priceGridMagic, sizeof(priceGridMagic)) != 0 || header.version != priceGridVersion
+        || header.channels != GRID_CHANNELS || !validSpec(spec)) return false;
+
+    // The nodes must be exactly the rest of the file, checked before allocating them so a
+    // crafted header cannot request more memory than the file holds
+    size_t numNodes = spec.numMoneyness * spec.numVolatility;
+    streamoff position = file.tellg();
+    file.seekg(0, ios::end);
+    streamoff remaining = file.tellg() - position;
+    if (position < 0 || remaining < 0 || (unsigned long long)remaining != numNodes * sizeof(PriceGridNode)) return false;
+    file.seekg(position);
+
+    vector<PriceGridNode> nodes(numNodes);
+    if (!file.read((char*)nodes.data(), (streamsize)(nodes.size() * sizeof(PriceGridNode)))
+        || file.peek() != ifstream::traits_type::eof()) return false;
+    m_spec = spec;
+    m_error = header.error;
+    m_nodes.swap(nodes);
+    setAxes();
+    return true;
+}
+
+// True when the quote lies inside the grid ranges
+bool PriceGridBS::contains(double T, double K, double S0, double sigma, double r) const {
+    if (!isBuilt() || !(T > 0 && K > 0)) return false;
+    double f = S0 / (K * exp(-r * T)), s = sigma * sqrt(T);
+    return f >= m_spec.moneynessMin && f <= m_spec.moneynessMax && s * s >= m_spec.varianceMin && s * s <= m_spec.varianceMax;
+}
+
+// Interpolated node values at one point inside the grid
+void PriceGridBS::interpolate(double f, double q, double value[GRID_CHANNELS]) const {
+    const double coord[2] = { f, q };
+    double weight[2][4];
+    size_t first[2];
+    for (int a = 0; a < 2; ++a) {
+        double position = max(0.0, (coord[a] - m_lo[a]) * m_invStep[a]);
+        size_t cell = min((size_t)(int)position, m_num[a] - 2);
+        if (m_spec.method == GRID_LINEAR) {
+            double t = position - (double)cell;
+            first[a] = cell;
+            weight[a][0] = 1.0 - t;
+            weight[a][1] = t;
+        }
+        else {
+            // Lagrange weights of the 4 nodes around the cell, shifted inwards at the edges
+            first[a] = min(cell > 0 ? cell - 1 : 0, m_num[a] - 4);
+            double t = position - (double)first[a];
+            weight[a][0] = -(t - 1) * (t - 2) * (t - 3) * (1.0 / 6);
+            weight[a][1] = t * (t - 2) * (t - 3) * 0.5;
+            weight[a][2] = -t * (t - 1) * (t - 3) * 0.5;
+            weight[a][3] = t * (t - 1) * (t - 2) * (1.0 / 6);
+        }
+    }
+    const PriceGridNode* node = &m_nodes[first[0] + first[1] * m_num[0]];
+    if (m_spec.method == GRID_LINEAR) gather<2>(node, m_num[0], weight, value);
+    else gather<4>(node, m_num[0], weight, value);
+}
+
+// Scale the normalised node values to one quote, false when it lies outside the grid
+bool PriceGridBS::quote(double K, double S0, double sigma, double r, double discount, double sqrtT, EurBSRecord& rec) const {
+    double strikePV = K * discount;
+    double f = S0 / strikePV, s = sigma * sqrtT;
+    if (!(f >= m_spec.moneynessMin && f <= m_spec.moneynessMax && s * s >= m_spec.varianceMin && s * s <= m_spec.varianceMax)) return false;
+    double value[GRID_CHANNELS];
+    interpolate(f, sqrt(s), value);
+
+    // Same terms as EurCallBS and EurPutBS, the put through put-call parity
+    double decay = -(sigma * S0) / (2 * sqrtT) * value[GRID_DENSITY];
+    rec.callPrice = strikePV * value[GRID_PRICE];
+    rec.putPrice = strikePV * (value[GRID_PRICE] - f + 1.0);
+    rec.callDelta = value[GRID_DELTA];
+    rec.putDelta = value[GRID_DELTA] - 1.0;
+    rec.gamma = value[GRID_DENSITY] / (S0 * s);
+    rec.callTheta = decay - r * strikePV * value[GRID_EXERCISE];
+    rec.putTheta = decay + r * strikePV * (1.0 - value[GRID_EXERCISE]);
+    return true;
+}
+
+// Call and put of one quote, false when it was priced by the closed form instead
+bool PriceGridBS::lookup(double T, double K, double S0, double sigma, double r, EurBSRecord& rec) const {
+    if (isBuilt() && T > 0 && K > 0 && quote(K, S0, sigma, r, exp(-r * T), sqrt(T), rec)) return true;
+    rec = EurBatchBS::evaluate(T, K, S0, sigma, r);
+    return false;
+}
+
+// Same outputs as EurBatchBS::evaluateBatch, returns how many quotes the grid answered.
+// Quotes of one expiry usually come together, so exp(-rT) and sqrt(T) are reused.
+size_t PriceGridBS::lookupBatch(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put) const {
+    size_t inGrid = 0;
+    double lastT = nan(""), lastR = nan(""), discount = 0, sqrtT = 0;
+    for (size_t i = 0; i < in.n; ++i) {
+        double T = in.T[i], K = in.K[i], S0 = in.S0[i], sigma = in.sigma[i], r = in.r[i];
+        EurBSRecord rec;
+        if (T != lastT || r != lastR) {
+            lastT = T;
+            lastR = r;
+            discount = exp(-r * T);
+            sqrtT = sqrt(T);
+        }
+        if (isBuilt() && T > 0 && K > 0 && quote(K, S0, sigma, r, discount, sqrtT, rec)) ++inGrid;
+        else rec = EurBatchBS::evaluate(T, K, S0, sigma, r);
+        if (call.price) call.price[i] = rec.callPrice;
+        if (call.delta) call.delta[i] = rec.callDelta;
+        if (call.gamma) call.gamma[i] = rec.gamma;
+        if (call.theta) call.theta[i] = rec.callTheta;
+        if (put.price) put.price[i] = rec.putPrice;
+        if (put.delta) put.delta[i] = rec.putDelta;
+        if (put.gamma) put.gamma[i] = rec.gamma;
+        if (put.theta) put.theta[i] = rec.putTheta;
+    }
+    return inGrid;
+}
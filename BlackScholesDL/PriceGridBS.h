@@ -0,0 +1,152 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	PriceGridBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the PriceGridBS Class, a precomputed grid of normalised
+*					call prices and Greeks that answers quotes by interpolation.
+*
+*					Axes      : forward moneyness f = S0*exp(r*T)/K and total volatility
+*					            s = sigma*sqrt(T), bounded by the total variance s*s.
+*					            In forward terms r*T only scales the result, so it
+*					            needs no axis. The f nodes are uniform, the s nodes
+*					            are uniform in sqrt(s), closer together at low s where
+*					            the prices bend the most.
+*					Node      : undiscounted call price / K, N(d1), phi(d1) and N(d2),
+*					            from EurKernelBS with T = 1, K = 1 and r = 0, stored
+*					            together so that a lookup reads a few contiguous nodes.
+*					File      : PriceGridHeader, little endian, followed by the nodes
+*					            with f varying fastest.
+* References	:
+* Other files	:	EurKernelBS.h, EurBatchBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "EurBatchBS.h"
+
+using namespace std;
+
+// File signature and version of the grid layout
+static const char priceGridMagic[8] = { 'B', 'S', 'D', 'L', 'G', 'R', 'I', 'D' };
+static const uint32_t priceGridVersion = 1;
+
+// Interpolation between the nodes
+enum PriceGridMethod {
+    GRID_LINEAR = 0,        // Bilinear, reads 4 nodes
+    GRID_CUBIC = 1          // Tensor product of 4 point cubics, reads 16 nodes
+};
+
+// Values stored at each node
+enum PriceGridChannel {
+    GRID_PRICE = 0,         // Undiscounted call price / K, f*N(d1) - N(d2)
+    GRID_DELTA,             // N(d1)
+    GRID_DENSITY,           // phi(d1)
+    GRID_EXERCISE,          // N(d2)
+    GRID_CHANNELS
+};
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Range and resolution of a grid
+struct PriceGridSpec {
+    double moneynessMin = 0.5;      // Forward moneyness S0*exp(r*T)/K
+    double moneynessMax = 2.0;
+    double varianceMin = 0.0025;    // sigma*sigma*T, sigma*sqrt(T) from 0.05
+    double varianceMax = 2.25;      // to 1.5
+    size_t numMoneyness = 257;      // Nodes per axis
+    size_t numVolatility = 129;
+    PriceGridMethod method = GRID_LINEAR;
+};
+
+// Largest interpolation errors found per channel, prices are per unit strike
+struct PriceGridError {
+    double price;           // Bounds the call and put price / K error when r >= 0
+    double delta;
+    double density;         // phi(d1) = gamma * S0 * sigma * sqrt(T)
+    double exercise;        // N(d2), drives the rate term of theta
+};
+
+// One node, see PriceGridChannel for the order of the values
+struct PriceGridNode {
+    double value[GRID_CHANNELS];
+};
+
+// Fixed header of a grid file
+struct PriceGridHeader {
+    char magic[8];              // priceGridMagic
+    uint32_t version;           // priceGridVersion
+    uint32_t method;            // PriceGridMethod
+    uint32_t numMoneyness;      // Nodes per axis
+    uint32_t numVolatility;
+    uint32_t channels;          // GRID_CHANNELS
+    uint32_t reserved;          // Zero
+    double moneynessMin;        // Axes as in PriceGridSpec
+    double moneynessMax;
+    double varianceMin;
+    double varianceMax;
+    PriceGridError error;       // Errors measured when the grid was built
+};
+
+static_assert(sizeof(PriceGridNode) == 32, "PriceGridNode must be packed to 32 bytes");
+static_assert(sizeof(PriceGridHeader) == 96, "PriceGridHeader must be packed to 96 bytes");
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class PriceGridBS
+{
+    public:
+
+        //constructors
+        PriceGridBS();
+
+        //accessors
+        const PriceGridSpec& getSpec() const;
+        const PriceGridError& getError() const;
+        size_t getNumNodes() const;
+        size_t getMemoryBytes() const;
+        bool isBuilt() const;
+
+        // Public Member functions
+        bool build(const PriceGridSpec& spec);
+        bool buildToTolerance(const PriceGridSpec& spec, double tolerance, size_t maxNodes);
+        bool save(const string& fileName) const;
+        bool load(const string& fileName);
+
+        // Quotes inside the grid are interpolated, the rest fall back to EurBatchBS::evaluate
+        bool contains(double T, double K, double S0, double sigma, double r) const;
+        bool lookup(double T, double K, double S0, double sigma, double r, EurBSRecord& rec) const;
+        size_t lookupBatch(const EurBSBatchInput& in, const EurBSBatchOutput& call, const EurBSBatchOutput& put) const;
+
+    private:
+
+        // private Member functions
+        void setAxes();
+        bool quote(double K, double S0, double sigma, double r, double discount, double sqrtT, EurBSRecord& rec) const;
+        void interpolate(double f, double q, double value[GRID_CHANNELS]) const;
+        PriceGridError measureError() const;
+        void measureAxisErrors(double axisError[2]) const;
+
+        // private  Member variables
+        PriceGridSpec m_spec;           // Ranges, resolution and method
+        PriceGridError m_error;         // Errors measured after the build
+        vector<PriceGridNode> m_nodes;  // Node values, f varying fastest
+        double m_lo[2];                 // First node of the f and sqrt(s) axes
+        double m_hi[2];                 // Last node of each axis
+        double m_step[2];               // Node spacing of each axis
+        double m_invStep[2];            // Reciprocal spacing, used by the lookups
+        size_t m_num[2];                // Nodes per axis
+};
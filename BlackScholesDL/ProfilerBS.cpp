@@ -0,0 +1,186 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ProfilerBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the ProfilerBS Class
+*
+* References	:
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+
+#include "ProfilerBS.h"
+
+// Out of class definition, min() binds ioWorker by reference
+const int ProfilerBS::ioWorker;
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// Counters of one worker, on their own cache lines so workers never share one
+struct alignas(64) ProfileSlot {
+    atomic<uint64_t> nanoseconds[PROFILE_STAGES];
+    atomic<uint64_t> cycles[PROFILE_STAGES];
+    atomic<uint64_t> calls[PROFILE_STAGES];
+    atomic<uint64_t> rows[PROFILE_STAGES];
+    atomic<uint64_t> bytes[PROFILE_STAGES];
+};
+
+static ProfileSlot profileSlots[ProfilerBS::maxWorkers];
+
+// Progress lines: destination, interval and times since the last reset
+static ostream* progressOut = nullptr;
+static double progressInterval = 1.0;
+static chrono::steady_clock::time_point profileStart = chrono::steady_clock::now();
+static atomic<long long> lastProgress(0);
+
+static int slotOf(int worker) {
+    return worker < 0 ? 0 : min(worker, ProfilerBS::ioWorker);
+}
+
+static uint64_t total(const atomic<uint64_t> (ProfileSlot::*counter)[PROFILE_STAGES], int stage) {
+    uint64_t sum = 0;
+    for (const ProfileSlot& slot : profileSlots) sum += (slot.*counter)[stage].load(memory_order_relaxed);
+    return sum;
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//accessors
+bool ProfilerBS::isEnabled() {
+#ifdef BSDL_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+string ProfilerBS::getStageName(ProfileStage stage) {
+    switch (stage) {
+    case STAGE_SAMPLE: return "sample";
+    case STAGE_MAP: return "map_round";
+    case STAGE_PRICE: return "price";
+    case STAGE_FORMAT: return "format";
+    case STAGE_COMPRESS: return "compress";
+    case STAGE_READ: return "read";
+    case STAGE_WAIT: return "wait";
+    default: return "write";
+    }
+}
+
+// Progress lines go to out every intervalSeconds, a null stream disables them
+void ProfilerBS::setProgress(ostream* out, double intervalSeconds) {
+    progressOut = out;
+    progressInterval = intervalSeconds;
+}
+
+// Zero every counter and restart the progress clock, call it before a run
+void ProfilerBS::reset() {
+    for (ProfileSlot& slot : profileSlots) {
+        for (int s = 0; s < PROFILE_STAGES; ++s) {
+            slot.nanoseconds[s].store(0, memory_order_relaxed);
+            slot.cycles[s].store(0, memory_order_relaxed);
+            slot.calls[s].store(0, memory_order_relaxed);
+            slot.rows[s].store(0, memory_order_relaxed);
+            slot.bytes[s].store(0, memory_order_relaxed);
+        }
+    }
+    profileStart = chrono::steady_clock::now();
+    lastProgress.store(0, memory_order_relaxed);
+}
+
+void ProfilerBS::addTime(ProfileStage stage, int worker, uint64_t nanoseconds, uint64_t cycles) {
+    ProfileSlot& slot = profileSlots[slotOf(worker)];
+    slot.nanoseconds[stage].fetch_add(nanoseconds, memory_order_relaxed);
+    slot.cycles[stage].fetch_add(cycles, memory_order_relaxed);
+    slot.calls[stage].fetch_add(1, memory_order_relaxed);
+}
+
+void ProfilerBS::count(ProfileStage stage, int worker, long long rows, long long bytes) {
+    ProfileSlot& slot = profileSlots[slotOf(worker)];
+    slot.rows[stage].fetch_add((uint64_t)rows, memory_order_relaxed);
+    slot.bytes[stage].fetch_add((uint64_t)bytes, memory_order_relaxed);
+}
+
+// One line when the interval has passed since the last one, rows and bytes are the totals
+// done so far and totalRows is 0 when unknown; only the caller winning the exchange prints
+void ProfilerBS::progress(long long rows, long long totalRows, long long bytes) {
+    if (!progressOut) return;
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - profileStart).count();
+    long long tick = (long long)(elapsed / progressInterval);
+    long long last = lastProgress.load(memory_order_relaxed);
+    if (tick <= last || !lastProgress.compare_exchange_strong(last, tick) || elapsed <= 0) return;
+    double rate = rows / elapsed;
+    ostream& out = *progressOut;
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << fixed << setprecision(1) << "progress: rows " << rows;
+    if (totalRows > 0) out << "/" << totalRows << " (" << 100.0 * rows / totalRows << "%)";
+    out << ", rows/sec " << setprecision(0) << rate << ", MB/sec " << setprecision(1) << bytes / elapsed / 1e6
+        << ", elapsed " << elapsed << " s";
+    if (totalRows > 0 && rate > 0) out << ", eta " << (totalRows - rows) / rate << " s";
+    out << endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+// Per stage totals over the workers as CSV: seconds are worker seconds, share is the part
+// of all the timed seconds, per row figures use the rows counted by the stage. The wall
+// line gives the end to end rows (priced) and bytes (written or read) per second.
+void ProfilerBS::report(ostream& out, double wallSeconds, bool perWorker) {
+    if (!isEnabled()) {
+        out << "Profiling counters are not compiled in, rebuild with BSDL_PROFILE defined" << endl;
+        return;
+    }
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    double timed = 0;
+    for (int s = 0; s < PROFILE_STAGES; ++s) timed += total(&ProfileSlot::nanoseconds, s) * 1e-9;
+
+    out << "stage,calls,rows,bytes,seconds,share,ns_per_row,cycles_per_row,rows_per_sec,mb_per_sec" << endl;
+    for (int s = 0; s < PROFILE_STAGES; ++s) {
+        uint64_t calls = total(&ProfileSlot::calls, s);
+        if (calls == 0) continue;
+        double rows = (double)total(&ProfileSlot::rows, s), bytes = (double)total(&ProfileSlot::bytes, s);
+        double seconds = total(&ProfileSlot::nanoseconds, s) * 1e-9, cycles = (double)total(&ProfileSlot::cycles, s);
+        out << getStageName((ProfileStage)s) << "," << calls << "," << (uint64_t)rows << "," << (uint64_t)bytes << ","
+            << fixed << setprecision(6) << seconds << "," << setprecision(3) << (timed > 0 ? seconds / timed : 0) << ","
+            << setprecision(2) << (rows > 0 ? seconds * 1e9 / rows : 0) << "," << (rows > 0 ? cycles / rows : 0) << ","
+            << setprecision(0) << (seconds > 0 ? rows / seconds : 0) << "," << setprecision(1)
+            << (seconds > 0 ? bytes / seconds / 1e6 : 0) << endl;
+    }
+    double rows = (double)total(&ProfileSlot::rows, STAGE_PRICE);
+    double bytes = (double)max(total(&ProfileSlot::bytes, STAGE_WRITE), total(&ProfileSlot::bytes, STAGE_READ));
+    out << "wall_seconds,rows_per_sec,mb_per_sec" << endl;
+    out << fixed << setprecision(6) << wallSeconds << "," << setprecision(0) << (wallSeconds > 0 ? rows / wallSeconds : 0)
+        << "," << setprecision(1) << (wallSeconds > 0 ? bytes / wallSeconds / 1e6 : 0) << endl;
+
+    if (perWorker) {
+        out << "worker,stage,calls,rows,seconds" << endl;
+        for (int w = 0; w < maxWorkers; ++w) {
+            const ProfileSlot& slot = profileSlots[w];
+            for (int s = 0; s < PROFILE_STAGES; ++s) {
+                uint64_t calls = slot.calls[s].load(memory_order_relaxed);
+                if (calls == 0) continue;
+                out << (w == ioWorker ? string("io") : to_string(w)) << "," << getStageName((ProfileStage)s) << ","
+                    << calls << "," << slot.rows[s].load(memory_order_relaxed) << "," << setprecision(6)
+                    << slot.nanoseconds[s].load(memory_order_relaxed) * 1e-9 << endl;
+            }
+        }
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,126 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ProfilerBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the ProfilerBS Class, per stage time, cycle, row and byte
+*					counters of the dataset generator and the portfolio pricer, to tell
+*					where a long run spends its time.
+*
+*					Build     : the BSDL_PROFILE_* macros generate no code unless
+*					            BSDL_PROFILE is defined, so a normal build pays nothing.
+*					Counters  : one cache line aligned slot per worker, added with relaxed
+*					            atomics once per block or chunk, never per row.
+*					Output    : a summary per stage (and optionally per worker) at the end
+*					            of a run, and progress lines at a fixed interval.
+*
+* References	:
+* Other files	:	EurDataSetBS.cpp, PortfolioPricerBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+// Stages of a run
+enum ProfileStage {
+    STAGE_SAMPLE = 0,       // Points of the unit cube
+    STAGE_MAP,              // Mapping to the inputs and roundUp
+    STAGE_PRICE,            // Prices and Greeks
+    STAGE_FORMAT,           // CSV text or float32 narrowing
+    STAGE_COMPRESS,         // Gzip members of the CSV pipeline
+    STAGE_READ,             // Parsing or mapping an input file
+    STAGE_WAIT,             // Output thread waiting for the workers, or workers for a buffer
+    STAGE_WRITE,            // Stream or columnar file writes
+    PROFILE_STAGES
+};
+
+// Timed scope and counters, compiled only with BSDL_PROFILE; otherwise the arguments are
+// only named, so variables kept for them raise no unused warnings and generate no code
+#define BSDL_PROFILE_CONCAT2(a, b) a##b
+#define BSDL_PROFILE_CONCAT(a, b) BSDL_PROFILE_CONCAT2(a, b)
+#ifdef BSDL_PROFILE
+#define BSDL_PROFILE_SCOPE(stage, worker) ProfileScopeBS BSDL_PROFILE_CONCAT(profileScope, __LINE__)(stage, worker)
+#define BSDL_PROFILE_COUNT(stage, worker, rows, bytes) ProfilerBS::count(stage, worker, rows, bytes)
+#define BSDL_PROFILE_PROGRESS(rows, totalRows, bytes) ProfilerBS::progress(rows, totalRows, bytes)
+#else
+#define BSDL_PROFILE_SCOPE(stage, worker) ((void)(worker))
+#define BSDL_PROFILE_COUNT(stage, worker, rows, bytes) ((void)(worker), (void)(rows), (void)(bytes))
+#define BSDL_PROFILE_PROGRESS(rows, totalRows, bytes) ((void)(rows), (void)(totalRows), (void)(bytes))
+#endif
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class ProfilerBS
+{
+    public:
+
+        //accessors
+        static bool isEnabled();
+        static string getStageName(ProfileStage stage);
+        static void setProgress(ostream* out, double intervalSeconds);
+
+        // Public Member functions
+        static void reset();
+        static void addTime(ProfileStage stage, int worker, uint64_t nanoseconds, uint64_t cycles);
+        static void count(ProfileStage stage, int worker, long long rows, long long bytes);
+        static void progress(long long rows, long long totalRows, long long bytes);
+        static void report(ostream& out, double wallSeconds, bool perWorker);
+
+        // Time stamp counter, zero where the processor has none
+        static inline uint64_t cycles() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return 0;
+#endif
+        }
+
+        // Counter slots, workers at or above ioWorker share the last one
+        static const int maxWorkers = 128;
+        static const int ioWorker = maxWorkers - 1;
+};
+
+// Adds its lifetime to a stage of a worker
+class ProfileScopeBS
+{
+    public:
+
+        ProfileScopeBS(ProfileStage stage, int worker) : m_stage(stage), m_worker(worker),
+            m_start(chrono::steady_clock::now()), m_cycles(ProfilerBS::cycles()) {}
+
+        ~ProfileScopeBS() {
+            uint64_t cycles = ProfilerBS::cycles() - m_cycles;
+            uint64_t nanoseconds = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - m_start).count();
+            ProfilerBS::addTime(m_stage, m_worker, nanoseconds, cycles);
+        }
+
+        ProfileScopeBS(const ProfileScopeBS&) = delete;
+        ProfileScopeBS& operator=(const ProfileScopeBS&) = delete;
+
+    private:
+
+        // private  Member variables
+        ProfileStage m_stage;
+        int m_worker;
+        chrono::steady_clock::time_point m_start;
+        uint64_t m_cycles;
+};
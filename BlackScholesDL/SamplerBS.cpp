@@ -0,0 +1,145 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	SamplerBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the SamplerBS Class
+*
+* References	:	- R. Cranley and T. N. L. Patterson, Randomization of number theoretic
+*					  methods for multiple integration, SIAM J. Numer. Anal., 1976
+*					- A. Kensler, Correlated Multi-Jittered Sampling, 2013
+* Other files	:	CounterRNG.cpp, SobolBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "SamplerBS.h"
+#include "SobolBS.h"
+
+// Halton bases, the first primes
+static const uint64_t haltonBases[SamplerBS::dimensions] = { 2, 3, 5, 7, 11 };
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+SamplerBS::SamplerBS() : SamplerBS(SAMPLING_UNIFORM, 0, 0) {}
+
+//Parametrized constructor, the shifts, rotations and keys come from draws 5 to 9 of
+//row 0, which the uniform and Latin samplers never use
+SamplerBS::SamplerBS(DataSetSampling sampling, uint64_t seed, long long numPoints) : m_sampling(sampling),
+    m_rng(seed), m_numPoints(numPoints), m_mask(numPoints > 1 ? (uint64_t)(numPoints - 1) : 0), m_permuteShift(1) {
+    for (int s = 1; s < 64; s *= 2) m_mask |= m_mask >> s;
+    int maskBits = 0;
+    while (maskBits < 64 && (m_mask >> maskBits)) ++maskBits;
+    if (maskBits > 1) m_permuteShift = (maskBits + 1) / 2;
+    for (int d = 0; d < dimensions; ++d) {
+        uint64_t bits = m_rng.bits(0, (uint64_t)(dimensions + d));
+        m_shift[d] = (uint32_t)(bits >> 32);
+        m_rotation[d] = (bits >> 11) * (1.0 / 9007199254740992.0);
+        for (int round = 0; round < 3; ++round) m_key[d][round] = bits >> (21 * round);
+    }
+}
+
+//accessors
+DataSetSampling SamplerBS::getSampling() { return m_sampling; }
+
+string SamplerBS::getSamplingName(DataSetSampling sampling) {
+    switch (sampling) {
+    case SAMPLING_SOBOL: return "sobol";
+    case SAMPLING_HALTON: return "halton";
+    case SAMPLING_LATIN: return "latin";
+    default: return "uniform";
+    }
+}
+
+bool SamplerBS::parseSampling(const string& name, DataSetSampling& sampling) {
+    for (int s = SAMPLING_UNIFORM; s <= SAMPLING_LATIN; ++s) {
+        if (name == getSamplingName((DataSetSampling)s)) {
+            sampling = (DataSetSampling)s;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Coordinates in [0, 1) of the points of rows [first, first + count), unit[d][i] is
+// dimension d of row first + i
+void SamplerBS::fill(long long first, long long count, double* const* unit) const {
+    switch (m_sampling) {
+    case SAMPLING_SOBOL: {
+        SobolBS points(dimensions, (uint64_t)first);
+        for (long long i = 0; i < count; ++i) {
+            for (int d = 0; d < dimensions; ++d) unit[d][i] = points.uniform(d, m_shift[d]);
+            points.next();
+        }
+        break;
+    }
+    case SAMPLING_HALTON:
+        fillHalton(first, count, unit);
+        break;
+    case SAMPLING_LATIN: {
+        double stratum = 1.0 / (double)m_numPoints;
+        for (long long i = 0; i < count; ++i) {
+            uint64_t row = (uint64_t)(first + i), jitter = m_rng.bits(row, 0);
+            // Stratum of the row, cycle walking the rare values outside [0, m_numPoints), and
+            // position inside the stratum from 12 bits per dimension of one draw
+            for (int d = 0; d < dimensions; ++d, jitter >>= 12) {
+                uint64_t index = permute(row, d);
+                while (index >= (uint64_t)m_numPoints) index = permute(index, d);
+                double u = ((double)(int64_t)index + ((jitter & 4095) + 0.5) * (1.0 / 4096.0)) * stratum;
+                unit[d][i] = u < 1.0 ? u : 1.0 - 0.5 * stratum * stratum;
+            }
+        }
+        break;
+    }
+    default:
+        for (long long i = 0; i < count; ++i) {
+            uint64_t row = (uint64_t)(first + i);
+            for (int d = 0; d < dimensions; ++d) unit[d][i] = m_rng.uniform(row, (uint64_t)d);
+        }
+    }
+}
+
+// The radical inverse of the row index is kept as the integer digits * base^(K - 1 - j),
+// K the most digits that fit in 63 bits, so stepping to the next row only adds and
+// subtracts digit weights and every block gets exactly the values of a direct evaluation
+void SamplerBS::fillHalton(long long first, long long count, double* const* unit) const {
+    for (int d = 0; d < dimensions; ++d) {
+        uint64_t base = haltonBases[d];
+        uint64_t weight[64];
+        int digits = 0;
+        for (uint64_t power = 1; power <= (UINT64_C(1) << 63) / base; power *= base) ++digits;
+        uint64_t power = 1;
+        for (int j = digits - 1; j >= 0; --j) {
+            weight[j] = power;
+            if (j > 0) power *= base;
+        }
+        double scale = 1.0 / ((double)power * (double)base);
+
+        uint64_t digit[64] = {}, value = 0, n = (uint64_t)first;
+        for (int j = 0; j < digits && n > 0; ++j, n /= base) {
+            digit[j] = n % base;
+            value += digit[j] * weight[j];
+        }
+
+        double* out = unit[d];
+        for (long long i = 0; i < count; ++i) {
+            double u = value * scale + m_rotation[d];
+            out[i] = u >= 1.0 ? u - 1.0 : u;
+            int j = 0;
+            while (j < digits - 1 && digit[j] == base - 1) {
+                digit[j] = 0;
+                value -= (base - 1) * weight[j];
+                ++j;
+            }
+            ++digit[j];
+            value += weight[j];
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	SamplerBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the SamplerBS Class, points of the unit cube that feed
+*					the dataset generator, one point per row and dimensions coordinates
+*					each. Row i always gets the same point whichever thread draws it.
+*
+*					Uniform   : independent draws of a CounterRNG, the original stream.
+*					Sobol     : Sobol sequence from point 0 with a random digital shift,
+*					            the first 2^m rows form a (t, m, s)-net.
+*					Halton    : radical inverses in bases 2, 3, 5, 7 and 11 with a random
+*					            rotation (Cranley-Patterson), kept as exact integers.
+*					Latin     : Latin hypercube of numPoints rows, dimension d of row i is
+*					            (pi_d(i) + u) / numPoints with pi_d a keyed permutation
+*					            evaluated without any table, so blocks stay independent.
+*
+* References	:	- P. Glasserman, Monte Carlo Methods in Financial Engineering, 2003,
+*					  chapter 5
+*					- A. Kensler, Correlated Multi-Jittered Sampling, Pixar Technical
+*					  Memo 13-01, 2013
+*					- M. D. McKay, R. J. Beckman and W. J. Conover, A comparison of three
+*					  methods for selecting values of input variables, Technometrics, 1979
+* Other files	:	CounterRNG.h, SobolBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstdint>
+#include <string>
+#include "CounterRNG.h"
+
+using namespace std;
+
+// Sampling strategies of the dataset inputs
+enum DataSetSampling { SAMPLING_UNIFORM = 0, SAMPLING_SOBOL = 1, SAMPLING_HALTON = 2, SAMPLING_LATIN = 3 };
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class SamplerBS
+{
+    public:
+
+        //constructors
+        SamplerBS();
+        SamplerBS(DataSetSampling sampling, uint64_t seed, long long numPoints);
+
+        //accessors
+        DataSetSampling getSampling();
+
+        // Public Member functions
+        void fill(long long first, long long count, double* const* unit) const;
+        static bool parseSampling(const string& name, DataSetSampling& sampling);
+        static string getSamplingName(DataSetSampling sampling);
+
+        // Coordinates per point
+        static const int dimensions = 5;
+
+    private:
+
+        // private Member functions
+        void fillHalton(long long first, long long count, double* const* unit) const;
+
+        // Keyed permutation of [0, m_mask] of one dimension: three rounds of xor with a key, an
+        // odd multiply and an xorshift, each a bijection of the lowest bits. Applying it again
+        // to values outside [0, m_numPoints) (cycle walking, Kensler) restricts it to the
+        // rows, fewer than two passes on average since m_mask < 2 m_numPoints
+        uint64_t permute(uint64_t index, int dimension) const {
+            const uint64_t* key = m_key[dimension];
+            index = ((index ^ key[0]) * 0xBF58476D1CE4E5B9ULL) & m_mask;
+            index ^= index >> m_permuteShift;
+            index = ((index ^ key[1]) * 0x94D049BB133111EBULL) & m_mask;
+            index ^= index >> m_permuteShift;
+            index = ((index ^ key[2]) * 0xD6E8FEB86659FD93ULL) & m_mask;
+            return index ^ (index >> m_permuteShift);
+        }
+
+        // private  Member variables
+        DataSetSampling m_sampling;     // Strategy of fill()
+        CounterRNG m_rng;               // Uniform draws, Latin jitter, shifts and keys
+        long long m_numPoints;          // Rows of a Latin hypercube
+        uint64_t m_mask;                // Smallest power of two minus one covering the rows
+        int m_permuteShift;             // Xorshift of the permutation rounds, half the mask bits
+        uint32_t m_shift[dimensions];   // Sobol digital shifts
+        double m_rotation[dimensions];  // Halton rotations
+        uint64_t m_key[dimensions][3];  // Latin permutation keys of the three rounds
+};
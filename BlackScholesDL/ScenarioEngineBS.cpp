@@ -0,0 +1,250 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ScenarioEngineBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the ScenarioEngineBS Class
+*
+* References	:	- J. C. Hull, Options, Futures and Other Derivatives, 10th ed., ch. 19
+* Other files	:	EurSimdBS.cpp, PortfolioPricerBS.cpp
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <thread>
+
+#include "ScenarioEngineBS.h"
+#include "EurSimdBS.h"
+#include "PortfolioPricerBS.h"
+
+const double ScenarioEngineBS::minVolatility = 0.0001;
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// Zeroed surfaces for the scenarios of a grid
+static void resizeSurface(ScenarioSurface& surface, const ScenarioGrid& grid) {
+    surface.numSpot = grid.spotShocks.size();
+    surface.numVol = grid.volShocks.size();
+    size_t n = surface.numSpot * surface.numVol;
+    vector<double>* fields[6] = { &surface.value, &surface.pnl, &surface.delta, &surface.gamma, &surface.vega, &surface.theta };
+    for (auto field : fields) field->assign(n, 0.0);
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+ScenarioEngineBS::ScenarioEngineBS() : m_threads(0), m_seconds(0), m_error("") {}
+
+//accessors
+size_t ScenarioEngineBS::getNumPositions() const { return m_S0.size(); }
+void ScenarioEngineBS::setThreads(int numThreads) { m_threads = numThreads; }
+int ScenarioEngineBS::getThreads() { return m_threads; }
+double ScenarioEngineBS::getSeconds() { return m_seconds; }
+string ScenarioEngineBS::getError() { return m_error; }
+
+// Check the positions and keep the invariants of each contract
+bool ScenarioEngineBS::setPortfolio(const ScenarioPortfolio& portfolio) {
+    const ScenarioPortfolio& p = portfolio;
+    size_t n = p.isCall.size();
+    if (p.T.size() != n || p.K.size() != n || p.S0.size() != n || p.sigma.size() != n || p.r.size() != n || p.quantity.size() != n) {
+        m_error = "Every field of the portfolio needs one value per position";
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (!(p.T[i] > 0 && p.K[i] > 0 && p.S0[i] > 0 && p.sigma[i] > 0 && isfinite(p.r[i]) && isfinite(p.quantity[i]))) {
+            m_error = "Position " + to_string(i + 1) + " needs a positive T, K, S0 and sigma";
+            return false;
+        }
+    }
+    m_logMoneyness.resize(n);
+    m_sqrtT.resize(n);
+    m_drift.resize(n);
+    m_discountedStrike.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        m_logMoneyness[i] = log(p.S0[i] / p.K[i]);
+        m_sqrtT[i] = sqrt(p.T[i]);
+        m_drift[i] = p.r[i] * p.T[i];
+        m_discountedStrike[i] = p.K[i] * exp(-m_drift[i]);
+    }
+    m_S0 = p.S0;
+    m_sigma = p.sigma;
+    m_r = p.r;
+    m_quantity = p.quantity;
+    m_isCall = p.isCall;
+    return true;
+}
+
+// Read a CSV portfolio, each line T,K,S0,sigma,r,type as reprice reads them with an
+// optional quantity after the type (1 when absent); a first line whose first field is not
+// a number is the column header
+bool ScenarioEngineBS::loadPortfolio(const string& fileName) {
+    ifstream in(fileName, ios::binary);
+    if (!in.is_open()) {
+        m_error = "Unable to open " + fileName;
+        return false;
+    }
+    ScenarioPortfolio portfolio;
+    vector<double>* fields[5] = { &portfolio.T, &portfolio.K, &portfolio.S0, &portfolio.sigma, &portfolio.r };
+    string line;
+    long long lineNumber = 0;
+    while (getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || line == "\r") continue;
+        const char* p = line.c_str();
+        double values[5], quantity = 1.0;
+        bool valid = true;
+        for (int f = 0; f < 5 && valid; ++f) {
+            char* end = nullptr;
+            values[f] = strtod(p, &end);
+            valid = end != p && *end == ',';
+            p = end + 1;
+        }
+        char isCall = 0;
+        valid = valid && PortfolioPricerBS::parseType(p, isCall);
+        const char* comma = valid ? strchr(p, ',') : nullptr;
+        if (comma) {
+            char* end = nullptr;
+            quantity = strtod(comma + 1, &end);
+            valid = end != comma + 1;
+        }
+        if (!valid) {
+            if (lineNumber == 1 && PortfolioPricerBS::isHeader(line.c_str())) continue;
+            m_error = "Invalid position at line " + to_string(lineNumber) + ": " + line;
+            return false;
+        }
+        for (int f = 0; f < 5; ++f) fields[f]->push_back(values[f]);
+        portfolio.quantity.push_back(quantity);
+        portfolio.isCall.push_back(isCall);
+    }
+    return setPortfolio(portfolio);
+}
+
+// numSpot spot shocks evenly from spotMin to spotMax and numVol vol shocks from volMin to
+// volMax; a symmetric grid with an odd count has an exact zero in the middle
+ScenarioGrid ScenarioEngineBS::uniformGrid(double spotMin, double spotMax, size_t numSpot, double volMin, double volMax, size_t numVol) {
+    ScenarioGrid grid;
+    for (size_t i = 0; i < numSpot; ++i) grid.spotShocks.push_back(numSpot > 1 ? spotMin + (spotMax - spotMin) * i / (numSpot - 1) : spotMin);
+    for (size_t j = 0; j < numVol; ++j) grid.volShocks.push_back(numVol > 1 ? volMin + (volMax - volMin) * j / (numVol - 1) : volMin);
+    return grid;
+}
+
+// Surfaces of the portfolio under every scenario of the grid, and its P&L against the
+// unshocked value computed the same way
+bool ScenarioEngineBS::run(const ScenarioGrid& grid, ScenarioSurface& surface) {
+    if (grid.spotShocks.empty() || grid.volShocks.empty()) {
+        m_error = "The grid needs at least one spot shock and one vol shock";
+        return false;
+    }
+    for (double shock : grid.spotShocks) {
+        if (!(shock > -1.0) || !isfinite(shock)) {
+            m_error = "Spot shocks must be above -1, the stock price stays positive";
+            return false;
+        }
+    }
+    for (double shock : grid.volShocks) {
+        if (!isfinite(shock)) {
+            m_error = "Vol shocks must be finite";
+            return false;
+        }
+    }
+    auto start = chrono::steady_clock::now();
+    ScenarioGrid unshocked;
+    unshocked.spotShocks.assign(1, 0.0);
+    unshocked.volShocks.assign(1, 0.0);
+    ScenarioSurface base;
+    sumGrid(unshocked, base);
+    sumGrid(grid, surface);
+    surface.baseValue = base.value[0];
+    for (size_t k = 0; k < surface.value.size(); ++k) surface.pnl[k] = surface.value[k] - surface.baseValue;
+    m_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+// Sum every position into the surfaces, blocks of contracts round robin over the threads,
+// each adding into its own surfaces
+void ScenarioEngineBS::sumGrid(const ScenarioGrid& grid, ScenarioSurface& surface) {
+    resizeSurface(surface, grid);
+    size_t numSpot = grid.spotShocks.size(), numScenarios = numSpot * grid.volShocks.size();
+    vector<double> spotTerms(3 * numSpot);
+    for (size_t s = 0; s < numSpot; ++s) {
+        spotTerms[s] = log1p(grid.spotShocks[s]);
+        spotTerms[numSpot + s] = 1.0 + grid.spotShocks[s];
+        spotTerms[2 * numSpot + s] = 1.0 / (1.0 + grid.spotShocks[s]);
+    }
+
+    size_t numBlocks = (m_S0.size() + blockContracts - 1) / blockContracts;
+    size_t threads = m_threads > 0 ? (size_t)m_threads : max(1u, thread::hardware_concurrency());
+    threads = max<size_t>(1, min(threads, numBlocks));
+    vector<ScenarioSurface> partial(threads);
+    auto worker = [&](size_t t) {
+        resizeSurface(partial[t], grid);
+        for (size_t b = t; b < numBlocks; b += threads) {
+            size_t end = min(m_S0.size(), (b + 1) * blockContracts);
+            for (size_t c = b * blockContracts; c < end; ++c) addContract(c, grid, spotTerms, partial[t]);
+        }
+    };
+    vector<future<void>> workers;
+    for (size_t t = 1; t < threads; ++t) workers.push_back(async(launch::async, worker, t));
+    worker(0);
+    for (auto& w : workers) w.get();
+
+    for (const ScenarioSurface& part : partial) {
+        for (size_t k = 0; k < numScenarios; ++k) {
+            surface.value[k] += part.value[k];
+            surface.delta[k] += part.delta[k];
+            surface.gamma[k] += part.gamma[k];
+            surface.vega[k] += part.vega[k];
+            surface.theta[k] += part.theta[k];
+        }
+    }
+}
+
+// Add position c under every scenario, one EurSimdBS scenario row per vol shock with the
+// spot shocks in the lanes. spotTerms holds ln(1 + s), 1 + s and 1 / (1 + s) of the spot
+// shocks.
+void ScenarioEngineBS::addContract(size_t c, const ScenarioGrid& grid, const vector<double>& spotTerms,
+    ScenarioSurface& surface) const {
+    size_t numSpot = grid.spotShocks.size();
+    double sqrtT = m_sqrtT[c], carry = m_logMoneyness[c] + m_drift[c];
+    EurScenarioRow row;
+    row.n = numSpot;
+    row.logShift = spotTerms.data();
+    row.factor = row.logShift + numSpot;
+    row.inverseFactor = row.factor + numSpot;
+    row.S0 = m_S0[c];
+    row.discountedStrike = m_discountedStrike[c];
+    row.r = m_r[c];
+    row.shift = m_isCall[c] ? 0.0 : 1.0;
+    row.weight = m_quantity[c];
+    row.vegaScale = row.weight * row.S0 * sqrtT;
+    for (size_t v = 0; v < grid.volShocks.size(); ++v) {
+        double sigma = max(m_sigma[c] + grid.volShocks[v], minVolatility);
+        row.sd = sigma * sqrtT;
+        row.inverseSd = 1.0 / row.sd;
+        row.a = carry * row.inverseSd + 0.5 * row.sd;
+        row.gammaScale = row.weight * row.inverseSd / row.S0;
+        row.thetaScale = -sigma / (2 * sqrtT);
+        size_t first = v * numSpot;
+        row.value = surface.value.data() + first;
+        row.delta = surface.delta.data() + first;
+        row.gamma = surface.gamma.data() + first;
+        row.vega = surface.vega.data() + first;
+        row.theta = surface.theta.data() + first;
+        EurSimdBS::scenarioRow(row);
+    }
+}
@@ -0,0 +1,114 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	ScenarioEngineBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the ScenarioEngineBS Class, stress grids of a portfolio
+*					of European options: every position repriced under each pair of a
+*					spot shock and a volatility shock, summed into value, P&L and Greek
+*					surfaces of the whole portfolio.
+*
+*					Invariants: ln(S0 / K), sqrt(T), r T and K exp(-r T) of a contract are
+*					            computed once, ln(1 + shock), 1 + shock and its inverse once
+*					            per grid, so a scenario only needs
+*					            d1 = a_v + ln(1 + shock_s) / (sigma_v sqrt(T)).
+*					Scenarios : spot shocks innermost, in the SIMD lanes of the fused
+*					            EurSimdBS::scenarioRow kernel, which computes d1, d2, both
+*					            normal CDFs and the density in registers and adds the
+*					            position straight into the surfaces, branch free for calls
+*					            and puts.
+*					Threads   : contracts in blocks taken round robin, each thread adding
+*					            into its own surfaces, summed at the end; no surface of a
+*					            single contract is ever kept.
+*
+* References	:	- J. C. Hull, Options, Futures and Other Derivatives, 10th ed., ch. 19
+* Other files	:	EurSimdBS.h, PortfolioPricerBS.h
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/****************************************************************************************
+*									STRUCTS DECLARATION									*
+****************************************************************************************/
+
+// Positions of a portfolio, quantity contracts of a European call or put each
+struct ScenarioPortfolio {
+    vector<double> T, K, S0, sigma, r;
+    vector<double> quantity;    // Negative for short positions
+    vector<char> isCall;        // 1 for a call, 0 for a put
+};
+
+// Shocks of a stress grid: the stock price becomes S0 * (1 + spot shock) and the volatility
+// sigma + vol shock, floored at ScenarioEngineBS::minVolatility
+struct ScenarioGrid {
+    vector<double> spotShocks;
+    vector<double> volShocks;
+};
+
+// Portfolio totals under every scenario, element [v * numSpot + s] for volShocks[v] and
+// spotShocks[s]; pnl is value minus baseValue, the value without shocks
+struct ScenarioSurface {
+    size_t numSpot = 0;
+    size_t numVol = 0;
+    double baseValue = 0;
+    vector<double> value, pnl, delta, gamma, vega, theta;
+};
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class ScenarioEngineBS
+{
+    public:
+
+        //constructors
+        ScenarioEngineBS();
+
+        //accessors
+        bool setPortfolio(const ScenarioPortfolio& portfolio);
+        size_t getNumPositions() const;
+        void setThreads(int numThreads);
+        int getThreads();
+        double getSeconds();
+        string getError();
+
+        // Public Member functions
+        bool loadPortfolio(const string& fileName);
+        bool run(const ScenarioGrid& grid, ScenarioSurface& surface);
+        static ScenarioGrid uniformGrid(double spotMin, double spotMax, size_t numSpot, double volMin, double volMax, size_t numVol);
+
+        // Contracts handed to a thread at a time
+        static const size_t blockContracts = 64;
+
+        // Floor of a shocked volatility
+        static const double minVolatility;
+
+    private:
+
+        // private Member functions
+        void addContract(size_t c, const ScenarioGrid& grid, const vector<double>& spotTerms, ScenarioSurface& surface) const;
+        void sumGrid(const ScenarioGrid& grid, ScenarioSurface& surface);
+
+        // private  Member variables
+        vector<double> m_logMoneyness;      // ln(S0 / K)
+        vector<double> m_sqrtT;             // sqrt(T)
+        vector<double> m_drift;             // r T
+        vector<double> m_discountedStrike;  // K exp(-r T)
+        vector<double> m_S0, m_sigma, m_r, m_quantity;
+        vector<char> m_isCall;
+        int m_threads;                      // Threads of run, 0 uses every hardware thread
+        double m_seconds;                   // Wall time of the last run
+        string m_error;                     // Reason of the last failure
+};
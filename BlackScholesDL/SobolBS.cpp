@@ -0,0 +1,114 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	SobolBS.cpp
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Implemenation of member functions for the SobolBS Class
+*
+* References	:	- S. Joe and F. Y. Kuo, new-joe-kuo-6.21201 direction numbers
+*					- P. Bratley and B. L. Fox, Algorithm 659: Implementing Sobol's
+*					  quasirandom sequence generator, ACM TOMS, 1988
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#include "SobolBS.h"
+
+// Bits of a coordinate
+static const int sobolBits = 32;
+
+// Primitive polynomial degree s, coefficients a and initial direction numbers m of the
+// dimensions 2 to maxDimensions, the first dimension is the van der Corput sequence
+struct SobolPolynomial { int s; unsigned a; unsigned m[6]; };
+static const SobolPolynomial sobolPolynomials[SobolBS::maxDimensions - 1] = {
+    { 1, 0, { 1 } }, { 2, 1, { 1, 3 } }, { 3, 1, { 1, 3, 1 } }, { 3, 2, { 1, 1, 1 } },
+    { 4, 1, { 1, 1, 3, 3 } }, { 4, 4, { 1, 3, 5, 13 } }, { 5, 2, { 1, 1, 5, 5, 17 } },
+    { 5, 4, { 1, 1, 5, 5, 5 } }, { 5, 7, { 1, 1, 7, 11, 19 } }, { 5, 11, { 1, 1, 5, 1, 1 } },
+    { 5, 13, { 1, 1, 1, 3, 11 } }, { 5, 14, { 1, 3, 5, 5, 31 } }, { 6, 1, { 1, 3, 3, 9, 7, 49 } },
+    { 6, 13, { 1, 1, 1, 15, 21, 21 } }, { 6, 16, { 1, 3, 1, 13, 27, 49 } } };
+
+/****************************************************************************************
+*									HELPER FUNCTIONS									*
+****************************************************************************************/
+
+// Direction numbers v[d][k], the contribution of bit k of the Gray coded point index
+struct SobolDirections {
+    uint32_t v[SobolBS::maxDimensions][sobolBits];
+
+    SobolDirections() {
+        for (int k = 0; k < sobolBits; ++k) v[0][k] = 1u << (sobolBits - 1 - k);
+        for (int d = 1; d < SobolBS::maxDimensions; ++d) {
+            const SobolPolynomial& p = sobolPolynomials[d - 1];
+            for (int k = 0; k < sobolBits; ++k) {
+                if (k < p.s) {
+                    v[d][k] = p.m[k] << (sobolBits - 1 - k);
+                    continue;
+                }
+                uint32_t value = v[d][k - p.s] ^ (v[d][k - p.s] >> p.s);
+                for (int l = 1; l < p.s; ++l) {
+                    if ((p.a >> (p.s - 1 - l)) & 1u) value ^= v[d][k - l];
+                }
+                v[d][k] = value;
+            }
+        }
+    }
+};
+
+static const SobolDirections& sobolDirections() {
+    static const SobolDirections directions;
+    return directions;
+}
+
+// Position of the lowest set bit of a non zero index
+static int lowestBit(uint64_t n) {
+    int bit = 0;
+    while (!(n & 1)) {
+        n >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+/****************************************************************************************
+*									MEMBER FUNCTIONS									*
+****************************************************************************************/
+
+//Default constructor
+SobolBS::SobolBS() : m_dimensions(maxDimensions), m_index(0), m_point() {}
+
+//Parametrized constructor, dimensions are clamped to [1, maxDimensions]
+SobolBS::SobolBS(int dimensions, uint64_t index) : m_dimensions(dimensions < 1 ? 1 : dimensions > maxDimensions ? maxDimensions : dimensions),
+    m_index(0), m_point() {
+    seek(index);
+}
+
+//accessors
+uint64_t SobolBS::getIndex() const { return m_index; }
+uint32_t SobolBS::coordinate(int dimension) const { return m_point[dimension]; }
+
+// Point number index: the XOR of the direction numbers of the bits of its Gray code
+void SobolBS::seek(uint64_t index) {
+    const SobolDirections& directions = sobolDirections();
+    uint64_t gray = index ^ (index >> 1);
+    m_index = index;
+    for (int d = 0; d < m_dimensions; ++d) {
+        m_point[d] = 0;
+        for (int k = 0; k < sobolBits; ++k) {
+            if ((gray >> k) & 1) m_point[d] ^= directions.v[d][k];
+        }
+    }
+}
+
+// Consecutive Gray codes differ in the lowest set bit of the new index. From maxPoints
+// on that bit has no direction number, the point is left as seek() would compute it.
+void SobolBS::next() {
+    const SobolDirections& directions = sobolDirections();
+    int bit = lowestBit(++m_index);
+    if (bit >= sobolBits) return;
+    for (int d = 0; d < m_dimensions; ++d) m_point[d] ^= directions.v[d][bit];
+}
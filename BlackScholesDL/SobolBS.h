@@ -0,0 +1,69 @@
+/****************************************************************************************
+* Project		:	Basic Numerical C++ Library for Finance
+* File			:	SobolBS.h
+* Lenguaje		:	C++
+* License		:	Apache License Ver 2.0, www.apache.org/licenses/LICENSE-2.0
+* Description	:	Header file for the SobolBS Class, a Sobol low discrepancy sequence in
+*					up to maxDimensions dimensions with 32 bit coordinates, walked in Gray
+*					code order so each next point costs one XOR per dimension.
+*
+*					Seek      : any index can be reached directly, so a thread can start
+*					            a block of points without computing the earlier ones.
+*					Shifts    : XOR with a random 32 bit shift per dimension (a random
+*					            digital shift) randomises the sequence keeping its
+*					            uniformity, as done by uniform().
+*
+* References	:	- I. M. Sobol, On the distribution of points in a cube and the
+*					  approximate evaluation of integrals, USSR Comput. Math., 1967
+*					- S. Joe and F. Y. Kuo, Constructing Sobol sequences with better
+*					  two-dimensional projections, SIAM J. Sci. Comput., 2008
+* Other files	:
+* Git Control	:	https://github.com/camiloblanco/finlib/
+* Author - Year	:	Camilo Blanco Vargas - 2020
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+#pragma once
+#include <cstdint>
+
+/****************************************************************************************
+*									CLASS DECLARATION									*
+****************************************************************************************/
+
+class SobolBS
+{
+    public:
+
+        //constructors
+        SobolBS();
+        SobolBS(int dimensions, uint64_t index);
+
+        //accessors
+        uint64_t getIndex() const;
+        uint32_t coordinate(int dimension) const;
+
+        // Public Member functions
+        void seek(uint64_t index);
+        void next();
+
+        // Coordinate as a double strictly inside (0, 1), after a digital shift
+        double uniform(int dimension, uint32_t shift) const {
+            return ((m_point[dimension] ^ shift) + 0.5) * (1.0 / 4294967296.0);
+        }
+
+        // Dimensions with direction numbers
+        static const int maxDimensions = 16;
+
+        // Points with distinct 32 bit coordinates, indices beyond it have no direction numbers
+        static const uint64_t maxPoints = (uint64_t)1 << 32;
+
+    private:
+
+        // private  Member variables
+        int m_dimensions;                   // Dimensions in use
+        uint64_t m_index;                   // Index of the current point
+        uint32_t m_point[maxDimensions];    // Current point, 32 bit fractions
+};
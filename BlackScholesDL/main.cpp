@@ -25,6 +25,11 @@
 #include "EurOptionBS.h"
 #include "EurCallBS.h"
 #include "EurPutBS.h"
+#include "EurDataSetBS.h"
+#include "CommandLineBS.h"
+#include "PortfolioPricerBS.h"
+#include "ImpliedVolBS.h"
+#include "ProfilerBS.h"
 
 using namespace std;
 
@@ -75,12 +80,10 @@ void priceEurOptionBS() {
 	cin >> r;
 	if (T >= 0 && K >= 0 && S0 >= 0 && sigma >= 0 && r >= 0) {
 
-		// Declare qn optionsPTRvec pointers vector, an EurCallBS, and an EurPutBS Objects
-		vector<EurOptionBS*> optionsPTRvec;
-		EurOptionBS* eurCallPTR = new EurCallBS(T, K);
-		EurOptionBS* eurPutPRT = new EurPutBS(T, K);
-		optionsPTRvec.push_back(eurCallPTR);
-		optionsPTRvec.push_back(eurPutPRT);
+		// Declare an EurCallBS and an EurPutBS Objects, and an optionsPTRvec pointers vector to them
+		EurCallBS eurCall(T, K);
+		EurPutBS eurPut(T, K);
+		vector<EurOptionBS*> optionsPTRvec = { &eurCall, &eurPut };
 
 		//Loop over the vector of options types
 		for (auto& option : optionsPTRvec) {
@@ -93,13 +96,6 @@ void priceEurOptionBS() {
 			cout << "The option Gamma is: " << option->gammaByBSFormula(S0, sigma, r) << endl;
 			cout << "The option Theta is: " << option->thetaByBSFormula(S0, sigma, r) << endl;
 		}
-		
-		//Delete EurOptionBS Objects
-		for (auto pointer : optionsPTRvec)
-		{
-			delete pointer;
-		}
-		optionsPTRvec.clear();
 	}
 	else {
 		cout << "All parameters must be positive. " << endl;
@@ -107,114 +103,141 @@ void priceEurOptionBS() {
 	menuPause();
 }
 
-// Funtion to round up double values
-double roundUp(double num, int places) {
-	int factor = pow(10,places);
-	return (places < 1) ? num : (ceil(num * factor) / (factor));
-}
-
 //Menu for Generating an European Options Datasets using the Black-Scholes model
 void generateEurOptionBS() {
 
 	//Declare Variables
-	vector<EurOptionBS*> optionsPTRvec;
-	const double nMin = 0.00000001;
-	int numSamples=0;
-	double T = 0, K = 0, S0 = 0, sigma = 0, r = 0;
-	double tMax = 2.0, pMax=500.0, sigmaMax=1.0, rMax = 0.1;
+	DataSetParams params;
 	
 	//Display menu and read number of samples for Dataset
 	clearConsole();
 	cout << "****************************************************************************" << endl;
 	cout << "	Generate an European Vanilla Options Dataset using the Black-Scholes model" << endl << endl;
 	cout << "Please enter the number of samples you want to generate (N): " << endl;
-	cin >> numSamples;
+	cin >> params.numSamples;
 	/*Personalize simulation parameters*/
 	cout << endl << "For the next parameters the default minmum is 0.00000001 " << endl;
 	cout << "Please enter the Maximun Time to maturity in years (tMax): " << endl;
-	cin >> tMax;
+	cin >> params.tMax;
 	cout << "Please enter the Maximun Price (pMax for Strike and Stock): " << endl;
-	cin >> pMax;
+	cin >> params.pMax;
 	cout << "Please enter the Maximun Annualized volatility (sigmaMax): " << endl;
-	cin >> sigmaMax;
+	cin >> params.sigmaMax;
 	cout << "Please enter the Maximun Annual risk-free interest rate (rMax): " << endl;
-	cin >> rMax;
+	cin >> params.rMax;
 	/**/
-	// Initialize random engine
-	//Code derived from: https://en.cppreference.com/w/cpp/numeric/random/uniform_real_distribution
-	random_device random_device; // create object for seeding
-	mt19937 mt_engine(random_device()); // create engine and seed it with the previous object
-	uniform_real_distribution<double> dist_time(nMin, tMax);
-	uniform_real_distribution<double> dist_price(nMin, pMax);
-	uniform_real_distribution<double> dist_sigma(nMin, sigmaMax);
-	uniform_real_distribution<double> dist_rate(nMin, rMax);
-
-	// Declare a EurCallBS, and a  EurPutBS Objects and store the in the optionsPTRvec pointers vector
-	EurOptionBS* eurCallPTR = new EurCallBS(T, K);
-	EurOptionBS* eurPutPRT = new EurPutBS(T, K);
-	optionsPTRvec.push_back(eurCallPTR);
-	optionsPTRvec.push_back(eurPutPRT);
-
-	string fileName = "BSdataSet.csv";
-
-	//First Open bsOptionsDataset.csv in new mode and save the header to clean the file
-	ofstream fileStream(fileName);
-
-	if (fileStream.is_open()) {
-		// write the file headers and the simulation parameters:
-		fileStream << "time" << "," << "strike_price" << "," << "stock_price" << "," << "volatility" << "," << "interest_rate" << ",";
-		fileStream << "type_o1" << "," << "price_o1" << "," << "delta_o1" << "," << "gamma_o1" << "," << "theta_o1" << ",";
-		fileStream << "type_o2" << "," << "price_o2" << "," << "delta_o2" << "," << "gamma_o2" << "," << "theta_o12" << endl;
-		fileStream << "numSamples" << "," << "tMax" << "," << "pMax" << "," << "sigmaMax" << "," << "rMax" << endl;
-		fileStream << numSamples << "," << tMax << "," << pMax << "," << sigmaMax << "," << rMax << endl;
-
-		//Loop for each Sample
-		for (int sample = 0; sample < numSamples; ++sample) {
-
-			//Generate Random inputs and store to file
-			T = roundUp(dist_time(mt_engine),6);
-			K = roundUp(dist_price(mt_engine), 2);
-			S0 = roundUp(dist_price(mt_engine), 2);
-			sigma = roundUp(dist_sigma(mt_engine), 4);
-			r = roundUp(dist_rate(mt_engine), 4);
-			//cout<<"Sample: "<<sample<<", T=" << T << ", K=" << K << ", S0=" << S0 << ", sig=" << sigma << ", r=" << r << ", "<<endl;
-			fileStream << T << "," << K << "," << S0 << "," << sigma << "," << r << ",";
-			// Set Output precision to 8 decimals
-			fileStream << fixed << setprecision(8);
-
-			//Loop over the vector of options types
-			for (auto& option : optionsPTRvec) {
-				option->setK(K);
-				option->setT(T);
-				// Price the options, calculate the greeks and save results to file			
-				fileStream << option->getType() << ",";
-				fileStream << option->priceByBSFormula(S0, sigma, r) << ",";
-				fileStream << option->deltaByBSFormula(S0, sigma, r)<< ",";
-				fileStream << option->gammaByBSFormula(S0, sigma, r)<< ",";
-				fileStream << option->thetaByBSFormula(S0, sigma, r) << ",";
-			}
-			// End of the dataser line
-			fileStream << endl;
-		}
+	// A new seed from the random device for every dataset, as before; format, sampling and
+	// space keep their defaults, the command line sets them
+	random_device random_device;
+	params.seed = ((uint64_t)random_device() << 32) | random_device();
+
+	// Generate the dataset using every core, the same seed always gives the same file
+	EurDataSetBS generator(params);
+	ProfilerBS::reset();
+	if (generator.generate()) {
+		cout << endl << "Generated " << params.numSamples << " samples into " << params.fileName << " with seed " << params.seed << endl;
+		cout << "Threads: " << generator.getThreadsUsed() << ", seconds: " << generator.getSeconds();
+		cout << ", rows/sec: " << (long long)generator.getRowsPerSecond() << endl;
+		// Stage timings of a BSDL_PROFILE build
+		if (ProfilerBS::isEnabled()) ProfilerBS::report(cout, generator.getSeconds(), false);
 	}
-	fileStream.close();
+	else {
+		cout << "Unable to write the file " << params.fileName << ": " << generator.getError() << endl;
+	}
+	menuPause();
+}
+
+//Menu for measuring how the dataset generator scales with the number of threads
+void benchmarkEurOptionBS() {
+
+	//Declare Variables
+	DataSetParams params;
+	params.seed = 1;
 
-	//Delete EurOptionBS Objects
-	for (auto pointer: optionsPTRvec)
-	{
-		delete pointer;
+	clearConsole();
+	cout << "****************************************************************************" << endl;
+	cout << "	Measure the dataset generator scaling from 1 to N threads" << endl << endl;
+	cout << "Please enter the number of samples per run (N): " << endl;
+	cin >> params.numSamples;
+	cout << endl;
+	EurDataSetBS::scalingReport(params, cout);
+	menuPause();
+}
+
+//Menu for repricing a portfolio file of European options
+void repriceEurOptionBS() {
+
+	//Declare Variables
+	string inputFile, outputFile;
+
+	clearConsole();
+	cout << "****************************************************************************" << endl;
+	cout << "	Reprice a portfolio file of European options using the Black-Scholes model" << endl << endl;
+	cout << "Please enter the portfolio file (CSV T,K,S0,sigma,r,type or .bsdl): " << endl;
+	cin >> inputFile;
+	cout << "Please enter the results file (CSV or .bsdl): " << endl;
+	cin >> outputFile;
+
+	PortfolioPricerBS pricer;
+	if (pricer.reprice(inputFile, outputFile)) {
+		cout << endl << "Repriced " << pricer.getPositions() << " positions into " << outputFile << endl;
+		cout << "Seconds: " << pricer.getSeconds() << ", positions/sec: " << (long long)pricer.getPositionsPerSecond() << endl;
+	}
+	else {
+		cout << pricer.getError() << endl;
 	}
-	optionsPTRvec.clear();
 	menuPause();
 }
 
 
+//Menu for the implied volatility of a quoted option price
+void impliedVolEurOptionBS() {
+	//Declare Variables
+	double price = 0, T = 0, K = 0, S0 = 0, r = 0;
+	string type;
+	clearConsole();
+	cout << "****************************************************************************" << endl;
+	cout << "	Implied volatility of an european option using the Black-Scholes model" << endl << endl;
+	cout << "Please enter the option type (call or put): " << endl;
+	cin >> type;
+	cout << "Please enter the quoted option price: " << endl;
+	cin >> price;
+	cout << "Please enter the Time to maturity in years (T): " << endl;
+	cin >> T;
+	cout << "Please enter the Strike (Exercise) Price (K): " << endl;
+	cin >> K;
+	cout << "Please enter the Initial Stock Price (S0): " << endl;
+	cin >> S0;
+	cout << "Please enter the Annual risk-free interest rate (r): " << endl;
+	cin >> r;
+
+	ImpliedVolBS solver;
+	ImpliedVolResult result = solver.solve(price, T, K, S0, r, type != "put");
+	if (result.status == IMPLIED_OK) {
+		cout << endl << "The implied volatility is: " << result.sigma << endl;
+		cout << "Iterations: " << result.iterations << endl;
+	}
+	else if (result.status == IMPLIED_BELOW_INTRINSIC || result.status == IMPLIED_ABOVE_MAXIMUM) {
+		cout << endl << "The price is outside the no arbitrage bounds, there is no implied volatility" << endl;
+	}
+	else {
+		cout << endl << "Unable to find the implied volatility, please verify the inputs" << endl;
+	}
+	menuPause();
+}
+
 /****************************************************************************************
 *											 MAIN										*
 ****************************************************************************************/
 
-int main()
+int main(int argc, char* argv[])
 {
+	// Any argument selects the non interactive command line mode
+	if (argc > 1) {
+		CommandLineBS commandLine(argc, argv);
+		return commandLine.run();
+	}
+
 	int option = 9;
 
 	while (option != 0) {
@@ -224,6 +247,9 @@ int main()
 		cout << "Select an option by entering the given number:" << endl << endl;
 		cout << "1. Price an european option using the Black-Scholes formula" << endl;
 		cout << "2. Generate an European options dataset using the Black-Scholes formula" << endl;
+		cout << "3. Measure the dataset generator scaling over threads" << endl;
+		cout << "4. Reprice a portfolio file of European options" << endl;
+		cout << "5. Compute the implied volatility of a quoted option price" << endl;
 		cout << "0. To exit the program" << endl;
 		cout << "****************************************************************************" << endl;
 		cout << endl << "Please enter the option number:" << endl;
@@ -234,6 +260,15 @@ int main()
 		else if (option == 2) {
 			generateEurOptionBS();
 		}
+		else if (option == 3) {
+			benchmarkEurOptionBS();
+		}
+		else if (option == 4) {
+			repriceEurOptionBS();
+		}
+		else if (option == 5) {
+			impliedVolEurOptionBS();
+		}
 		else if (option == 0) {
 			cout << endl << "Thank you for using this program, have a nice day. " << endl << endl;
 		}
@@ -0,0 +1,528 @@
+/****************************************************************************************
+* Project		:	Machine Learning and modern numerical techniques for high-dimensional
+*					option pricing - Financial Computing MSc. Dissertation QMUL 2019/2020
+* License		:	MIT License, https://opensource.org/licenses/MIT
+* Copyright (c) :	2020 Camilo Blanco
+* Mail - Web	:	mail@camiloblanco.com - www.camiloblanco.com
+* Lenguaje / Env:	C++ / Microsoft Visual Studio Community 2019
+* Git Control	:	https://github.com/camiloblanco/BlackScholesDL
+* Description	:	main CPP file for the program BlackScholesTests, regression tests of the
+*					BlackScholesDL library run by ctest. Each test is selected by name and
+*					returns 0 when it passes, 1 with the first mismatches on stderr.
+*
+****************************************************************************************/
+
+/****************************************************************************************
+*								#INCLUDES AND #CONSTANTS								*
+****************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ColumnarReaderBS.h"
+#include "ColumnarWriterBS.h"
+#include "CsvFormatBS.h"
+#include "EurBatchBS.h"
+#include "EurCallBS.h"
+#include "EurGreeksBS.h"
+#include "EurKernelBS.h"
+#include "EurPutBS.h"
+#include "EurSimdBS.h"
+#include "FiniteDifferenceBS.h"
+#include "ImpliedVolBS.h"
+#include "MonteCarloBS.h"
+#include "NormalCDFBS.h"
+#include "PriceGridBS.h"
+#include "SobolBS.h"
+
+using namespace std;
+
+// Mismatches printed before a test gives up
+static const int maxReported = 10;
+
+// Contracts of the random books, over the default ranges of the generator
+static const size_t bookSize = 100000;
+
+/****************************************************************************************
+*										FUNCTIONS									*
+****************************************************************************************/
+
+// A book of random contracts, the same for a given seed
+struct TestBook {
+	vector<double> T, K, S0, sigma, r;
+	EurBSBatchInput input() const { return { T.size(), T.data(), K.data(), S0.data(), sigma.data(), r.data() }; }
+};
+
+TestBook randomBook(size_t n, unsigned seed) {
+	mt19937_64 random(seed);
+	uniform_real_distribution<double> t(0.01, 2.0), price(1.0, 500.0), vol(0.01, 1.0), rate(0.0, 0.1);
+	TestBook book;
+	for (size_t i = 0; i < n; ++i) {
+		book.T.push_back(t(random));
+		book.K.push_back(price(random));
+		book.S0.push_back(price(random));
+		book.sigma.push_back(vol(random));
+		book.r.push_back(rate(random));
+	}
+	return book;
+}
+
+// Counts a mismatch of a value against its reference, printing the first ones
+bool expectNear(const char* what, size_t i, double value, double reference, double tolerance, int& failures) {
+	bool same = tolerance == 0.0 ? value == reference : fabs(value - reference) <= tolerance;
+	if (!same && failures++ < maxReported) {
+		cerr.precision(17);
+		cerr << what << " of contract " << i << ": " << value << ", expected " << reference << endl;
+	}
+	return same;
+}
+
+// EurBatchBS::priceCalls and pricePuts are bit for bit the EurCallBS and EurPutBS values
+bool testBatchScalar() {
+	TestBook book = randomBook(bookSize, 1);
+	size_t n = book.T.size();
+	vector<double> price(n), delta(n), gamma(n), theta(n);
+	int failures = 0;
+	for (int call = 1; call >= 0; --call) {
+		EurBSBatchOutput out = { price.data(), delta.data(), gamma.data(), theta.data() };
+		if (call) EurBatchBS::priceCalls(book.input(), out); else EurBatchBS::pricePuts(book.input(), out);
+		for (size_t i = 0; i < n; ++i) {
+			EurCallBS callOption(book.T[i], book.K[i]);
+			EurPutBS putOption(book.T[i], book.K[i]);
+			EurOptionBS& option = call ? (EurOptionBS&)callOption : (EurOptionBS&)putOption;
+			expectNear("price", i, price[i], option.priceByBSFormula(book.S0[i], book.sigma[i], book.r[i]), 0.0, failures);
+			expectNear("delta", i, delta[i], option.deltaByBSFormula(book.S0[i], book.sigma[i], book.r[i]), 0.0, failures);
+			expectNear("gamma", i, gamma[i], option.gammaByBSFormula(book.S0[i], book.sigma[i], book.r[i]), 0.0, failures);
+			expectNear("theta", i, theta[i], option.thetaByBSFormula(book.S0[i], book.sigma[i], book.r[i]), 0.0, failures);
+		}
+	}
+	return failures == 0;
+}
+
+// EurBatchBS::evaluateBatch gives both legs of each contract bit for bit as the scalar classes
+bool testFusedScalar() {
+	TestBook book = randomBook(bookSize, 2);
+	size_t n = book.T.size();
+	vector<double> callPrice(n), callDelta(n), callGamma(n), callTheta(n), putPrice(n), putDelta(n), putGamma(n), putTheta(n);
+	EurBSBatchOutput call = { callPrice.data(), callDelta.data(), callGamma.data(), callTheta.data() };
+	EurBSBatchOutput put = { putPrice.data(), putDelta.data(), putGamma.data(), putTheta.data() };
+	EurBatchBS::evaluateBatch(book.input(), call, put);
+	int failures = 0;
+	for (size_t i = 0; i < n; ++i) {
+		EurCallBS callOption(book.T[i], book.K[i]);
+		EurPutBS putOption(book.T[i], book.K[i]);
+		double S0 = book.S0[i], sigma = book.sigma[i], r = book.r[i];
+		expectNear("call price", i, callPrice[i], callOption.priceByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("call delta", i, callDelta[i], callOption.deltaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("call gamma", i, callGamma[i], callOption.gammaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("call theta", i, callTheta[i], callOption.thetaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("put price", i, putPrice[i], putOption.priceByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("put delta", i, putDelta[i], putOption.deltaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("put gamma", i, putGamma[i], putOption.gammaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("put theta", i, putTheta[i], putOption.thetaByBSFormula(S0, sigma, r), 0.0, failures);
+	}
+	return failures == 0;
+}
+
+// Every SIMD level the machine supports against the scalar fused evaluator, within 1e-12
+// relative to the value (1e-12 absolute below 1), and the element-wise CDF and density
+bool testSimdScalar() {
+	TestBook book = randomBook(bookSize, 3);
+	size_t n = book.T.size();
+	vector<vector<double>> expected(8, vector<double>(n)), actual(8, vector<double>(n));
+	EurBatchBS::evaluateBatch(book.input(), { expected[0].data(), expected[1].data(), expected[2].data(), expected[3].data() },
+		{ expected[4].data(), expected[5].data(), expected[6].data(), expected[7].data() });
+	const char* names[8] = { "call price", "call delta", "call gamma", "call theta", "put price", "put delta", "put gamma", "put theta" };
+
+	vector<double> x(n), cdf(n), pdf(n);
+	for (size_t i = 0; i < n; ++i) x[i] = -12.0 + 24.0 * (double)i / (double)n;
+
+	int failures = 0;
+	SimdLevel best = EurSimdBS::detectLevel();
+	for (int level = SIMD_SCALAR; level <= best; ++level) {
+		if (EurSimdBS::setLevel((SimdLevel)level) != (SimdLevel)level) continue;
+		EurSimdBS::evaluateBatch(book.input(), { actual[0].data(), actual[1].data(), actual[2].data(), actual[3].data() },
+			{ actual[4].data(), actual[5].data(), actual[6].data(), actual[7].data() });
+		EurSimdBS::normalCDF(n, x.data(), cdf.data());
+		EurSimdBS::normalPDF(n, x.data(), pdf.data());
+		for (size_t i = 0; i < n; ++i) {
+			for (int v = 0; v < 8; ++v) {
+				double reference = expected[v][i];
+				expectNear(names[v], i, actual[v][i], reference, 1e-12 * max(1.0, fabs(reference)), failures);
+			}
+			expectNear("normalCDF", i, cdf[i], CdfAbramowitzStegunBS::cdf(x[i]), 1e-14, failures);
+			expectNear("normalPDF", i, pdf[i], EurOptionBS::normalPDF(x[i]), 1e-14, failures);
+		}
+		if (failures > 0) cerr << "at SIMD level " << EurSimdBS::getLevelName() << endl;
+	}
+	EurSimdBS::setLevel(best);
+	return failures == 0;
+}
+
+// Write the first size bytes of a columnar file image
+static void writeVariant(const string& fileName, const vector<char>& bytes, size_t size) {
+	ofstream out(fileName, ios::binary | ios::trunc);
+	out.write(bytes.data(), (streamsize)size);
+}
+
+// Truncated and malformed columnar files are refused by ColumnarReaderBS::open
+bool testColumnarMalformed() {
+	const string good = "columnar-good.bsdl", bad = "columnar-bad.bsdl";
+	const uint64_t numRows = 1000;
+	vector<double> a(numRows, 1.0), b(numRows, 2.0);
+	const double* columns[2] = { a.data(), b.data() };
+	ColumnarWriterBS writer;
+	if (!writer.open(good, { "a", "b" }, numRows, 8, ColumnarHeader()) || !writer.writeRows(0, numRows, columns)
+		|| !writer.close()) {
+		cerr << "Unable to write " << good << endl;
+		return false;
+	}
+	ifstream in(good, ios::binary);
+	vector<char> bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	ColumnarReaderBS reader;
+	if (!reader.open(good) || reader.getNumRows() != numRows || reader.value(1, numRows - 1) != 2.0) {
+		cerr << "A valid file was refused" << endl;
+		return false;
+	}
+	reader.close();
+
+	ColumnarHeader header;
+	memcpy(&header, bytes.data(), sizeof(header));
+	ColumnarEntry entry;
+	memcpy(&entry, bytes.data() + sizeof(header), sizeof(entry));
+	struct Variant { const char* name; size_t size; size_t patchAt; uint64_t patch; };
+	const Variant variants[] = {
+		{ "empty", 0, 0, 0 },
+		{ "inside the header", 100, 0, 0 },
+		{ "header only", (size_t)columnarDataOffset, 0, 0 },
+		{ "last column cut", bytes.size() - 8, 0, 0 },
+		{ "bad magic", bytes.size(), 0, 0x5858585858585858ULL },
+		{ "rows past the end", bytes.size(), offsetof(ColumnarHeader, numRows), numRows + 1 },
+		{ "overflowing rows", bytes.size(), offsetof(ColumnarHeader, numRows), 1ULL << 61 },
+		{ "column inside the header", bytes.size(), sizeof(header) + offsetof(ColumnarEntry, offset), 0 },
+		{ "unaligned column", bytes.size(), sizeof(header) + offsetof(ColumnarEntry, offset), entry.offset + 8 },
+		{ "too many columns", bytes.size(), offsetof(ColumnarHeader, numColumns), 0xFFFFFFFFULL },
+	};
+	int failures = 0;
+	for (const Variant& variant : variants) {
+		vector<char> copy = bytes;
+		bool patchNumColumns = variant.patchAt == offsetof(ColumnarHeader, numColumns);
+		if (variant.patch || variant.patchAt) {
+			memcpy(copy.data() + variant.patchAt, &variant.patch, patchNumColumns ? sizeof(uint32_t) : sizeof(uint64_t));
+		}
+		writeVariant(bad, copy, variant.size);
+		if (reader.open(bad)) {
+			cerr << "Accepted a malformed file: " << variant.name << endl;
+			reader.close();
+			++failures;
+		}
+	}
+	remove(good.c_str());
+	remove(bad.c_str());
+	return failures == 0;
+}
+
+// Prices of the closed form solved back to their volatility, one by one and in a batch
+bool testImpliedRoundTrip() {
+	ImpliedVolBS solver;
+	vector<double> price, T, K, S0, r, sigma;
+	vector<char> isCall;
+	for (double t : { 0.05, 0.5, 1.0, 3.0 }) {
+		for (double k : { 70.0, 90.0, 100.0, 110.0, 140.0 }) {
+			for (double vol : { 0.05, 0.2, 0.5, 1.0 }) {
+				for (int call = 0; call < 2; ++call) {
+					double rate = 0.03, value = call ? EurCallBS(t, k).priceByBSFormula(100.0, vol, rate)
+						: EurPutBS(t, k).priceByBSFormula(100.0, vol, rate);
+					double intrinsic = call ? 100.0 - k * exp(-rate * t) : k * exp(-rate * t) - 100.0;
+					// Quotes with no time value left carry no volatility information
+					if (value - max(0.0, intrinsic) < 1e-4) continue;
+					price.push_back(value); T.push_back(t); K.push_back(k); S0.push_back(100.0); r.push_back(rate);
+					sigma.push_back(vol); isCall.push_back((char)call);
+				}
+			}
+		}
+	}
+
+	size_t n = price.size();
+	vector<double> batchSigma(n);
+	vector<int> batchStatus(n);
+	ImpliedVolBatchInput in = { n, price.data(), T.data(), K.data(), S0.data(), r.data(), isCall.data() };
+	ImpliedVolBatchOutput out = { batchSigma.data(), nullptr, batchStatus.data() };
+	solver.solveBatch(in, out);
+
+	int failures = 0;
+	for (size_t i = 0; i < n && failures < maxReported; ++i) {
+		ImpliedVolResult single = solver.solve(price[i], T[i], K[i], S0[i], r[i], isCall[i] != 0);
+		if (single.status != IMPLIED_OK || fabs(single.sigma - sigma[i]) > 1e-6
+			|| batchStatus[i] != IMPLIED_OK || fabs(batchSigma[i] - sigma[i]) > 1e-6) {
+			cerr << (isCall[i] ? "call" : "put") << " T " << T[i] << " K " << K[i] << " sigma " << sigma[i]
+				<< ": solve " << single.sigma << " (status " << single.status << "), batch " << batchSigma[i]
+				<< " (status " << batchStatus[i] << ")" << endl;
+			++failures;
+		}
+	}
+	return failures == 0 && n > 100;
+}
+
+// Grids grown to a tolerance price the quotes they hold within it, per unit strike
+bool testGridTolerance() {
+	const double tolerance = 1e-5;
+	TestBook book = randomBook(bookSize, 10);
+	int failures = 0;
+	for (PriceGridMethod method : { GRID_LINEAR, GRID_CUBIC }) {
+		PriceGridSpec spec;
+		spec.method = method;
+		spec.numMoneyness = 33;
+		spec.numVolatility = 17;
+		PriceGridBS grid;
+		if (!grid.buildToTolerance(spec, tolerance, (size_t)1 << 24) || !(grid.getError().price <= tolerance)) {
+			cerr << "grid " << method << " stopped at error " << grid.getError().price << endl;
+			return false;
+		}
+		size_t inGrid = 0;
+		for (size_t i = 0; i < bookSize; ++i) {
+			EurBSRecord rec;
+			if (!grid.lookup(book.T[i], book.K[i], book.S0[i], book.sigma[i], book.r[i], rec)) continue;
+			++inGrid;
+			EurBSRecord exact = EurBatchBS::evaluate(book.T[i], book.K[i], book.S0[i], book.sigma[i], book.r[i]);
+			expectNear("grid call price / K", i, rec.callPrice / book.K[i], exact.callPrice / book.K[i], tolerance, failures);
+			expectNear("grid put price / K", i, rec.putPrice / book.K[i], exact.putPrice / book.K[i], tolerance, failures);
+		}
+		if (inGrid < bookSize / 10) {
+			cerr << "grid " << method << " held only " << inGrid << " quotes" << endl;
+			return false;
+		}
+	}
+	return failures == 0;
+}
+
+// One payoff of EurKernelBS, contract by contract and in a batch, against its scalar class
+template <EurPayoff Payoff, class Option>
+void checkKernel(const TestBook& book, int& failures) {
+	size_t n = book.T.size();
+	vector<double> price(n), delta(n), gamma(n), theta(n);
+	EurKernelBS<Payoff, GREEK_BATCH>::evaluateBatch(book.input(), { price.data(), delta.data(), gamma.data(), theta.data() });
+	for (size_t i = 0; i < n; ++i) {
+		Option option(book.T[i], book.K[i]);
+		double S0 = book.S0[i], sigma = book.sigma[i], r = book.r[i];
+		EurKernelResult res = EurKernelBS<Payoff>::evaluate(book.T[i], book.K[i], S0, sigma, r);
+		expectNear("kernel price", i, res.price, option.priceByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("kernel delta", i, res.delta, option.deltaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("kernel gamma", i, res.gamma, option.gammaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("kernel theta", i, res.theta, option.thetaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("kernel vega", i, res.vega, option.vegaByBSFormula(S0, sigma, r), 0.0, failures);
+		expectNear("kernel batch price", i, price[i], res.price, 0.0, failures);
+		expectNear("kernel batch delta", i, delta[i], res.delta, 0.0, failures);
+		expectNear("kernel batch gamma", i, gamma[i], res.gamma, 0.0, failures);
+		expectNear("kernel batch theta", i, theta[i], res.theta, 0.0, failures);
+	}
+}
+
+// EurKernelBS gives bit for bit the EurCallBS and EurPutBS values and Greeks
+bool testKernelScalar() {
+	TestBook book = randomBook(bookSize, 11);
+	int failures = 0;
+	checkKernel<PAYOFF_CALL, EurCallBS>(book, failures);
+	checkKernel<PAYOFF_PUT, EurPutBS>(book, failures);
+	return failures == 0;
+}
+
+// The differentiated Greeks of one leg against the closed form to rounding and against
+// bumping to 2e-3, relative to the value (absolute below 1). Vanna, volga and charm are
+// left out, bumping them crosses the kink of the approximation in N''(x).
+void checkGreeks(size_t i, const EurGreeksRecord& ad, const EurGreeksRecord& bump, EurOptionBS& option,
+	double S0, double sigma, double r, int& failures) {
+	auto near = [&](const char* what, double value, double reference, double tolerance) {
+		expectNear(what, i, value, reference, tolerance * max(1.0, fabs(reference)), failures);
+	};
+	near("AD price", ad.price, option.priceByBSFormula(S0, sigma, r), 1e-12);
+	near("AD delta", ad.delta, option.deltaByBSFormula(S0, sigma, r), 1e-12);
+	near("AD gamma", ad.gamma, option.gammaByBSFormula(S0, sigma, r), 1e-12);
+	near("AD theta", ad.theta, option.thetaByBSFormula(S0, sigma, r), 1e-12);
+	near("AD vega", ad.vega, option.vegaByBSFormula(S0, sigma, r), 1e-12);
+	near("bumped price", bump.price, ad.price, 2e-3);
+	near("bumped delta", bump.delta, ad.delta, 2e-3);
+	near("bumped gamma", bump.gamma, ad.gamma, 2e-3);
+	near("bumped vega", bump.vega, ad.vega, 2e-3);
+	near("bumped rho", bump.rho, ad.rho, 2e-3);
+	near("bumped theta", bump.theta, ad.theta, 2e-3);
+}
+
+// EurGreeksBS by automatic differentiation against the closed form and bump and reprice
+bool testGreeksAD() {
+	TestBook book = randomBook(bookSize, 12);
+	int failures = 0;
+	for (size_t i = 0; i < bookSize; ++i) {
+		double T = book.T[i], K = book.K[i], S0 = book.S0[i], sigma = book.sigma[i], r = book.r[i];
+		EurGreeksRecord call, put, bumpCall, bumpPut;
+		EurGreeksBS::evaluate(T, K, S0, sigma, r, call, put);
+		EurGreeksBS::bumpAndReprice(T, K, S0, sigma, r, bumpCall, bumpPut);
+		EurCallBS callOption(T, K);
+		EurPutBS putOption(T, K);
+		checkGreeks(i, call, bumpCall, callOption, S0, sigma, r, failures);
+		checkGreeks(i, put, bumpPut, putOption, S0, sigma, r, failures);
+	}
+	return failures == 0;
+}
+
+// Simulated prices within four standard errors of the closed form, for every sampler
+bool testMonteCarloClosedForm() {
+	MonteCarloOption option;
+	EurBSRecord rec = EurBatchBS::evaluate(option.T, option.K, option.S0, option.sigma, option.r);
+	int failures = 0;
+	for (int variant = 0; variant < 3; ++variant) {
+		MonteCarloParams params;
+		params.numPaths = 1 << 18;
+		params.numSteps = 4;
+		params.antithetic = params.controlVariate = variant == 1;
+		params.sampler = variant == 2 ? MC_SOBOL : MC_PSEUDO;
+		for (int call = 0; call < 2; ++call) {
+			option.isCall = call != 0;
+			MonteCarloBS engine(params);
+			MonteCarloResult result;
+			if (!engine.price(option, result)) {
+				cerr << "variant " << variant << ": " << engine.getError() << endl;
+				return false;
+			}
+			double closedForm = call ? rec.callPrice : rec.putPrice;
+			expectNear(call ? "simulated call" : "simulated put", (size_t)variant, result.price, closedForm,
+				4.0 * result.stdError, failures);
+			if (!(result.stdError > 0 && result.stdError < 0.05)) {
+				cerr << "variant " << variant << " standard error " << result.stdError << endl;
+				++failures;
+			}
+		}
+	}
+	return failures == 0;
+}
+
+// European prices of the Crank-Nicolson grid: the at the money contract of the README within
+// 2.5e-3 of the closed form on the default grid, and every error at least 3 times smaller
+// on a grid twice as fine
+bool testPdeEuropean() {
+	FiniteDifferenceSpec fine;
+	fine.numSpace *= 2;
+	fine.numTime *= 2;
+	FiniteDifferenceBS coarseSolver, fineSolver(fine);
+	int failures = 0;
+	size_t i = 0;
+	for (double T : { 0.25, 1.0, 2.0 }) {
+		for (double K : { 80.0, 100.0, 120.0 }) {
+			for (double sigma : { 0.2, 0.4 }) {
+				for (int call = 0; call < 2; ++call, ++i) {
+					FiniteDifferenceResult coarse, refined;
+					if (!coarseSolver.price(T, K, 100.0, sigma, 0.05, call != 0, coarse)
+						|| !fineSolver.price(T, K, 100.0, sigma, 0.05, call != 0, refined)) {
+						cerr << "contract " << i << " refused" << endl;
+						return false;
+					}
+					EurBSRecord rec = EurBatchBS::evaluate(T, K, 100.0, sigma, 0.05);
+					double closedForm = call ? rec.callPrice : rec.putPrice;
+					double coarseError = fabs(coarse.price - closedForm);
+					if (T == 1.0 && K == 100.0 && sigma == 0.2) {
+						expectNear("grid price", i, coarse.price, closedForm, 2.5e-3, failures);
+					}
+					expectNear("refined grid error", i, fabs(refined.price - closedForm), 0.0, coarseError / 3.0, failures);
+				}
+			}
+		}
+	}
+	return failures == 0;
+}
+
+// Sobol points walked by next() across the last indices with direction numbers are the
+// points seek() computes, up to SobolBS::maxPoints where the coordinates stop changing
+bool testSobolBoundary() {
+	SobolBS walked(SobolBS::maxDimensions, SobolBS::maxPoints - 4);
+	int failures = 0;
+	for (uint64_t index = SobolBS::maxPoints - 4; index <= SobolBS::maxPoints + 4; ++index, walked.next()) {
+		SobolBS sought(SobolBS::maxDimensions, index);
+		for (int d = 0; d < SobolBS::maxDimensions; ++d) {
+			expectNear("walked coordinate", (size_t)index, walked.coordinate(d), sought.coordinate(d), 0.0, failures);
+		}
+	}
+	SobolBS last(1, SobolBS::maxPoints - 1), first(1, 0);
+	if (last.coordinate(0) == first.coordinate(0)) {
+		cerr << "point " << SobolBS::maxPoints - 1 << " repeats point 0" << endl;
+		++failures;
+	}
+	return failures == 0;
+}
+
+// writeFixed against snprintf("%.*f") on random values of every magnitude and on exact ties
+bool testCsvFixed() {
+	mt19937_64 random(12345);
+	uniform_real_distribution<double> mantissa(-1.0, 1.0);
+	uniform_int_distribution<int> exponent(-12, 14), precision(0, CsvFormatBS::maxPrecision);
+	vector<double> values = { 0.0, -0.0, 0.5, 1.5, 2.5, -2.5, 0.125, 0.375, -0.625, 1e10, 1e10 + 0.5,
+		-1e15, 123456789.125, 0.0049999999999999999, 9.9999999995, 1e-300 };
+	size_t numFixed = values.size();
+	for (int i = 0; i < 200000; ++i) values.push_back(mantissa(random) * pow(10.0, exponent(random)));
+	// Halves at the last printed decimal that are exact in binary, rounded to even by printf
+	for (int i = 0; i < 20000; ++i) values.push_back((double)(random() % 2000001 - 1000000) / 1024.0);
+
+	int failures = 0;
+	char expected[CsvFormatBS::maxFixedChars + 8], actual[CsvFormatBS::maxFixedChars + 8];
+	for (size_t i = 0; i < values.size() && failures < maxReported; ++i) {
+		// The listed values at every precision, the random ones at one
+		int digits = precision(random);
+		for (int p = i < numFixed ? 0 : digits; p <= (i < numFixed ? CsvFormatBS::maxPrecision : digits); ++p) {
+			snprintf(expected, sizeof(expected), "%.*f", p, values[i]);
+			char* end = CsvFormatBS::writeFixed(actual, values[i], p);
+			if (string(actual, end) != expected) {
+				cerr << "writeFixed(" << values[i] << ", " << p << ") = " << string(actual, end)
+					<< ", snprintf = " << expected << endl;
+				++failures;
+			}
+		}
+	}
+	return failures == 0;
+}
+
+/****************************************************************************************
+*											MAIN									*
+****************************************************************************************/
+
+int main(int argc, char* argv[])
+{
+	struct Test { const char* name; bool (*run)(); };
+	const Test tests[] = {
+		{ "batch.scalar", testBatchScalar },
+		{ "fused.scalar", testFusedScalar },
+		{ "simd.scalar", testSimdScalar },
+		{ "columnar.malformed", testColumnarMalformed },
+		{ "implied.roundtrip", testImpliedRoundTrip },
+		{ "grid.tolerance", testGridTolerance },
+		{ "kernel.scalar", testKernelScalar },
+		{ "greeks.ad", testGreeksAD },
+		{ "montecarlo.closedform", testMonteCarloClosedForm },
+		{ "pde.european", testPdeEuropean },
+		{ "sobol.boundary", testSobolBoundary },
+		{ "csv.fixed", testCsvFixed },
+	};
+	string selected = argc > 1 ? argv[1] : "";
+	bool found = false, passed = true;
+	for (const Test& test : tests) {
+		if (!selected.empty() && selected != test.name) continue;
+		found = true;
+		bool ok = test.run();
+		cout << test.name << (ok ? " passed" : " FAILED") << endl;
+		passed = passed && ok;
+	}
+	if (!found) {
+		cerr << "Usage: BlackScholesTests [test], tests:";
+		for (const Test& test : tests) cerr << " " << test.name;
+		cerr << endl;
+		return 2;
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+"""Speedup of BlackScholesBench runs over a baseline run.
+
+    compare_profiles.py baseline.json lto.json native.json pgo.json
+
+Each argument is a --json file of BlackScholesBench; the first one is the baseline. Prints
+the baseline ns per item of every benchmark in all the files and the speedup of each other
+run (baseline time / run time), then the geometric mean speedup of each run.
+"""
+
+import json
+import math
+import os
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    label = data.get("context", {}).get("build_profile") or os.path.splitext(os.path.basename(path))[0]
+    times = {}
+    for bench in data.get("benchmarks", []):
+        # ns per item when the benchmark counts items, otherwise ns per iteration
+        times[bench["name"]] = bench.get("ns_per_item", bench["real_time"])
+    return label, times
+
+
+def main(paths):
+    if len(paths) < 2:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    runs = [load(path) for path in paths]
+    base_label, base = runs[0]
+    names = [name for name in base if all(name in times for _, times in runs[1:])]
+    if not names:
+        print("No benchmark is in every file", file=sys.stderr)
+        return 1
+
+    width = max(len(name) for name in names + ["geometric mean"])
+    header = "%-*s  %12s" % (width, "benchmark", base_label + " ns")
+    header += "".join("  %10s" % label for label, _ in runs[1:])
+    print(header)
+    print("-" * len(header))
+    logs = [0.0] * (len(runs) - 1)
+    for name in names:
+        line = "%-*s  %12.3f" % (width, name, base[name])
+        for i, (_, times) in enumerate(runs[1:]):
+            speedup = base[name] / times[name]
+            logs[i] += math.log(speedup)
+            line += "  %9.2fx" % speedup
+        print(line)
+    print("-" * len(header))
+    print("%-*s  %12s" % (width, "geometric mean", "") + "".join("  %9.2fx" % math.exp(s / len(names)) for s in logs))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Build every optimization profile of CMakeLists.txt, time the generator and pricer
+# benchmarks with each and print the speedup over the baseline profile.
+#   tools/profile_speedup.sh [build root, default _profiles]
+#   FILTER=regex MIN_TIME=0.5 JOBS=8 tools/profile_speedup.sh
+# The PGO profile is built instrumented, trained with the pgo-train target and rebuilt
+# with the recorded profiles in the same directory. Results: <root>/<profile>.json
+
+set -e
+SOURCE_DIR=$(cd "$(dirname "$0")/.." && pwd)
+ROOT=${1:-_profiles}
+FILTER=${FILTER:-'^(Kernel/all|Batch/evaluateBatch|Simd/[a-z0-9]+/evaluateBatch|Greeks/ad/evaluateBatch|ImpliedVol/solveBatch|Scenario/engine|Csv/writeFixed)/4096(/1)?$|^DataSet/(csv|bin64)/262144/1$'}
+MIN_TIME=${MIN_TIME:-0.5}
+JOBS=${JOBS:-$(nproc 2>/dev/null || echo 4)}
+mkdir -p "$ROOT"
+ROOT=$(cd "$ROOT" && pwd)
+
+configure() {
+    cmake -S "$SOURCE_DIR" -B "$ROOT/$1" -DCMAKE_BUILD_TYPE=Release -DBSDL_OPTIMIZATION="$2" > "$ROOT/$1.log"
+    cmake --build "$ROOT/$1" -j "$JOBS" --target BlackScholesBench BlackScholesDL >> "$ROOT/$1.log"
+}
+
+measure() {
+    echo "Running $1 benchmarks"
+    (cd "$ROOT/$1" && ./BlackScholesBench --filter "$FILTER" --min_time "$MIN_TIME" --json "$ROOT/$1.json" > "$ROOT/$1.txt")
+}
+
+for profile in baseline lto native; do
+    echo "Building $profile"
+    configure "$profile" "$profile"
+    measure "$profile"
+done
+
+echo "Building pgo, instrumented"
+rm -rf "$ROOT/pgo"
+configure pgo pgo-generate
+cmake --build "$ROOT/pgo" --target pgo-train >> "$ROOT/pgo.log"
+if ls "$ROOT/pgo/pgo/"*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -o "$ROOT/pgo/pgo/default.profdata" "$ROOT/pgo/pgo/"*.profraw
+fi
+echo "Building pgo, optimized"
+configure pgo pgo-use
+measure pgo
+
+echo
+python3 "$SOURCE_DIR/tools/compare_profiles.py" "$ROOT/baseline.json" "$ROOT/lto.json" "$ROOT/native.json" "$ROOT/pgo.json" \
+    | tee "$ROOT/speedup.txt"